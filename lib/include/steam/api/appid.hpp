@@ -7,41 +7,41 @@
 #include <steam/helpers/fs.hpp>
 #include <steam/helpers/hash.hpp>
 
+#include <span>
 #include <string>
+#include <string_view>
 #include <vector>
 
 namespace steam::api {
 
+    struct ShortcutSpec {
+        std::string appName;
+        std::fs::path exePath;
+        std::string launchOptions;
+        std::vector<std::string> tags;
+        bool hidden = false;
+    };
+
     class AppId {
     public:
         AppId() : m_appId(-1) { }
 
-        AppId(const std::fs::path &exePath, const std::string &appName) noexcept
-            : m_appId((u64(crc32(exePath.string() + appName) | 0x8000'0000) << 32) | 0x0200'0000) { }
+        AppId(const std::fs::path &exePath, std::string_view appName) noexcept
+            : m_appId((u64(Crc32().update(exePath.native(), appName).finalize() | 0x8000'0000) << 32) | 0x0200'0000) { }
 
         explicit AppId(u64 appId) : m_appId(appId) { }
 
-        static std::vector<AppId> getAppIds(const api::User &user) {
-            auto configPath = fs::getSteamDirectory() / "userdata" / std::to_string(user.getId()) / "config";
-
-            // Open shortcuts file
-            auto shortcutsFile = fs::File(configPath / "shortcuts.vdf", fs::File::Mode::Write);
-            if (!shortcutsFile.isValid()) {
-                return { };
-            }
-
-            // Parse shortcuts
-            auto shortcuts = VDF(shortcutsFile.readBytes());
+        // Shortcuts only store the upper half of the appid
+        [[nodiscard]]
+        static AppId fromShortAppId(u32 shortAppId) noexcept {
+            return AppId((u64(shortAppId) << 32) | 0x0200'0000);
+        }
 
-            // Query all app IDs from the list
-            std::vector<AppId> appIds;
-            for (const auto &[key, value] : shortcuts["shortcuts"].set()) {
-                if (value.set().contains("appid"))
-                    appIds.emplace_back(value.set().at("appid").integer());
-            }
+        // Generates the appids of many shortcuts at once, spread across all cores for large batches
+        static std::vector<AppId> generate(std::span<const ShortcutSpec> shortcuts);
 
-            return appIds;
-        }
+        // Scans shortcuts.vdf in place without parsing it into a document
+        static std::vector<AppId> getAppIds(const api::User &user);
 
         [[nodiscard]]
         u64 getAppId() const noexcept {
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <steam.hpp>
+#include <steam/helpers/fs.hpp>
+
+#include <steam/api/appid.hpp>
+#include <steam/api/user.hpp>
+
+#include <map>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace steam::api {
+
+    enum class ArtworkType {
+        Grid,
+        Hero,
+        Logo,
+        Icon
+    };
+
+    // Artwork files are named after the upper half of a shortcut's appid and after the regular appid of Steam games
+    [[nodiscard]] inline u32 getArtworkId(const AppId &appId) {
+        return appId.getShortAppId() != 0 ? appId.getShortAppId() : u32(appId.getAppId());
+    }
+
+    struct ArtworkRequest {
+        AppId appId;
+        ArtworkType type;
+
+        // Either a http(s) URL or a file:// URL of an image that's already available locally
+        std::string url;
+    };
+
+    // Puts artwork into the grid folders of Steam users. Images are downloaded into a content-addressed cache and
+    // hardlinked from there, so every URL is only downloaded once and identical images are only stored once,
+    // no matter how many apps and users they are used for.
+    class ArtworkManager {
+    public:
+        ArtworkManager();
+        explicit ArtworkManager(std::fs::path cacheDirectory);
+
+        ArtworkManager(const ArtworkManager &) = delete;
+        ArtworkManager(ArtworkManager &&) = delete;
+
+        // Downloads everything that isn't cached yet concurrently. Returns the cached file of every request,
+        // std::nullopt for ones that couldn't be downloaded or aren't a PNG or JPEG image
+        std::vector<std::optional<std::fs::path>> fetch(std::span<const ArtworkRequest> requests);
+
+        // Fetches all artwork and links it into the grid folder of every user. Files that are already in place aren't touched
+        bool apply(std::span<const ArtworkRequest> requests, std::span<const User> users);
+
+        // Location Steam looks for the artwork of an app in, e.g. userdata/<user>/config/grid/<appid>_hero.png
+        [[nodiscard]] static std::fs::path getGridPath(const User &user, const AppId &appId, ArtworkType type, std::string_view extension = ".png");
+
+        [[nodiscard]] const std::fs::path &getCacheDirectory() const { return this->m_cacheDirectory; }
+
+    private:
+        void loadIndex();
+        bool saveIndex() const;
+
+        [[nodiscard]] std::optional<std::fs::path> findCached(const std::string &url) const;
+        [[nodiscard]] std::optional<std::fs::path> download(const std::string &url, const std::fs::path &temporaryPath) const;
+        [[nodiscard]] std::optional<std::fs::path> store(const std::fs::path &temporaryPath) const;
+
+    private:
+        std::fs::path m_cacheDirectory;
+        std::mutex m_mutex;
+
+        // Cache file name of every URL downloaded so far
+        std::map<std::string, std::string> m_urls;
+        bool m_indexLoaded = false;
+    };
+
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <steam.hpp>
+#include <steam/helpers/fs.hpp>
+#include <steam/helpers/watcher.hpp>
+
+#include <steam/api/appid.hpp>
+#include <steam/api/artwork.hpp>
+#include <steam/api/steam_grid_db.hpp>
+
+#include <map>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+namespace steam::api {
+
+    // Index of the artwork Steam already keeps on disk, in appcache/librarycache and in every user's config/grid folder.
+    // The directories are listed once and kept up to date through inotify afterwards, so lookups don't touch the disk.
+    class ArtworkResolver {
+    public:
+        ArtworkResolver();
+        explicit ArtworkResolver(std::fs::path steamDirectory);
+
+        ArtworkResolver(const ArtworkResolver &) = delete;
+        ArtworkResolver(ArtworkResolver &&) = delete;
+
+        // Lists all directories again from scratch
+        bool refresh();
+
+        // Picks up files that changed since the last call, only listing the directories they're in again
+        void update();
+
+        // Custom artwork from a grid folder takes priority over what Steam downloaded itself
+        [[nodiscard]] std::optional<std::fs::path> find(const AppId &appId, ArtworkType type);
+
+        // Requests for all artwork of all apps, pointing at local files where possible and at SteamGridDB otherwise.
+        // Steam games are looked up on SteamGridDB by their appid. SteamGridDB doesn't know about shortcuts, they're only
+        // looked up if gameIds maps their appid to a SteamGridDB game id, e.g one found through SteamGridDBAPI::search().
+        // Artwork SteamGridDB doesn't have either is left out
+        std::vector<ArtworkRequest> resolve(std::span<const AppId> appIds, std::span<const ArtworkType> types, SteamGridDBAPI &steamGridDB, const std::unordered_map<u64, AppId> &gameIds = { });
+
+    private:
+        enum class DirectoryKind {
+            LibraryCache,
+            LibraryCacheApp,
+            UserData,
+            UserConfig,
+            Grid
+        };
+
+        struct Artwork {
+            u32 id;
+            ArtworkType type;
+            std::fs::path path;
+        };
+
+        struct Directory {
+            DirectoryKind kind;
+            u32 appId;
+            std::vector<Artwork> artwork;
+        };
+
+        void addDirectory(const std::fs::path &path, DirectoryKind kind, u32 appId = 0);
+        void scanDirectory(const std::fs::path &path, Directory &directory);
+        bool rescan();
+        void processChanges();
+        void rebuildLookup();
+
+    private:
+        std::fs::path m_steamDirectory;
+        std::mutex m_mutex;
+
+        fs::Watcher m_watcher;
+        std::map<std::fs::path, Directory> m_directories;
+        std::unordered_map<u64, std::fs::path> m_lookup;
+    };
+
+}
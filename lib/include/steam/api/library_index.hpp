@@ -0,0 +1,70 @@
+#pragma once
+
+#include <steam.hpp>
+#include <steam/helpers/fs.hpp>
+
+#include <map>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace steam::api {
+
+    struct InstalledGame {
+        u32 appId = 0;
+        std::string name;
+        std::string installDir;
+        u64 sizeOnDisk = 0;
+        u32 stateFlags = 0;
+        std::fs::path library;
+
+        [[nodiscard]] bool isFullyInstalled() const {
+            constexpr static u32 FullyInstalled = 0x04;
+
+            return (this->stateFlags & FullyInstalled) != 0;
+        }
+
+        [[nodiscard]] std::fs::path getInstallPath() const {
+            return this->library / "steamapps" / "common" / this->installDir;
+        }
+    };
+
+    // Index of the games installed in all Steam library folders listed in libraryfolders.vdf, built from their
+    // appmanifest_*.acf files. The manifests are read and parsed in parallel, refreshing the index only parses
+    // manifests again that got added or changed since the last refresh.
+    class LibraryIndex {
+    public:
+        LibraryIndex();
+        explicit LibraryIndex(std::fs::path steamDirectory);
+
+        bool refresh();
+
+        [[nodiscard]] const InstalledGame* find(u32 appId) const;
+
+        [[nodiscard]] const std::unordered_map<u32, InstalledGame>& getGames() const {
+            return this->m_games;
+        }
+
+        [[nodiscard]] const std::vector<std::fs::path>& getLibraries() const {
+            return this->m_libraries;
+        }
+
+    private:
+        struct ManifestState {
+            u64 size = 0;
+            i64 modificationTime = 0;
+            std::optional<u32> appId;
+        };
+
+        [[nodiscard]] std::vector<std::fs::path> queryLibraries() const;
+
+    private:
+        std::fs::path m_steamDirectory;
+        std::vector<std::fs::path> m_libraries;
+
+        std::map<std::fs::path, ManifestState> m_manifests;
+        std::unordered_map<u32, InstalledGame> m_games;
+    };
+
+}
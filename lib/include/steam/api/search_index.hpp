@@ -0,0 +1,103 @@
+#pragma once
+
+#include <steam.hpp>
+
+#include <steam/api/appid.hpp>
+#include <steam/api/library_index.hpp>
+#include <steam/api/shortcuts_store.hpp>
+#include <steam/api/user.hpp>
+
+#include <steam/file_formats/vdf.hpp>
+
+#include <map>
+#include <optional>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+namespace steam::api {
+
+    struct SearchEntry {
+        enum class Source {
+            Shortcut,
+            InstalledGame
+        };
+
+        Source source;
+        AppId appId;
+
+        // Owner of the shortcut, 0 for installed games
+        u32 userId = 0;
+
+        std::string name;
+        std::vector<std::string> tags;
+
+        // Path of the executable of shortcuts, name of the install folder of installed games. Only the last path component is searched
+        std::string exe;
+    };
+
+    struct SearchResult {
+        SearchEntry entry;
+        float score;
+    };
+
+    // Fuzzy search over shortcuts and installed games, backed by an inverted index of the trigrams of every word.
+    // Matching entries are ranked by how many of the query's trigrams they contain, so typos and partially typed words
+    // still find what was meant. Entries can be added and removed individually without rebuilding anything.
+    class SearchIndex {
+    public:
+        SearchIndex() = default;
+        SearchIndex(const SearchIndex &) = delete;
+        SearchIndex(SearchIndex &&) = delete;
+
+        ~SearchIndex();
+
+        // Adds the entry, replacing a previous one of the same source, user and appid
+        void add(SearchEntry entry);
+        bool remove(SearchEntry::Source source, u32 userId, const AppId &appId);
+
+        // Replaces all shortcuts of the user with the ones in the shortcuts.vdf document
+        void addShortcuts(u32 userId, const VDF &shortcuts);
+
+        // Replaces all installed games with the ones in the library index
+        void addInstalledGames(const LibraryIndex &libraryIndex);
+
+        // Indexes the user's shortcuts and keeps them up to date with everything that gets changed through the store
+        bool watch(const User &user);
+
+        [[nodiscard]] std::vector<SearchResult> search(std::string_view query, size_t limit = 20) const;
+
+        [[nodiscard]] size_t size() const;
+
+    private:
+        using EntryKey = std::tuple<SearchEntry::Source, u32, u64>;
+
+        struct Document {
+            SearchEntry entry;
+            std::vector<u32> trigrams;
+        };
+
+        void insert(SearchEntry entry);
+        bool erase(const EntryKey &key);
+        void applyChanges(u32 userId, const std::vector<ShortcutsStore::Change> &changes);
+
+    private:
+        mutable std::shared_mutex m_mutex;
+
+        std::vector<std::optional<Document>> m_documents;
+        std::vector<u32> m_freeIds;
+        std::map<EntryKey, u32> m_keys;
+
+        // Name lengths kept next to each other, ranking would otherwise have to look at every matching document
+        std::vector<u16> m_nameLengths;
+
+        // Sorted ids of all documents containing the trigram, shifted left to make room for flags telling where it was found
+        std::unordered_map<u32, std::vector<u32>> m_postings;
+
+        std::vector<std::pair<ShortcutsStore*, u32>> m_subscriptions;
+    };
+
+}
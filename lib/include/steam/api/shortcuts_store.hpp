@@ -0,0 +1,131 @@
+#pragma once
+
+#include <steam.hpp>
+#include <steam/helpers/fs.hpp>
+
+#include <steam/api/appid.hpp>
+#include <steam/api/user.hpp>
+
+#include <steam/file_formats/vdf.hpp>
+
+#include <functional>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace steam::api {
+
+    // Cached view of a user's shortcuts.vdf. The file is parsed once and kept in memory together with an index
+    // from appid to shortcut, it's only parsed again once its size or modification time changed on disk.
+    // Edits are kept in memory until flush() is called, which only writes the file if anything actually changed.
+    class ShortcutsStore {
+    public:
+        struct Change {
+            enum class Kind {
+                Added,
+                Removed,
+                Modified
+            };
+
+            Kind kind;
+            AppId appId;
+
+            // The shortcut's new contents, empty for removed ones
+            std::optional<VDF::Value> shortcut;
+        };
+
+        using Callback = std::function<void(const std::vector<Change> &changes)>;
+
+        explicit ShortcutsStore(const User &user);
+        explicit ShortcutsStore(std::fs::path path);
+
+        ShortcutsStore(const ShortcutsStore &) = delete;
+        ShortcutsStore(ShortcutsStore &&) = delete;
+
+        // Store shared by all callers in the process
+        static ShortcutsStore& get(const User &user);
+
+        // Builds the shortcuts.vdf entry Steam expects for a non-Steam game
+        [[nodiscard]] static VDF::Set createShortcut(const AppId &appId, const std::string &appName, const std::fs::path &exePath, const std::string &launchOptions, const std::vector<std::string> &tags, bool hidden);
+
+        // Edits on a shortcuts document itself, shared with Transaction. Removal finds the shortcut through the document's appid index
+        [[nodiscard]] static const VDF::Index* addAppIdIndex(VDF &document);
+        static std::optional<AppId> addShortcut(VDF &document, const std::string &appName, const std::fs::path &exePath, const std::string &launchOptions, const std::vector<std::string> &tags, bool hidden);
+        static bool removeShortcut(VDF &document, const VDF::Index &index, const AppId &appId);
+
+        // Returns std::nullopt if the game already has a shortcut
+        std::optional<AppId> addGameShortcut(const std::string &appName, const std::fs::path &exePath, const std::string &launchOptions = "", const std::vector<std::string> &tags = { }, bool hidden = false);
+        bool removeGameShortcut(const AppId &appId);
+
+        // Adds all games in one go. Games that already have a shortcut are skipped and reported as std::nullopt
+        std::vector<std::optional<AppId>> addGameShortcuts(std::span<const ShortcutSpec> games);
+
+        // Removes every shortcut the predicate matches and renumbers the remaining ones once. Returns the removed appids
+        std::vector<AppId> removeGameShortcutsIf(const std::function<bool(const VDF::Value &shortcut)> &predicate);
+
+        [[nodiscard]] bool contains(const AppId &appId);
+        [[nodiscard]] std::optional<VDF::Value> getShortcut(const AppId &appId);
+        [[nodiscard]] std::vector<AppId> getAppIds();
+
+        // Writes back pending edits. Fails without touching the file if it got modified by someone else in the meantime
+        bool flush();
+
+        // Drops pending edits and loads the current version of the file
+        bool reload();
+
+        // Runs the callback with the file locked against other writers and flushes its edits right away.
+        // Edits that can't be written are dropped again
+        bool update(const std::function<bool(ShortcutsStore &store)> &callback);
+
+        // Subscribers get told about every shortcut that changed on disk, whether through this store or through someone else.
+        // Callbacks run with the store locked and must not call back into it
+        u32 subscribe(Callback callback);
+        bool unsubscribe(u32 id);
+
+        [[nodiscard]] bool isDirty() const {
+            std::scoped_lock lock(this->m_mutex);
+
+            return this->m_dirty;
+        }
+
+        [[nodiscard]] const std::fs::path &getPath() const { return this->m_path; }
+
+    private:
+        struct FileIdentity {
+            u64 device = 0, inode = 0, size = 0;
+            i64 modificationTime = 0;
+            bool exists = false;
+
+            bool operator==(const FileIdentity &other) const = default;
+        };
+
+        [[nodiscard]] std::optional<FileIdentity> queryIdentity() const;
+
+        // Makes sure the cached document matches the file, reparsing it only if it changed
+        bool revalidate();
+        bool load(const FileIdentity &identity);
+        bool write();
+        void notify(const std::optional<VDF> &previous, const VDF &current);
+
+        [[nodiscard]] const VDF::Index::Entry* find(const AppId &appId) const;
+        [[nodiscard]] static std::optional<u32> getNextShortcutId(VDF &document);
+
+    private:
+        std::fs::path m_path;
+        mutable std::recursive_mutex m_mutex;
+
+        std::optional<VDF> m_document, m_original;
+        const VDF::Index *m_index = nullptr;
+        FileIdentity m_identity;
+        u32 m_checksum = 0;
+        bool m_dirty = false;
+
+        std::mutex m_subscriberMutex;
+        std::map<u32, Callback> m_subscribers;
+        u32 m_nextSubscriberId = 0;
+    };
+
+}
@@ -5,15 +5,32 @@
 
 #include <steam/api/appid.hpp>
 #include <steam/api/user.hpp>
+#include <steam/api/transaction.hpp>
+#include <steam/api/shortcuts_store.hpp>
 
+#include <functional>
 #include <optional>
+#include <span>
 #include <string>
+#include <unordered_map>
 
 namespace steam::api {
 
     std::optional<AppId> addGameShortcut(const User &user, const std::string &appName, const std::fs::path &exePath, const std::string &launchOptions = "", const std::vector<std::string> &tags = { }, bool hidden = false);
     bool removeGameShortcut(const User &user, const AppId &appId);
+
+    // Batched versions of the above that parse and write shortcuts.vdf only once for all games
+    std::vector<std::optional<AppId>> addGameShortcuts(const User &user, std::span<const ShortcutSpec> games);
+    std::vector<AppId> removeGameShortcutsIf(const User &user, const std::function<bool(const VDF::Value &shortcut)> &predicate);
     bool enableProtonForApp(AppId appId, bool enabled);
 
-    bool restartSteam();
+    // Updates the compatibility tools of many apps with a single parse and write of config.vdf
+    bool setCompatTools(std::span<const CompatToolUpdate> updates);
+
+    // Current compatibility tool mappings, keyed by the appid as stored in config.vdf
+    std::unordered_map<u32, CompatTool> getCompatTools();
+
+    // Shuts the Steam client down and runs the callback once it exited. Getting Steam started again is left to
+    // whatever launched it, like the Steam Deck's session manager
+    bool restartSteam(const std::function<bool()> &whileStopped = { });
 }
\ No newline at end of file
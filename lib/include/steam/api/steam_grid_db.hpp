@@ -9,6 +9,7 @@ namespace steam::api {
     class SteamGridDBAPI {
     public:
         SteamGridDBAPI(const std::string &apiKey) : m_apiKey(apiKey) { }
+        virtual ~SteamGridDBAPI() = default;
 
         const static inline std::string BaseUrl = "https://www.steamgriddb.com/api/v2";
 
@@ -27,12 +28,18 @@ namespace steam::api {
             std::string thumb;
         };
 
+        // SteamGridDB identifies games by its own ids, the ones search() returns. Steam games can be looked up by their appid as well
+        enum class IdType {
+            SteamGridDB,
+            Steam
+        };
+
         std::future<std::vector<SearchEntry>> search(const std::string &keyword);
 
-        std::future<std::vector<ImageResult>> getGrids(const AppId &appId);
-        std::future<std::vector<ImageResult>> getHeroes(const AppId &appId);
-        std::future<std::vector<ImageResult>> getLogos(const AppId &appId);
-        std::future<std::vector<ImageResult>> getIcons(const AppId &appId);
+        virtual std::future<std::vector<ImageResult>> getGrids(const AppId &appId, IdType idType = IdType::SteamGridDB);
+        virtual std::future<std::vector<ImageResult>> getHeroes(const AppId &appId, IdType idType = IdType::SteamGridDB);
+        virtual std::future<std::vector<ImageResult>> getLogos(const AppId &appId, IdType idType = IdType::SteamGridDB);
+        virtual std::future<std::vector<ImageResult>> getIcons(const AppId &appId, IdType idType = IdType::SteamGridDB);
 
     private:
         std::string m_apiKey;
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <steam.hpp>
+
+#include <chrono>
+#include <optional>
+
+#include <sys/types.h>
+
+namespace steam::api {
+
+    using namespace std::chrono_literals;
+
+    // Handle to a running Steam client process. The process is held through a pidfd so the handle keeps referring to
+    // the same process even after it exited and its pid got reused, and waiting for it doesn't require polling /proc.
+    // Works for any Steam process of the current user, not just ones our process got started by.
+    class SteamProcess {
+    public:
+        SteamProcess() noexcept;
+        SteamProcess(const SteamProcess &) = delete;
+        SteamProcess(SteamProcess &&other) noexcept;
+
+        ~SteamProcess();
+
+        SteamProcess &operator=(SteamProcess &&other) noexcept;
+
+        // Locates the Steam client through ~/.steam/steam.pid, falling back to a single scan of /proc
+        [[nodiscard]] static std::optional<SteamProcess> find();
+
+        // Waits up to timeout for a Steam client to be running. Only polls for a short while after the pid file got written,
+        // until the new process took on its name
+        [[nodiscard]] static std::optional<SteamProcess> waitForStart(std::chrono::milliseconds timeout);
+
+        [[nodiscard]] bool isValid() const {
+            return this->m_fd >= 0;
+        }
+
+        [[nodiscard]] pid_t getPid() const { return this->m_pid; }
+        [[nodiscard]] bool isRunning() const;
+
+        // Returns true if the process exited within the timeout
+        bool waitForExit(std::chrono::milliseconds timeout) const;
+
+        // Waits for this process to exit and a new Steam client to come up in its place, both within the timeout
+        [[nodiscard]] std::optional<SteamProcess> waitForRestart(std::chrono::milliseconds timeout) const;
+
+        // Asks Steam to quit through SIGTERM and kills it if it's still running after the grace period.
+        // Returns true once the process is gone
+        bool shutdown(std::chrono::milliseconds gracePeriod = 10s, std::chrono::milliseconds killTimeout = 5s) const;
+        bool kill(std::chrono::milliseconds timeout = 5s) const;
+
+    private:
+        SteamProcess(int fd, pid_t pid) noexcept;
+
+        [[nodiscard]] static std::optional<SteamProcess> open(pid_t pid);
+        bool sendSignal(int signal) const;
+        void close();
+
+    private:
+        int m_fd;
+        pid_t m_pid;
+    };
+
+}
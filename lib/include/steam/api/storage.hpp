@@ -0,0 +1,34 @@
+#pragma once
+
+#include <steam.hpp>
+#include <steam/helpers/fs.hpp>
+#include <steam/helpers/disk_usage.hpp>
+
+#include <steam/api/library_index.hpp>
+
+#include <unordered_map>
+#include <vector>
+
+namespace steam::api {
+
+    struct AppStorage {
+        fs::DiskUsage install, compatData, shaderCache;
+
+        [[nodiscard]] u64 getAllocatedSize() const {
+            return this->install.allocatedSize + this->compatData.allocatedSize + this->shaderCache.allocatedSize;
+        }
+    };
+
+    struct StorageReport {
+        // Keyed by appid, non-Steam games by their short appid
+        std::unordered_map<u32, AppStorage> apps;
+
+        // Proton prefixes of non-Steam games that aren't in any user's shortcuts anymore
+        std::vector<std::fs::path> orphanedPrefixes;
+    };
+
+    // Measures the game installs, Proton prefixes and shader caches in all library folders of the index
+    StorageReport scanStorage(const LibraryIndex &libraryIndex);
+    StorageReport scanStorage();
+
+}
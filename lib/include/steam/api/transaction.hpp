@@ -0,0 +1,90 @@
+#pragma once
+
+#include <steam.hpp>
+#include <steam/helpers/fs.hpp>
+#include <steam/helpers/file_lock.hpp>
+
+#include <steam/api/appid.hpp>
+#include <steam/api/user.hpp>
+
+#include <steam/file_formats/vdf.hpp>
+#include <steam/file_formats/keyvalues.hpp>
+
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace steam::api {
+
+    // Compatibility tool Steam runs an app with, as stored in config.vdf's CompatToolMapping
+    struct CompatTool {
+        std::string name;
+        std::string config;
+        u32 priority = 250;
+    };
+
+    struct CompatToolUpdate {
+        AppId appId;
+        CompatTool tool = { .name = "proton_experimental" };
+        bool enabled = true;
+    };
+
+    // Batches edits to a user's shortcuts.vdf and the global config.vdf. Both files are locked against other writers
+    // for the lifetime of the transaction, parsed at most once and written back with a single atomic write per file
+    // on commit, no matter how many edits were made. Edits that aren't committed are discarded.
+    // Every commit is recorded in the files' Journal so earlier versions can be restored later on.
+    //
+    // The locks aren't reentrant. Anything else taking them while a transaction is alive, like ShortcutsStore::update() or
+    // api::enableProtonForApp(), blocks until the transaction is destroyed. Doing so on the same thread deadlocks,
+    // edits made while holding a transaction have to go through the transaction itself.
+    class Transaction {
+    public:
+        // Transaction only covering config.vdf
+        Transaction();
+        explicit Transaction(const User &user);
+
+        Transaction(const Transaction &) = delete;
+        Transaction(Transaction &&) noexcept = default;
+
+        Transaction& operator=(Transaction &&) noexcept = default;
+
+        std::optional<AppId> addGameShortcut(const std::string &appName, const std::fs::path &exePath, const std::string &launchOptions = "", const std::vector<std::string> &tags = { }, bool hidden = false);
+        bool removeGameShortcut(const AppId &appId);
+        bool enableProtonForApp(AppId appId, bool enabled);
+
+        // Applies all mappings at once, disabled entries remove the app's mapping
+        bool setCompatTools(std::span<const CompatToolUpdate> updates);
+
+        // Direct access to the documents for edits not covered above. Returns nullptr if the file couldn't be loaded
+        [[nodiscard]] VDF* getShortcuts();
+        [[nodiscard]] KeyValues* getConfig();
+
+        // Writes back every modified file. The transaction stays usable for further edits afterwards
+        bool commit();
+
+        // Drops all uncommitted edits, the files are parsed again on next access
+        void rollback();
+
+    private:
+        template<typename Document>
+        struct LockedDocument {
+            std::fs::path path;
+            fs::FileLock lock;
+            std::optional<Document> document, original;
+            u32 checksum = 0;
+            bool failed = false, modified = false;
+        };
+
+        template<typename Document>
+        static Document* load(LockedDocument<Document> &document);
+
+        template<typename Document>
+        static bool write(LockedDocument<Document> &document, auto data);
+
+    private:
+        std::optional<LockedDocument<VDF>> m_shortcuts;
+        LockedDocument<KeyValues> m_config;
+    };
+
+}
@@ -3,38 +3,24 @@
 #include <steam.hpp>
 
 #include <steam/helpers/fs.hpp>
-#include <steam/helpers/file.hpp>
-#include <steam/file_formats/keyvalues.hpp>
 
 #include <string>
+#include <unordered_map>
+#include <vector>
 
 namespace steam::api {
 
     class User {
     public:
         explicit User(u32 userId) : m_userId(userId), m_userName(queryUserName(userId)) { }
+        User(u32 userId, std::string userName) : m_userId(userId), m_userName(std::move(userName)) { }
 
-        static const std::vector<User>& getUsers() {
-            static auto users = []{
-                std::vector<User> users;
+        // All users with a userdata folder and a known name. Names are taken from loginusers.vdf, only users missing
+        // there get their localconfig.vdf parsed. The list is cached until loginusers.vdf or the userdata folder change
+        static std::vector<User> getUsers();
 
-                for (const auto &folder : std::fs::directory_iterator(fs::getSteamDirectory() / "userdata")) {
-                    u32 userId = std::stoi(folder.path().filename());
-                    if (userId == 0)
-                        continue;
-
-                    users.emplace_back(userId);
-                }
-
-                std::erase_if(users, [](const User &user){
-                    return user.getName().empty();
-                });
-
-                return users;
-            }();
-
-            return users;
-        }
+        // Drops the cached user list so the next getUsers() call scans again
+        static void refreshUsers();
 
         [[nodiscard]]
         u32 getId() const noexcept {
@@ -47,28 +33,13 @@ namespace steam::api {
         }
 
     public:
-        static std::string queryUserName(u32 userId) {
-            auto localConfigFile = fs::File(fs::getSteamDirectory() / "userdata" / std::to_string(userId) / "config" / "localconfig.vdf", fs::File::Mode::Read);
-            if (!localConfigFile.isValid())
-                return { };
+        static std::string queryUserName(u32 userId);
 
-            auto localConfig = steam::KeyValues(localConfigFile.readString());
-            if (!localConfig.contains("UserLocalConfigStore")) return { };
-
-            auto userLocalConfigStore = localConfig["UserLocalConfigStore"];
-            if (!userLocalConfigStore.contains("friends")) return { };
-
-            auto friends = userLocalConfigStore["friends"];
-            if (!friends.contains(std::to_string(userId))) return { };
-
-            auto user = friends[std::to_string(userId)];
-            if (!user.contains("name")) return { };
-
-            return user["name"].string();
-        }
+        // Persona names of all accounts that logged in on this machine, keyed by their account id
+        static std::unordered_map<u32, std::string> queryLoginUsers();
 
         u32 m_userId;
         std::string m_userName;
     };
 
-}
\ No newline at end of file
+}
@@ -0,0 +1,264 @@
+#pragma once
+
+#include <steam.hpp>
+#include <steam/helpers/small_string.hpp>
+
+#include <memory>
+#include <string_view>
+#include <variant>
+
+namespace steam {
+
+    struct MemoryUsage {
+        size_t keys = 0;
+        size_t strings = 0;
+        size_t structure = 0;
+
+        [[nodiscard]]
+        size_t total() const {
+            return this->keys + this->strings + this->structure;
+        }
+
+        MemoryUsage& operator+=(const MemoryUsage &other) {
+            this->keys      += other.keys;
+            this->strings   += other.strings;
+            this->structure += other.structure;
+
+            return *this;
+        }
+    };
+
+    namespace impl {
+
+        // Bookkeeping of a std::map node besides its key and value: color, parent, left and right
+        constexpr static size_t MapNodeOverhead = 4 * sizeof(void*);
+
+        template<typename Set>
+        MemoryUsage measureSet(const Set &set) {
+            MemoryUsage usage;
+
+            usage.structure += sizeof(Set);
+            for (const auto &[key, value] : set) {
+                usage.keys      += sizeof(key) + key.getHeapSize();
+                usage.structure += MapNodeOverhead + sizeof(value);
+                usage           += value.memoryUsage();
+            }
+
+            return usage;
+        }
+
+        // 16 byte storage for a string, an integer or a set of child nodes.
+        // Strings are stored in an embedded SmallString, the type tag is packed into its last byte.
+        // Sets are heap allocated on first mutable access so that freshly created nodes don't allocate anything.
+        template<typename SetType>
+        class CompactValue {
+        public:
+            enum class Type : u8 {
+                Set,
+                String,
+                Integer
+            };
+
+            CompactValue() noexcept {
+                this->m_set = nullptr;
+                this->setTag(SetTag);
+            }
+
+            CompactValue(const CompactValue &other) : CompactValue() {
+                *this = other;
+            }
+
+            CompactValue(CompactValue &&other) noexcept : CompactValue() {
+                *this = std::move(other);
+            }
+
+            ~CompactValue() {
+                this->reset();
+            }
+
+            CompactValue& operator=(const CompactValue &other) {
+                if (this == &other)
+                    return *this;
+
+                switch (other.getType()) {
+                    case Type::Set:
+                        this->setSet(other.getSet());
+                        break;
+                    case Type::String:
+                        this->setString(other.getString());
+                        break;
+                    case Type::Integer:
+                        this->setInteger(other.getInteger());
+                        break;
+                }
+
+                return *this;
+            }
+
+            CompactValue& operator=(CompactValue &&other) noexcept {
+                if (this == &other)
+                    return *this;
+
+                this->reset();
+
+                // Every alternative is trivially relocatable, so the raw storage can just be taken over
+                std::memcpy(static_cast<void*>(this), static_cast<const void*>(&other), sizeof(CompactValue));
+                other.m_set = nullptr;
+                other.setTag(SetTag);
+
+                return *this;
+            }
+
+            [[nodiscard]]
+            Type getType() const noexcept {
+                switch (this->getTag()) {
+                    case SetTag:     return Type::Set;
+                    case IntegerTag: return Type::Integer;
+                    default:         return Type::String;
+                }
+            }
+
+            [[nodiscard]]
+            std::string_view getString() const {
+                if (this->getType() != Type::String)
+                    throw std::bad_variant_access();
+
+                return this->m_string.view();
+            }
+
+            [[nodiscard]]
+            u32& getInteger() {
+                if (this->getType() != Type::Integer)
+                    throw std::bad_variant_access();
+
+                return this->m_integer;
+            }
+
+            [[nodiscard]]
+            const u32& getInteger() const {
+                if (this->getType() != Type::Integer)
+                    throw std::bad_variant_access();
+
+                return this->m_integer;
+            }
+
+            [[nodiscard]]
+            SetType& getSet() {
+                if (this->getType() != Type::Set)
+                    throw std::bad_variant_access();
+
+                if (this->m_set == nullptr)
+                    this->m_set = new SetType();
+
+                return *this->m_set;
+            }
+
+            [[nodiscard]]
+            const SetType& getSet() const {
+                if (this->getType() != Type::Set)
+                    throw std::bad_variant_access();
+
+                if (this->m_set == nullptr)
+                    return EmptySet;
+
+                return *this->m_set;
+            }
+
+            void setString(std::string_view string) {
+                // The string may point into this value's own storage
+                SmallString newString(string);
+
+                this->reset();
+                std::construct_at(&this->m_string, std::move(newString));
+            }
+
+            void setInteger(u32 integer) {
+                this->reset();
+
+                this->m_integer = integer;
+                this->setTag(IntegerTag);
+            }
+
+            void setSet(const SetType &set) {
+                this->setSet(SetType(set));
+            }
+
+            void setSet(SetType &&set) {
+                auto newSet = new SetType(std::move(set));
+
+                this->reset();
+                this->m_set = newSet;
+                this->setTag(SetTag);
+            }
+
+            [[nodiscard]]
+            MemoryUsage memoryUsage() const {
+                switch (this->getType()) {
+                    case Type::String:
+                        return { .strings = this->m_string.getHeapSize() };
+                    case Type::Set:
+                        if (this->m_set == nullptr)
+                            return { };
+                        return measureSet(*this->m_set);
+                    default:
+                        return { };
+                }
+            }
+
+            bool operator==(const CompactValue &other) const {
+                if (this->getType() != other.getType())
+                    return false;
+
+                switch (this->getType()) {
+                    case Type::Set:     return this->getSet() == other.getSet();
+                    case Type::String:  return this->getString() == other.getString();
+                    case Type::Integer: return this->getInteger() == other.getInteger();
+                }
+
+                return false;
+            }
+
+        private:
+            constexpr static u8 IntegerTag = SmallString::ReservedTagStart;
+            constexpr static u8 SetTag     = SmallString::ReservedTagStart + 1;
+
+            constexpr static size_t TagOffset = sizeof(SmallString) - 1;
+
+            static inline const SetType EmptySet;
+
+            [[nodiscard]]
+            u8 getTag() const noexcept {
+                return reinterpret_cast<const u8*>(this)[TagOffset];
+            }
+
+            void setTag(u8 tag) noexcept {
+                reinterpret_cast<u8*>(this)[TagOffset] = tag;
+            }
+
+            void reset() noexcept {
+                switch (this->getType()) {
+                    case Type::Set:
+                        delete this->m_set;
+                        break;
+                    case Type::String:
+                        std::destroy_at(&this->m_string);
+                        break;
+                    default:
+                        break;
+                }
+
+                this->m_set = nullptr;
+                this->setTag(SetTag);
+            }
+
+        private:
+            union {
+                SmallString m_string;
+                u32 m_integer;
+                SetType *m_set;
+            };
+        };
+
+    }
+
+}
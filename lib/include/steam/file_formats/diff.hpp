@@ -0,0 +1,97 @@
+#pragma once
+
+#include <steam.hpp>
+
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace steam {
+
+    // A single structural difference between two versions of a document. Added and removed nodes carry their whole
+    // subtree, nodes whose value changed carry both the old and the new value. Sets present in both versions are
+    // never reported themselves, only the differences inside of them are.
+    template<typename Value>
+    struct DocumentChange {
+        enum class Kind {
+            Added,
+            Removed,
+            Modified
+        };
+
+        Kind kind;
+        std::vector<std::string> path;
+        std::optional<Value> oldValue, newValue;
+
+        [[nodiscard]]
+        std::string getPath() const {
+            std::string result;
+            for (const auto &segment : this->path) {
+                if (!result.empty())
+                    result += '/';
+                result += segment;
+            }
+
+            return result;
+        }
+    };
+
+    namespace impl {
+
+        template<typename Set, typename Change>
+        void diffSets(const Set &oldSet, const Set &newSet, std::vector<std::string> &path, std::vector<Change> &changes) {
+            using Value = typename Set::mapped_type;
+
+            auto report = [&](typename Change::Kind kind, std::string_view key, const Value *oldValue, const Value *newValue) {
+                auto &change = changes.emplace_back(Change { kind, path });
+                change.path.emplace_back(key);
+
+                if (oldValue != nullptr)
+                    change.oldValue = *oldValue;
+                if (newValue != nullptr)
+                    change.newValue = *newValue;
+            };
+
+            // Both sets are ordered by key, so a single merge pass finds all differences
+            auto oldIt = oldSet.begin(), newIt = newSet.begin();
+            while (oldIt != oldSet.end() || newIt != newSet.end()) {
+                if (newIt == newSet.end() || (oldIt != oldSet.end() && oldIt->first < newIt->first)) {
+                    report(Change::Kind::Removed, oldIt->first, &oldIt->second, nullptr);
+                    ++oldIt;
+                } else if (oldIt == oldSet.end() || newIt->first < oldIt->first) {
+                    report(Change::Kind::Added, newIt->first, nullptr, &newIt->second);
+                    ++newIt;
+                } else {
+                    const auto &oldValue = oldIt->second;
+                    const auto &newValue = newIt->second;
+
+                    if (oldValue.isSet() && newValue.isSet()) {
+                        path.emplace_back(oldIt->first);
+                        diffSets(oldValue.set(), newValue.set(), path, changes);
+                        path.pop_back();
+                    } else if (!(oldValue == newValue)) {
+                        report(Change::Kind::Modified, oldIt->first, &oldValue, &newValue);
+                    }
+
+                    ++oldIt;
+                    ++newIt;
+                }
+            }
+        }
+
+    }
+
+    // Lists everything that changed between two versions of a VDF or KeyValues document, ordered by path
+    template<typename Set>
+    [[nodiscard]]
+    std::vector<DocumentChange<typename Set::mapped_type>> diffDocuments(const Set &oldSet, const Set &newSet) {
+        std::vector<DocumentChange<typename Set::mapped_type>> changes;
+        std::vector<std::string> path;
+
+        impl::diffSets(oldSet, newSet, path, changes);
+
+        return changes;
+    }
+
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <steam.hpp>
+#include <steam/helpers/fs.hpp>
+#include <steam/helpers/watcher.hpp>
+#include <steam/file_formats/diff.hpp>
+#include <steam/file_formats/vdf.hpp>
+#include <steam/file_formats/keyvalues.hpp>
+
+#include <chrono>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace steam {
+
+    // Keeps a VDF or KeyValues document in sync with its file on disk. Changes are picked up through inotify,
+    // bursts of writes are coalesced and the file is only parsed again if it actually got replaced or modified.
+    // Subscribers receive the reloaded document together with the structural changes compared to the previous version.
+    template<typename Document>
+    class DocumentWatcher {
+    public:
+        using Change   = DocumentChange<typename Document::Value>;
+        using Callback = std::function<void(const Document &document, const std::vector<Change> &changes)>;
+
+        explicit DocumentWatcher(const std::fs::path &path, std::chrono::milliseconds debounce = std::chrono::milliseconds(100));
+        DocumentWatcher(const DocumentWatcher &) = delete;
+        DocumentWatcher(DocumentWatcher &&) = delete;
+
+        ~DocumentWatcher();
+
+        [[nodiscard]] bool isValid() const {
+            return this->m_watcher.isValid();
+        }
+
+        u32 subscribe(Callback callback);
+        bool unsubscribe(u32 id);
+
+        [[nodiscard]] Document getDocument() const;
+
+        // Waits up to timeout for changes and handles them on the calling thread. Returns true if the document got reloaded
+        bool process(std::chrono::milliseconds timeout);
+
+        // Handles changes on a background thread until stop() is called or the watcher gets destroyed
+        void start();
+        void stop();
+
+        auto getHandle() const { return this->m_watcher.getHandle(); }
+
+    private:
+        struct FileIdentity {
+            u64 device = 0, inode = 0, size = 0;
+            i64 modificationTime = 0;
+
+            bool operator==(const FileIdentity &other) const = default;
+        };
+
+        bool reload();
+
+    private:
+        std::fs::path m_path;
+        std::chrono::milliseconds m_debounce;
+        fs::Watcher m_watcher;
+
+        mutable std::mutex m_documentMutex;
+        Document m_document;
+        FileIdentity m_identity;
+
+        std::mutex m_subscriberMutex;
+        std::map<u32, Callback> m_subscribers;
+        u32 m_nextSubscriberId = 0;
+
+        std::jthread m_thread;
+    };
+
+}
@@ -0,0 +1,424 @@
+#pragma once
+
+#include <steam.hpp>
+
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace steam {
+
+    template<typename Value>
+    class DocumentIndex;
+
+    namespace impl {
+
+        template<typename Value>
+        struct IndexBinding {
+            DocumentIndex<Value> *index;
+            u32 depth;
+            Value *element;
+        };
+
+        template<typename Value>
+        class IndexBindings {
+        public:
+            IndexBindings() = default;
+
+            // Bindings describe the position of a node inside of a document, so copies always start out untracked
+            IndexBindings(const IndexBindings &) noexcept { }
+            IndexBindings(IndexBindings &&) noexcept { }
+            IndexBindings& operator=(const IndexBindings &) noexcept { return *this; }
+            IndexBindings& operator=(IndexBindings &&) noexcept { return *this; }
+
+            [[nodiscard]]
+            bool empty() const {
+                return this->m_bindings == nullptr || this->m_bindings->empty();
+            }
+
+            [[nodiscard]]
+            bool contains(const DocumentIndex<Value> *index) const {
+                if (this->m_bindings == nullptr)
+                    return false;
+
+                for (const auto &binding : *this->m_bindings) {
+                    if (binding.index == index)
+                        return true;
+                }
+
+                return false;
+            }
+
+            // Binding a node again moves it to its new position instead of keeping the old one around
+            void add(const IndexBinding<Value> &binding) {
+                if (this->m_bindings == nullptr)
+                    this->m_bindings = std::make_unique<std::vector<IndexBinding<Value>>>();
+
+                for (auto &existing : *this->m_bindings) {
+                    if (existing.index == binding.index) {
+                        existing = binding;
+                        return;
+                    }
+                }
+
+                this->m_bindings->push_back(binding);
+            }
+
+            void remove(const DocumentIndex<Value> *index) {
+                if (this->m_bindings == nullptr)
+                    return;
+
+                std::erase_if(*this->m_bindings, [index](const auto &binding) { return binding.index == index; });
+            }
+
+            void clear() noexcept {
+                this->m_bindings.reset();
+            }
+
+            // The bindings of a subtree that got moved somewhere else still describe its old position. They're dropped
+            // here and the destination attaches the subtree again. Only bound nodes can have bound children
+            static void detachChildren(Value &node) noexcept {
+                if (!node.isSet() || std::as_const(node).set().empty())
+                    return;
+
+                for (auto &[key, child] : node.set()) {
+                    if (child.m_indexBindings.empty())
+                        continue;
+
+                    child.m_indexBindings.clear();
+                    detachChildren(child);
+                }
+            }
+
+            [[nodiscard]]
+            std::vector<IndexBinding<Value>> get() const {
+                if (this->m_bindings == nullptr)
+                    return { };
+
+                return *this->m_bindings;
+            }
+
+            // Only the child's bindings change while it gets attached, so the node's own ones can be used without a copy
+            void accessed(std::string_view key, Value &child) const {
+                if (this->empty())
+                    return;
+
+                for (const auto &binding : *this->m_bindings)
+                    binding.index->accessed(binding, key, child);
+            }
+
+            // Reattaching the node replaces its own bindings, so they're copied first
+            void assigned(Value &node) const {
+                if (this->empty())
+                    return;
+
+                for (const auto &binding : this->get())
+                    binding.index->assigned(binding, node);
+            }
+
+            template<typename Set>
+            static void erase(Set &set, typename Set::iterator it) {
+                auto bindings = it->second.m_indexBindings.get();
+
+                for (const auto &binding : bindings)
+                    binding.index->erasing(binding, it->second);
+
+                set.erase(it);
+
+                for (const auto &binding : bindings)
+                    binding.index->erased(binding);
+            }
+
+        private:
+            std::unique_ptr<std::vector<IndexBinding<Value>>> m_bindings;
+        };
+
+    }
+
+    // Secondary index over all nodes matching a path pattern such as "shortcuts/*/appid".
+    // The pattern contains exactly one wildcard segment. The nodes matched by it are the indexed elements,
+    // the remaining segments lead from an element to the leaf value it is looked up by.
+    //
+    // Indexes are kept up to date as the document is modified through operator[], assignment and erase().
+    // Modifications done directly on the underlying Set bypass them and require a reindex() of the document.
+    template<typename Value>
+    class DocumentIndex {
+    public:
+        using Set = std::remove_cvref_t<decltype(std::declval<Value&>().set())>;
+        using Key = typename Value::IndexKey;
+
+        struct Entry {
+            std::string key;
+            Value *element;
+        };
+
+        DocumentIndex(Set &root, std::vector<std::string> segments, u32 wildcard)
+            : m_root(&root), m_segments(std::move(segments)), m_wildcard(wildcard) {
+            this->rebuild();
+        }
+
+        DocumentIndex(const DocumentIndex &) = delete;
+        DocumentIndex& operator=(const DocumentIndex &) = delete;
+
+        [[nodiscard]]
+        static std::optional<std::pair<std::vector<std::string>, u32>> parsePattern(std::string_view pattern) {
+            std::vector<std::string> segments;
+            std::optional<u32> wildcard;
+
+            while (true) {
+                auto separator = pattern.find('/');
+                auto segment   = pattern.substr(0, separator);
+
+                if (segment.empty())
+                    return std::nullopt;
+
+                if (segment == "*") {
+                    if (wildcard.has_value())
+                        return std::nullopt;
+
+                    wildcard = segments.size();
+                }
+
+                segments.emplace_back(segment);
+
+                if (separator == std::string_view::npos)
+                    break;
+
+                pattern.remove_prefix(separator + 1);
+            }
+
+            if (!wildcard.has_value())
+                return std::nullopt;
+
+            return std::pair { std::move(segments), *wildcard };
+        }
+
+        [[nodiscard]]
+        std::string getPattern() const {
+            std::string result;
+
+            for (const auto &segment : this->m_segments) {
+                if (!result.empty())
+                    result += '/';
+                result += segment;
+            }
+
+            return result;
+        }
+
+        [[nodiscard]]
+        const Entry* find(const Key &key) const {
+            auto it = this->m_lookup.find(key);
+            if (it == this->m_lookup.end())
+                return nullptr;
+
+            return &it->second;
+        }
+
+        [[nodiscard]]
+        std::vector<const Entry*> findAll(const Key &key) const {
+            std::vector<const Entry*> result;
+
+            auto [begin, end] = this->m_lookup.equal_range(key);
+            for (auto it = begin; it != end; ++it)
+                result.push_back(&it->second);
+
+            return result;
+        }
+
+        [[nodiscard]]
+        bool contains(const Key &key) const {
+            return this->m_lookup.contains(key);
+        }
+
+        [[nodiscard]]
+        size_t count(const Key &key) const {
+            return this->m_lookup.count(key);
+        }
+
+        [[nodiscard]]
+        size_t size() const {
+            return this->m_lookup.size();
+        }
+
+        void rebuild() {
+            this->detach();
+
+            this->forEachMatch(*this->m_root, 0, [this](std::string_view key, Value &child) {
+                this->attach(child, 1, nullptr, key);
+            });
+        }
+
+        void detach() {
+            this->forEachMatch(*this->m_root, 0, [this](std::string_view, Value &child) {
+                this->detach(child, 1);
+            });
+
+            this->m_elements.clear();
+            this->m_lookup.clear();
+        }
+
+        void setRoot(Set &root) {
+            this->m_root = &root;
+        }
+
+        void accessedRoot(std::string_view key, Value &child) {
+            if (this->matches(0, key) && !child.m_indexBindings.contains(this))
+                this->attach(child, 1, nullptr, key);
+        }
+
+    private:
+        friend class impl::IndexBindings<Value>;
+
+        struct ElementState {
+            std::string key;
+            std::optional<Key> value;
+        };
+
+        [[nodiscard]]
+        bool matches(u32 depth, std::string_view key) const {
+            return depth == this->m_wildcard || this->m_segments[depth] == key;
+        }
+
+        template<typename Callback>
+        void forEachMatch(Set &set, u32 depth, Callback &&callback) {
+            if (depth == this->m_wildcard) {
+                for (auto &[key, child] : set)
+                    callback(key, child);
+            } else {
+                auto it = set.find(this->m_segments[depth]);
+                if (it != set.end())
+                    callback(it->first, it->second);
+            }
+        }
+
+        void attach(Value &node, u32 depth, Value *element, std::string_view key) {
+            const bool isElement = depth == this->m_wildcard + 1;
+            if (isElement) {
+                element = &node;
+                this->m_elements.try_emplace(&node, ElementState { std::string(key), std::nullopt });
+            }
+
+            node.m_indexBindings.add({ this, depth, element });
+
+            if (depth < this->m_segments.size() && node.isSet()) {
+                this->forEachMatch(node.set(), depth, [&, this](std::string_view childKey, Value &child) {
+                    this->attach(child, depth + 1, element, childKey);
+                });
+            }
+
+            if (isElement)
+                this->refresh(node);
+        }
+
+        void detach(Value &node, u32 depth) {
+            node.m_indexBindings.remove(this);
+
+            if (depth < this->m_segments.size() && node.isSet()) {
+                this->forEachMatch(node.set(), depth, [&, this](std::string_view, Value &child) {
+                    this->detach(child, depth + 1);
+                });
+            }
+        }
+
+        void unlink(Value &element, ElementState &state) {
+            if (!state.value.has_value())
+                return;
+
+            auto [begin, end] = this->m_lookup.equal_range(*state.value);
+            for (auto it = begin; it != end; ++it) {
+                if (it->second.element == &element) {
+                    this->m_lookup.erase(it);
+                    break;
+                }
+            }
+
+            state.value.reset();
+        }
+
+        void refresh(Value &element) {
+            auto it = this->m_elements.find(&element);
+            if (it == this->m_elements.end())
+                return;
+
+            auto &state = it->second;
+            this->unlink(element, state);
+
+            // Walk from the element down to the leaf the element is indexed by
+            Value *leaf = &element;
+            for (u32 depth = this->m_wildcard + 1; depth < this->m_segments.size(); depth++) {
+                if (!leaf->isSet())
+                    return;
+
+                auto child = leaf->set().find(this->m_segments[depth]);
+                if (child == leaf->set().end())
+                    return;
+
+                leaf = &child->second;
+            }
+
+            state.value = leaf->indexKey();
+            if (state.value.has_value())
+                this->m_lookup.emplace(*state.value, Entry { state.key, &element });
+        }
+
+        void remove(Value &element) {
+            auto it = this->m_elements.find(&element);
+            if (it == this->m_elements.end())
+                return;
+
+            this->unlink(element, it->second);
+            this->m_elements.erase(it);
+        }
+
+        void accessed(const impl::IndexBinding<Value> &binding, std::string_view key, Value &child) {
+            if (binding.depth >= this->m_segments.size() || !this->matches(binding.depth, key))
+                return;
+
+            if (child.m_indexBindings.contains(this))
+                return;
+
+            this->attach(child, binding.depth + 1, binding.element, key);
+            if (binding.depth + 1 > this->m_wildcard + 1)
+                this->refresh(*binding.element);
+        }
+
+        void erasing(const impl::IndexBinding<Value> &binding, Value &child) {
+            if (binding.depth == this->m_wildcard + 1)
+                this->remove(child);
+        }
+
+        void erased(const impl::IndexBinding<Value> &binding) {
+            if (binding.depth <= this->m_wildcard)
+                this->rebuild();
+            else if (binding.depth > this->m_wildcard + 1)
+                this->refresh(*binding.element);
+        }
+
+        void assigned(const impl::IndexBinding<Value> &binding, Value &node) {
+            // Replacing anything above the indexed elements can add or remove any number of them
+            if (binding.depth <= this->m_wildcard) {
+                this->rebuild();
+                return;
+            }
+
+            this->attach(node, binding.depth, binding.element, { });
+            if (binding.depth > this->m_wildcard + 1)
+                this->refresh(*binding.element);
+        }
+
+    private:
+        Set *m_root;
+        std::vector<std::string> m_segments;
+        u32 m_wildcard;
+
+        std::unordered_map<Value*, ElementState> m_elements;
+        std::unordered_multimap<Key, Entry> m_lookup;
+    };
+
+}
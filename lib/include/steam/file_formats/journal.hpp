@@ -0,0 +1,83 @@
+#pragma once
+
+#include <steam.hpp>
+#include <steam/helpers/fs.hpp>
+#include <steam/file_formats/diff.hpp>
+#include <steam/file_formats/vdf.hpp>
+#include <steam/file_formats/keyvalues.hpp>
+
+#include <optional>
+#include <span>
+#include <vector>
+
+namespace steam {
+
+    // Append-only edit history of a VDF or KeyValues file.
+    //
+    // The first recorded edit keeps the untouched file around as "<file>.orig", every edit afterwards is appended to
+    // "<file>.journal" as a compact binary record of its structural changes relative to the previous version. Any
+    // earlier version can be reconstructed by replaying records on top of the baseline. Once the journal grows too
+    // long, the oldest records get folded into the baseline.
+    //
+    // Journal file layout: the magic, the version and the checksum of the baseline it belongs to, followed by entries of
+    //   u32 payload size, u32 payload checksum, u64 timestamp, u32 checksum of the resulting file, u32 change count, changes
+    // with changes being
+    //   u8 kind, u32 path length, (u32 size, key bytes) per path segment, encoded new value for added and modified nodes
+    //
+    // The parsed entries and the baseline checksum are cached per process and reused for as long as neither file changed
+    // on disk, so recording an edit only has to write the new entry.
+    //
+    // The journal doesn't lock anything itself, callers are expected to hold the file's lock, e.g through an api::Transaction.
+    template<typename Document>
+    class Journal {
+    public:
+        constexpr static size_t MaxEntryCount = 256;
+        constexpr static size_t CompactedEntryCount = 64;
+
+        explicit Journal(const std::fs::path &path);
+
+        // Appends the changes between two versions of the document. The checksums are the crc32 of the respective
+        // file contents, they are used to notice when the file got modified by someone else in the meantime.
+        bool record(const Document &previous, u32 previousChecksum, const Document &current, u32 currentChecksum);
+
+        [[nodiscard]] size_t getEntryCount() const;
+
+        // Rebuilds the document as it was after the first entryCount edits
+        [[nodiscard]] std::optional<Document> reconstruct(size_t entryCount) const;
+
+        // Rewrites the file to the state after the first entryCount edits and discards every later entry
+        bool restore(size_t entryCount);
+        bool undo();
+
+        // Folds everything except the last keepEntries edits into the baseline
+        bool compact(size_t keepEntries = CompactedEntryCount);
+
+        [[nodiscard]] const std::fs::path &getJournalPath() const { return this->m_journalPath; }
+        [[nodiscard]] const std::fs::path &getBaselinePath() const { return this->m_baselinePath; }
+
+    private:
+        struct EntryLocation {
+            u64 offset;
+            u32 size;
+            u32 resultChecksum;
+        };
+
+        struct State {
+            std::vector<EntryLocation> entries;
+            u32 baselineChecksum = 0;
+            u64 validEnd = 0;
+        };
+
+        // Reads all intact entries. Entries of a journal that doesn't belong to the current baseline are ignored
+        [[nodiscard]] std::optional<State> readState() const;
+        void storeState(const State &state) const;
+        [[nodiscard]] std::optional<Document> replay(const State &state, size_t entryCount) const;
+
+        bool resetBaseline(const Document &document);
+        bool append(State &state, const std::vector<DocumentChange<typename Document::Value>> &changes, u32 resultChecksum);
+
+    private:
+        std::fs::path m_path, m_journalPath, m_baselinePath;
+    };
+
+}
@@ -3,7 +3,14 @@
 #include <steam.hpp>
 #include <steam/helpers/fs.hpp>
 #include <steam/helpers/file.hpp>
-
+#include <steam/helpers/mapped_file.hpp>
+#include <steam/helpers/small_string.hpp>
+#include <steam/file_formats/compact_value.hpp>
+#include <steam/file_formats/index.hpp>
+#include <steam/file_formats/validation.hpp>
+
+#include <memory>
+#include <optional>
 #include <variant>
 #include <vector>
 #include <string>
@@ -16,105 +23,190 @@ namespace steam {
     public:
 
         KeyValues() = default;
-        explicit KeyValues(const std::fs::path &path) : m_content(parse(fs::File(path, fs::File::Mode::Read).readString())) { }
+        explicit KeyValues(const std::fs::path &path) : m_content(parse(fs::MappedFile(path).getString())) { }
         explicit KeyValues(const std::string &content) : m_content(parse(content)) { }
+        explicit KeyValues(std::string_view content) : m_content(parse(content)) { }
+
+        KeyValues(const KeyValues &other);
+        KeyValues(KeyValues &&other) noexcept;
+
+        KeyValues& operator=(const KeyValues &other);
+        KeyValues& operator=(KeyValues &&other) noexcept;
 
         struct Value;
 
-        using Set = std::map<std::string, Value>;
+        using Set = std::map<SmallString, Value, std::less<>>;
 
         struct Value {
-            std::variant<Set, std::string> content;
+            using IndexKey = std::string;
 
-            [[nodiscard]]
-            std::string& string() {
-                return std::get<std::string>(content);
+            Value() = default;
+            Value(const Value &) = default;
+            Value(Value &&other) noexcept : m_content(std::move(other.m_content)) {
+                impl::IndexBindings<Value>::detachChildren(*this);
             }
 
             [[nodiscard]]
-            const KeyValues::Set& set() const {
-                return std::get<KeyValues::Set>(content);
+            std::string_view string() const {
+                return this->m_content.getString();
             }
 
             [[nodiscard]]
-            KeyValues::Set& set() {
-                return std::get<KeyValues::Set>(content);
+            const KeyValues::Set& set() const {
+                return this->m_content.getSet();
             }
 
             [[nodiscard]]
-            const std::string& string() const {
-                return std::get<std::string>(content);
+            KeyValues::Set& set() {
+                return this->m_content.getSet();
             }
 
             [[nodiscard]]
             bool isString() const {
-                return std::get_if<std::string>(&content) != nullptr;
+                return this->m_content.getType() == impl::CompactValue<Set>::Type::String;
             }
 
             [[nodiscard]]
             bool isSet() const {
-                return std::get_if<Set>(&content) != nullptr;
+                return this->m_content.getType() == impl::CompactValue<Set>::Type::Set;
+            }
+
+            template<typename Visitor>
+            decltype(auto) visit(Visitor &&visitor) const {
+                if (this->isString())
+                    return visitor(this->string());
+                else
+                    return visitor(this->set());
             }
 
             [[nodiscard]]
             Value& operator[](const std::string &key) & {
-                return std::get<Set>(content)[key];
+                return this->child(key);
             }
 
             [[nodiscard]]
             Value&& operator[](const std::string &key) && {
-                return std::move(std::get<Set>(content)[key]);
+                return std::move(this->child(key));
             }
 
             [[nodiscard]]
             Value& operator[](const char *key) & {
-                return std::get<Set>(content)[key];
+                return this->child(key);
             }
 
             [[nodiscard]]
             Value&& operator[](const char *key) && {
-                return std::move(std::get<Set>(content)[key]);
+                return std::move(this->child(key));
             }
 
-            auto& operator=(const std::string &value) {
-                this->content = value;
+            auto& operator=(std::string_view value) {
+                this->m_content.setString(value);
+                this->m_indexBindings.assigned(*this);
                 return *this;
             }
 
             auto& operator=(const Set &value) {
-                this->content = value;
+                this->m_content.setSet(value);
+                this->m_indexBindings.assigned(*this);
+                return *this;
+            }
+
+            auto& operator=(Set &&value) {
+                this->m_content.setSet(std::move(value));
+                impl::IndexBindings<Value>::detachChildren(*this);
+                this->m_indexBindings.assigned(*this);
                 return *this;
             }
 
             [[nodiscard]]
-            explicit operator const std::string&() const {
+            explicit operator std::string_view() const {
                 return this->string();
             }
 
             [[nodiscard]]
-            explicit operator std::string() {
-                return this->string();
+            explicit operator std::string() const {
+                return std::string(this->string());
+            }
+
+            Value& operator=(const Value &other) {
+                this->m_content = other.m_content;
+                this->m_indexBindings.assigned(*this);
+                return *this;
+            }
+
+            Value& operator=(Value &&other) {
+                this->m_content = std::move(other.m_content);
+                impl::IndexBindings<Value>::detachChildren(*this);
+                this->m_indexBindings.assigned(*this);
+                other.m_indexBindings.assigned(other);
+                return *this;
             }
 
             bool operator==(const Value &other) const {
-                return this->content == other.content;
+                return this->m_content == other.m_content;
             }
 
             bool operator!=(const Value &other) const {
-                return this->content != other.content;
+                return !(*this == other);
             }
 
             [[nodiscard]]
-            bool contains(const std::string &key) {
-                auto set = std::get_if<Set>(&this->content);
-                if (set == nullptr)
+            bool contains(const std::string &key) const {
+                if (!this->isSet())
+                    return false;
+
+                return this->set().contains(key);
+            }
+
+            bool erase(const std::string &key) {
+                if (!this->isSet())
                     return false;
 
-                return set->contains(key);
+                auto &set = this->set();
+                auto it = set.find(key);
+                if (it == set.end())
+                    return false;
+
+                impl::IndexBindings<Value>::erase(set, it);
+
+                return true;
             }
 
+            [[nodiscard]]
+            std::optional<IndexKey> indexKey() const {
+                if (this->isString())
+                    return std::string(this->string());
+                else
+                    return std::nullopt;
+            }
+
+            [[nodiscard]]
+            MemoryUsage memoryUsage() const {
+                return this->m_content.memoryUsage();
+            }
+
+        private:
+            friend class DocumentIndex<Value>;
+            friend class impl::IndexBindings<Value>;
+
+            Value& child(std::string_view key) {
+                auto &set = this->set();
+
+                auto it = set.lower_bound(key);
+                if (it == set.end() || it->first != key)
+                    it = set.emplace_hint(it, key, Value());
+
+                this->m_indexBindings.accessed(key, it->second);
+
+                return it->second;
+            }
+
+            impl::CompactValue<Set> m_content;
+            impl::IndexBindings<Value> m_indexBindings;
         };
 
+        using Index = DocumentIndex<Value>;
+
         struct KeyValuePair {
             std::string key;
             Value value;
@@ -123,7 +215,11 @@ namespace steam {
 
         [[nodiscard]]
         Value& operator[](const char *key) {
-            return this->m_content[key];
+            auto &child = this->m_content[key];
+            for (auto &index : this->m_indexes)
+                index->accessedRoot(key, child);
+
+            return child;
         }
 
         [[nodiscard]]
@@ -133,7 +229,11 @@ namespace steam {
 
         [[nodiscard]]
         Value& operator[](const std::string &key) {
-            return this->m_content[key];
+            auto &child = this->m_content[key];
+            for (auto &index : this->m_indexes)
+                index->accessedRoot(key, child);
+
+            return child;
         }
 
         [[nodiscard]]
@@ -151,6 +251,32 @@ namespace steam {
             return this->m_content;
         }
 
+        bool erase(const std::string &key) {
+            auto it = this->m_content.find(key);
+            if (it == this->m_content.end())
+                return false;
+
+            impl::IndexBindings<Value>::erase(this->m_content, it);
+
+            return true;
+        }
+
+        const Index* addIndex(const std::string &pattern);
+        bool removeIndex(const std::string &pattern);
+
+        [[nodiscard]]
+        const Index* getIndex(const std::string &pattern) const;
+
+        void reindex();
+
+        [[nodiscard]]
+        static ValidationResult validate(std::string_view data);
+
+        [[nodiscard]]
+        MemoryUsage memoryUsage() const {
+            return impl::measureSet(this->m_content);
+        }
+
         [[nodiscard]]
         std::string dump() const;
 
@@ -168,8 +294,9 @@ namespace steam {
         }
 
     private:
-        Set parse(const std::string &data);
+        Set parse(std::string_view data);
         Set m_content;
+        std::vector<std::unique_ptr<Index>> m_indexes;
     };
 
 }
\ No newline at end of file
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <steam.hpp>
+#include <steam/file_formats/vdf.hpp>
+
+#include <optional>
+#include <span>
+#include <string_view>
+
+namespace steam {
+
+    struct ShortcutEntry {
+        std::string_view key;
+        std::optional<u32> appId;
+
+        // Views into the scanned buffer, empty if the shortcut doesn't have the field
+        std::string_view appName, exe;
+    };
+
+    // Walks a binary shortcuts.vdf buffer and yields the appid, name and executable of every shortcut without
+    // building a document or allocating anything. Field names are matched case-insensitively since older
+    // Steam versions wrote them in lower case.
+    class ShortcutScanner {
+    public:
+        explicit ShortcutScanner(std::span<const u8> data) : m_data(data) { }
+
+        // Returns the next shortcut, or std::nullopt once the end of the buffer or malformed data has been reached
+        [[nodiscard]] std::optional<ShortcutEntry> next();
+
+        // False if scanning stopped because the buffer was malformed or truncated
+        [[nodiscard]] bool isValid() const {
+            return this->m_valid;
+        }
+
+    private:
+        [[nodiscard]] std::optional<std::string_view> readString();
+
+    private:
+        std::span<const u8> m_data;
+        size_t m_offset = 0;
+        u32 m_depth = 0;
+        bool m_valid = true;
+        bool m_complete = false;
+
+        ShortcutEntry m_entry;
+    };
+
+}
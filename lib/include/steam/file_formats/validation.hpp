@@ -0,0 +1,39 @@
+#pragma once
+
+#include <steam.hpp>
+
+#include <cstddef>
+
+namespace steam {
+
+    enum class ValidationError : u8 {
+        None,
+        UnexpectedEnd,
+        InvalidType,
+        EmptyKey,
+        UnexpectedCharacter,
+        InvalidEscapeSequence,
+        InvalidEncoding,
+        UnbalancedSet,
+        TrailingData
+    };
+
+    struct ValidationResult {
+        ValidationError error = ValidationError::None;
+        size_t offset = 0;
+
+        size_t nodeCount = 0;
+        u32 maxDepth = 0;
+
+        [[nodiscard]]
+        bool isValid() const {
+            return this->error == ValidationError::None;
+        }
+
+        [[nodiscard]]
+        explicit operator bool() const {
+            return this->isValid();
+        }
+    };
+
+}
@@ -3,7 +3,15 @@
 #include <steam.hpp>
 #include <steam/helpers/fs.hpp>
 #include <steam/helpers/file.hpp>
-
+#include <steam/helpers/mapped_file.hpp>
+#include <steam/helpers/small_string.hpp>
+#include <steam/file_formats/compact_value.hpp>
+#include <steam/file_formats/index.hpp>
+#include <steam/file_formats/validation.hpp>
+
+#include <memory>
+#include <optional>
+#include <span>
 #include <variant>
 #include <vector>
 #include <map>
@@ -13,8 +21,15 @@ namespace steam {
     class VDF {
     public:
         VDF() = default;
-        explicit VDF(const std::fs::path &path) : m_content(parse(fs::File(path, fs::File::Mode::Read).readBytes())) { }
+        explicit VDF(const std::fs::path &path) : m_content(parse(fs::MappedFile(path).getBytes())) { }
         explicit VDF(const std::vector<u8> &content) : m_content(parse(content)) { }
+        explicit VDF(std::span<const u8> content) : m_content(parse(content)) { }
+
+        VDF(const VDF &other);
+        VDF(VDF &&other) noexcept;
+
+        VDF& operator=(const VDF &other);
+        VDF& operator=(VDF &&other) noexcept;
 
         enum class Type : u8 {
             Set = 0x00,
@@ -25,99 +40,128 @@ namespace steam {
 
         struct Value;
 
-        using Set = std::map<std::string, Value>;
+        using Set = std::map<SmallString, Value, std::less<>>;
 
         struct Value {
-            std::variant<Set, std::string, u32> content;
+            using IndexKey = std::variant<std::string, u32>;
+
+            Value() = default;
+            Value(const Value &) = default;
+            Value(Value &&other) noexcept : m_content(std::move(other.m_content)) {
+                impl::IndexBindings<Value>::detachChildren(*this);
+            }
 
             [[nodiscard]]
-            std::string& string() {
-                return std::get<std::string>(content);
+            Type getType() const {
+                switch (this->m_content.getType()) {
+                    case impl::CompactValue<Set>::Type::String:  return Type::String;
+                    case impl::CompactValue<Set>::Type::Integer: return Type::Integer;
+                    default:                                     return Type::Set;
+                }
             }
 
             [[nodiscard]]
-            const std::string& string() const {
-                return std::get<std::string>(content);
+            std::string_view string() const {
+                return this->m_content.getString();
             }
 
             [[nodiscard]]
             u32& integer() {
-                return std::get<u32>(content);
+                return this->m_content.getInteger();
             }
 
             [[nodiscard]]
             const u32& integer() const {
-                return std::get<u32>(content);
+                return this->m_content.getInteger();
             }
 
             [[nodiscard]]
             Set& set() {
-                return std::get<Set>(content);
+                return this->m_content.getSet();
             }
 
             [[nodiscard]]
             const Set& set() const {
-                return std::get<Set>(content);
+                return this->m_content.getSet();
             }
 
             [[nodiscard]]
             bool isInteger() const {
-                return std::get_if<u32>(&content) != nullptr;
+                return this->getType() == Type::Integer;
             }
 
             [[nodiscard]]
             bool isString() const {
-                return std::get_if<std::string>(&content) != nullptr;
+                return this->getType() == Type::String;
             }
 
             [[nodiscard]]
             bool isSet() const {
-                return std::get_if<Set>(&content) != nullptr;
+                return this->getType() == Type::Set;
+            }
+
+            template<typename Visitor>
+            decltype(auto) visit(Visitor &&visitor) const {
+                switch (this->getType()) {
+                    case Type::String:  return visitor(this->string());
+                    case Type::Integer: return visitor(this->integer());
+                    default:            return visitor(this->set());
+                }
             }
 
             [[nodiscard]]
             Value& operator[](const std::string &key) & {
-                return std::get<Set>(content)[key];
+                return this->child(key);
             }
 
             [[nodiscard]]
             Value&& operator[](const std::string &key) && {
-                return std::move(std::get<Set>(content)[key]);
+                return std::move(this->child(key));
             }
 
             [[nodiscard]]
             Value& operator[](const char *key) & {
-                return std::get<Set>(content)[key];
+                return this->child(key);
             }
 
             [[nodiscard]]
             Value&& operator[](const char *key) && {
-                return std::move(std::get<Set>(content)[key]);
+                return std::move(this->child(key));
             }
 
             auto& operator=(u32 value) {
-                this->content = value;
+                this->m_content.setInteger(value);
+                this->m_indexBindings.assigned(*this);
                 return *this;
             }
 
-            auto& operator=(const std::string &value) {
-                this->content = value;
+            auto& operator=(std::string_view value) {
+                this->m_content.setString(value);
+                this->m_indexBindings.assigned(*this);
                 return *this;
             }
 
             auto& operator=(const Set &value) {
-                this->content = value;
+                this->m_content.setSet(value);
+                this->m_indexBindings.assigned(*this);
+                return *this;
+            }
+
+            auto& operator=(Set &&value) {
+                this->m_content.setSet(std::move(value));
+                impl::IndexBindings<Value>::detachChildren(*this);
+                this->m_indexBindings.assigned(*this);
                 return *this;
             }
 
             [[nodiscard]]
-            explicit operator const std::string&() const {
+            explicit operator std::string_view() const {
                 return this->string();
             }
 
             [[nodiscard]]
-            explicit operator std::string() {
-                return this->string();
+            explicit operator std::string() const {
+                return std::string(this->string());
             }
 
             [[nodiscard]]
@@ -130,16 +174,78 @@ namespace steam {
                 return this->integer();
             }
 
+            Value& operator=(const Value &other) {
+                this->m_content = other.m_content;
+                this->m_indexBindings.assigned(*this);
+                return *this;
+            }
+
+            Value& operator=(Value &&other) {
+                this->m_content = std::move(other.m_content);
+                impl::IndexBindings<Value>::detachChildren(*this);
+                this->m_indexBindings.assigned(*this);
+                other.m_indexBindings.assigned(other);
+                return *this;
+            }
+
             bool operator==(const Value &other) const {
-                return this->content == other.content;
+                return this->m_content == other.m_content;
             }
 
             bool operator!=(const Value &other) const {
-                return this->content != other.content;
+                return !(*this == other);
+            }
+
+            bool erase(const std::string &key) {
+                if (!this->isSet())
+                    return false;
+
+                auto &set = this->set();
+                auto it = set.find(key);
+                if (it == set.end())
+                    return false;
+
+                impl::IndexBindings<Value>::erase(set, it);
+
+                return true;
+            }
+
+            [[nodiscard]]
+            std::optional<IndexKey> indexKey() const {
+                switch (this->getType()) {
+                    case Type::String:  return std::string(this->string());
+                    case Type::Integer: return this->integer();
+                    default:            return std::nullopt;
+                }
             }
 
+            [[nodiscard]]
+            MemoryUsage memoryUsage() const {
+                return this->m_content.memoryUsage();
+            }
+
+        private:
+            friend class DocumentIndex<Value>;
+            friend class impl::IndexBindings<Value>;
+
+            Value& child(std::string_view key) {
+                auto &set = this->set();
+
+                auto it = set.lower_bound(key);
+                if (it == set.end() || it->first != key)
+                    it = set.emplace_hint(it, key, Value());
+
+                this->m_indexBindings.accessed(key, it->second);
+
+                return it->second;
+            }
+
+            impl::CompactValue<Set> m_content;
+            impl::IndexBindings<Value> m_indexBindings;
         };
 
+        using Index = DocumentIndex<Value>;
+
         struct KeyValuePair {
             std::string key;
             Value value;
@@ -147,7 +253,11 @@ namespace steam {
 
         [[nodiscard]]
         Value& operator[](const char *key) {
-            return this->m_content[key];
+            auto &child = this->m_content[key];
+            for (auto &index : this->m_indexes)
+                index->accessedRoot(key, child);
+
+            return child;
         }
 
         [[nodiscard]]
@@ -157,7 +267,11 @@ namespace steam {
 
         [[nodiscard]]
         Value& operator[](const std::string &key) {
-            return this->m_content[key];
+            auto &child = this->m_content[key];
+            for (auto &index : this->m_indexes)
+                index->accessedRoot(key, child);
+
+            return child;
         }
 
         [[nodiscard]]
@@ -175,6 +289,32 @@ namespace steam {
             return this->m_content;
         }
 
+        bool erase(const std::string &key) {
+            auto it = this->m_content.find(key);
+            if (it == this->m_content.end())
+                return false;
+
+            impl::IndexBindings<Value>::erase(this->m_content, it);
+
+            return true;
+        }
+
+        const Index* addIndex(const std::string &pattern);
+        bool removeIndex(const std::string &pattern);
+
+        [[nodiscard]]
+        const Index* getIndex(const std::string &pattern) const;
+
+        void reindex();
+
+        [[nodiscard]]
+        static ValidationResult validate(std::span<const u8> data);
+
+        [[nodiscard]]
+        MemoryUsage memoryUsage() const {
+            return impl::measureSet(this->m_content);
+        }
+
         [[nodiscard]]
         std::vector<u8> dump() const;
 
@@ -190,9 +330,10 @@ namespace steam {
         }
 
     private:
-        Set parse(const std::vector<u8> &data);
+        Set parse(std::span<const u8> data);
 
         Set m_content;
+        std::vector<std::unique_ptr<Index>> m_indexes;
     };
 
     static inline bool operator==(u8 byte, VDF::Type type) {
@@ -0,0 +1,124 @@
+#pragma once
+
+#include <steam.hpp>
+#include <steam/helpers/fs.hpp>
+#include <steam/helpers/file.hpp>
+#include <steam/file_formats/vdf.hpp>
+
+#include <functional>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <variant>
+#include <vector>
+
+namespace steam {
+
+    struct VDFEvent {
+        VDF::Type type;
+        std::string_view key;
+        std::string_view string;
+        u32 integer = 0;
+    };
+
+    // Pull parser for binary VDF files that only keeps a small window of the input in memory.
+    // Sets are reported as a Set event followed by their children and a closing EndSet event, the end of the
+    // document itself is not reported. Views inside of an event stay valid until the next call to next().
+    class VDFStreamReader {
+    public:
+        constexpr static size_t DefaultBufferSize = 64 * 1024;
+
+        explicit VDFStreamReader(fs::File &file, size_t bufferSize = DefaultBufferSize);
+
+        [[nodiscard]]
+        std::optional<VDFEvent> next();
+
+        [[nodiscard]]
+        bool hasError() const {
+            return this->m_error;
+        }
+
+        [[nodiscard]]
+        u32 getDepth() const {
+            return this->m_depth;
+        }
+
+    private:
+        bool ensure(size_t count);
+        std::optional<size_t> findTerminator(size_t offset);
+
+        std::optional<VDFEvent> fail();
+
+    private:
+        fs::File &m_file;
+        std::vector<u8> m_buffer;
+        size_t m_position = 0, m_size = 0;
+
+        u32 m_depth = 0;
+        bool m_endOfFile = false, m_done = false, m_error = false;
+    };
+
+    // Buffered writer producing the same binary representation as VDF::dump()
+    class VDFStreamWriter {
+    public:
+        constexpr static size_t DefaultBufferSize = 64 * 1024;
+
+        explicit VDFStreamWriter(fs::File &file, size_t bufferSize = DefaultBufferSize);
+
+        void write(const VDFEvent &event);
+        void write(std::string_view key, const VDF::Value &value);
+
+        // Terminates the document and flushes everything to the file. Returns false if any write to the file failed
+        [[nodiscard]] bool finish();
+
+        [[nodiscard]]
+        bool hasError() const {
+            return this->m_error;
+        }
+
+    private:
+        void append(std::string_view data);
+        void append(u8 byte);
+        void flush();
+
+    private:
+        fs::File &m_file;
+        std::vector<u8> m_buffer;
+        size_t m_bufferSize;
+        bool m_error = false;
+    };
+
+    // Streaming edit of a binary VDF file. Every node matching the record pattern (e.g "shortcuts/*") is read into
+    // memory on its own and passed through all stages in order, everything else is copied over unchanged.
+    // Memory usage is therefore bounded by the largest single record instead of the size of the file.
+    class VDFTransform {
+    public:
+        using Filter = std::function<bool(std::string_view key, const VDF::Value &record)>;
+        using Map    = std::function<void(std::string_view key, VDF::Value &record)>;
+
+        explicit VDFTransform(std::string_view recordPattern = "shortcuts/*");
+
+        VDFTransform& filter(Filter filter);
+        VDFTransform& map(Map map);
+
+        // Re-key all kept records as 0, 1, 2, ... so arrays stay contiguous after records have been dropped
+        VDFTransform& renumber(bool enabled = true);
+
+        [[nodiscard]]
+        bool apply(fs::File &input, fs::File &output) const;
+
+        // The output file is only replaced once the transform succeeded, so output may also be the input file itself
+        [[nodiscard]]
+        bool apply(const std::fs::path &input, const std::fs::path &output) const;
+
+    private:
+        [[nodiscard]]
+        bool isRecord(const std::vector<std::string> &path, std::string_view key) const;
+
+    private:
+        std::vector<std::string> m_pattern;
+        std::vector<std::variant<Filter, Map>> m_stages;
+        bool m_renumber = false;
+    };
+
+}
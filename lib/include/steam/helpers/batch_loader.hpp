@@ -0,0 +1,42 @@
+#pragma once
+
+#include <steam.hpp>
+
+#include <span>
+#include <string_view>
+#include <vector>
+
+#include <steam/helpers/fs.hpp>
+
+namespace steam::fs {
+
+    struct LoadedFile {
+        std::fs::path path;
+        std::vector<u8> content;
+        bool valid = false;
+
+        [[nodiscard]] bool isValid() const {
+            return this->valid;
+        }
+
+        [[nodiscard]] std::span<const u8> getBytes() const {
+            return this->content;
+        }
+
+        [[nodiscard]] std::string_view getString() const {
+            return { reinterpret_cast<const char *>(this->content.data()), this->content.size() };
+        }
+    };
+
+    enum class LoadBackend
+    {
+        Automatic,
+        IoUring,
+        ThreadPool
+    };
+
+    // Reads many whole files at once. With io_uring all opens, stats and reads are queued up front so their latencies
+    // overlap, otherwise the files are read by a pool of threads. Results are returned in the same order as the paths.
+    std::vector<LoadedFile> loadFiles(std::span<const std::fs::path> paths, LoadBackend backend = LoadBackend::Automatic);
+
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <steam.hpp>
+
+#include <span>
+#include <vector>
+
+#include <steam/helpers/fs.hpp>
+
+namespace steam::fs {
+
+    struct DiskUsage {
+        u64 size = 0;
+        u64 allocatedSize = 0;
+        u64 fileCount = 0;
+        u64 directoryCount = 0;
+
+        DiskUsage& operator+=(const DiskUsage &other) {
+            this->size           += other.size;
+            this->allocatedSize  += other.allocatedSize;
+            this->fileCount      += other.fileCount;
+            this->directoryCount += other.directoryCount;
+
+            return *this;
+        }
+    };
+
+    // Measures the total size of every directory tree in roots. Directories are listed with getdents64 and their
+    // entries queried with statx, spread across a work-stealing pool of threads so a single huge tree doesn't end up
+    // on one thread. Symlinks are counted but never followed. Results are returned in the same order as the roots.
+    std::vector<DiskUsage> measureDirectories(std::span<const std::fs::path> roots);
+
+}
@@ -2,7 +2,7 @@
 
 #include <steam.hpp>
 
-#include <cstdio>
+#include <span>
 #include <string>
 #include <vector>
 
@@ -10,6 +10,8 @@
 
 namespace steam::fs {
 
+    // Unbuffered file backed by a raw file descriptor. Whether the file could be opened is determined once
+    // when opening it, none of the operations touch the path again afterwards.
     class File {
     public:
         enum class Mode
@@ -30,7 +32,7 @@ namespace steam::fs {
 
 
         [[nodiscard]] bool isValid() const {
-            return this->m_file != nullptr && fs::exists(this->m_path) && !fs::isDirectory(this->m_path);
+            return this->m_fd >= 0;
         }
 
         void seek(u64 offset);
@@ -40,24 +42,31 @@ namespace steam::fs {
         std::vector<u8> readBytes(size_t numBytes = 0);
         std::string readString(size_t numBytes = 0);
 
-        void write(const u8 *buffer, size_t size);
-        void write(const std::vector<u8> &bytes);
-        void write(const std::string &string);
+        // Positional reads and writes, these don't move the file offset
+        size_t readBufferAt(u64 offset, u8 *buffer, size_t size) const;
+        bool writeAt(u64 offset, const u8 *buffer, size_t size);
+
+        bool write(const u8 *buffer, size_t size);
+        bool write(const std::vector<u8> &bytes);
+        bool write(const std::string &string);
+
+        // Writes all buffers in order using as few system calls as possible
+        bool writeVectored(std::span<const std::span<const u8>> buffers);
 
         [[nodiscard]] size_t getSize() const;
         void setSize(u64 size);
 
+        // Writes are unbuffered, flush() only exists for symmetry. sync() waits until the data reached the disk
         void flush();
+        bool sync();
         bool remove();
 
-        auto getHandle() { return this->m_file; }
+        auto getHandle() const { return this->m_fd; }
         const std::fs::path &getPath() { return this->m_path; }
 
-        void disableBuffering();
-
     private:
-        FILE *m_file;
+        int m_fd;
         std::fs::path m_path;
     };
 
-}
\ No newline at end of file
+}
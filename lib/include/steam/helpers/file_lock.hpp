@@ -0,0 +1,39 @@
+#pragma once
+
+#include <steam.hpp>
+
+#include <steam/helpers/fs.hpp>
+
+namespace steam::fs {
+
+    // Advisory lock guarding a file against other cooperating writers. The lock is taken on a separate "<file>.lock"
+    // file because files that get replaced through a rename would otherwise lose the lock together with their old inode.
+    class FileLock {
+    public:
+        enum class Mode
+        {
+            Shared,
+            Exclusive
+        };
+
+        explicit FileLock(const std::fs::path &path, Mode mode = Mode::Exclusive, bool wait = true) noexcept;
+        FileLock() noexcept;
+        FileLock(const FileLock &) = delete;
+        FileLock(FileLock &&other) noexcept;
+
+        ~FileLock();
+
+        FileLock &operator=(FileLock &&other) noexcept;
+
+
+        [[nodiscard]] bool isLocked() const {
+            return this->m_fd >= 0;
+        }
+
+        void unlock();
+
+    private:
+        int m_fd;
+    };
+
+}
@@ -3,6 +3,9 @@
 #include <steam.hpp>
 
 #include <filesystem>
+#include <functional>
+#include <span>
+#include <string_view>
 
 namespace std {
     namespace fs = std::filesystem;
@@ -58,4 +61,18 @@ namespace steam::fs {
 
     bool isPathWritable(const std::fs::path &path);
 
+    // Replaces the file at path with data by writing a temporary file next to it and renaming it over the original.
+    // Readers and a crash at any point only ever see either the old or the new contents
+    bool writeFileAtomic(const std::fs::path &path, std::span<const u8> data);
+    bool writeFileAtomic(const std::fs::path &path, std::string_view data);
+
+    class File;
+
+    // Same as above for contents that are written piece by piece. The original is only replaced if writer returned true
+    bool writeFileAtomic(const std::fs::path &path, const std::function<bool(File &file)> &writer);
+
+    // Atomically creates or replaces to with the contents of from, using reflinks or in-kernel copies where
+    // possible and falling back to a hardlink of from
+    bool backupFile(const std::fs::path &from, const std::fs::path &to);
+
 }
\ No newline at end of file
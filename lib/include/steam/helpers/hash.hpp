@@ -3,14 +3,37 @@
 #include <steam.hpp>
 
 #include <array>
+#include <cstddef>
+#include <ranges>
+#include <type_traits>
 
 namespace steam {
 
-    template<u32 Polynomial = 0x04C11DB7>
-    [[nodiscard]] u32 crc32(const auto &data, u32 initialValue = 0x00) {
-        // Lookup table generation
-        constexpr static auto Table = [] {
-            std::array<u32, 256> table = {0};
+    namespace impl {
+
+        // Lookup tables for slicing-by-16 and the constants used to fold the data with carry-less multiplications
+        struct Crc32Tables {
+            u32 polynomial;
+            std::array<std::array<u32, 256>, 16> slices;
+
+            // Bit-reflected x^n mod P(x) for folding across 512 and 128 bits, x^64 mod P(x), and P(x) with its Barrett constant
+            u64 foldBy4[2], foldBy1[2], fold64, barrett[2];
+        };
+
+        constexpr u64 reflect(u64 value, u32 bits) {
+            u64 result = 0;
+            for (u32 i = 0; i < bits; i++) {
+                if (value & (u64(1) << i))
+                    result |= u64(1) << (bits - 1 - i);
+            }
+
+            return result;
+        }
+
+        template<u32 Polynomial>
+        constexpr Crc32Tables createCrc32Tables() {
+            Crc32Tables tables = { };
+            tables.polynomial = Polynomial;
 
             for (u32 i = 0; i < 256; i++) {
                 u32 c = i;
@@ -20,20 +43,98 @@ namespace steam {
                     else
                         c >>= 1;
                 }
-                table[i] = c;
+                tables.slices[0][i] = c;
+            }
+
+            for (size_t slice = 1; slice < tables.slices.size(); slice++) {
+                for (u32 i = 0; i < 256; i++) {
+                    const auto previous = tables.slices[slice - 1][i];
+                    tables.slices[slice][i] = (previous >> 8) ^ tables.slices[0][previous & 0xFF];
+                }
+            }
+
+            // The table above works on the reflected polynomial, the folding constants are derived from the regular one
+            const u64 polynomial = (u64(1) << 32) | reflect(Polynomial, 32);
+
+            auto powerModulo = [polynomial](u32 exponent) {
+                u64 remainder = 1;
+                for (u32 i = 0; i < exponent; i++) {
+                    remainder <<= 1;
+                    if (remainder & (u64(1) << 32))
+                        remainder ^= polynomial;
+                }
+
+                return reflect(remainder, 33);
+            };
+
+            // floor(x^64 / P(x))
+            u64 quotient = 0;
+            {
+                u128 remainder = u128(1) << 64;
+                for (u32 bit = 64; bit >= 32; bit--) {
+                    if (remainder & (u128(1) << bit)) {
+                        quotient  |= u64(1) << (bit - 32);
+                        remainder ^= u128(polynomial) << (bit - 32);
+                    }
+                }
             }
 
-            return table;
-        }();
+            tables.foldBy4[0] = powerModulo(4 * 128 + 32);
+            tables.foldBy4[1] = powerModulo(4 * 128 - 32);
+            tables.foldBy1[0] = powerModulo(128 + 32);
+            tables.foldBy1[1] = powerModulo(128 - 32);
+            tables.fold64     = powerModulo(64);
+            tables.barrett[0] = reflect(polynomial, 33);
+            tables.barrett[1] = reflect(quotient, 33);
 
-        // CRC32 calculation
-        u32 crc = initialValue;
-        for (u8 byte : data) {
-            crc = Table[(crc ^ byte) & 0xFF] ^ (crc >> 8);
+            return tables;
         }
 
-        return ~crc;
+        template<u32 Polynomial>
+        inline constexpr Crc32Tables Crc32TablesFor = createCrc32Tables<Polynomial>();
+
+        // Advances the raw CRC register over the data. Picks the fastest implementation the CPU supports at runtime
+        [[nodiscard]] u32 crc32Update(const Crc32Tables &tables, u32 crc, const u8 *data, size_t size);
+
     }
 
+    // Incremental CRC32. Data can be fed in any number of pieces, the result is the same as hashing their concatenation
+    template<u32 Polynomial = 0x04C11DB7>
+    class Crc32 {
+    public:
+        constexpr explicit Crc32(u32 initialValue = 0x00) : m_crc(initialValue) { }
+
+        Crc32& update(const auto &data) {
+            using Data = std::remove_cvref_t<decltype(data)>;
+
+            if constexpr (std::ranges::contiguous_range<Data> && sizeof(std::ranges::range_value_t<Data>) == 1) {
+                this->m_crc = impl::crc32Update(impl::Crc32TablesFor<Polynomial>, this->m_crc, reinterpret_cast<const u8*>(std::ranges::data(data)), std::ranges::size(data));
+            } else {
+                for (u8 byte : data)
+                    this->m_crc = impl::Crc32TablesFor<Polynomial>.slices[0][(this->m_crc ^ byte) & 0xFF] ^ (this->m_crc >> 8);
+            }
+
+            return *this;
+        }
+
+        template<typename... Parts> requires (sizeof...(Parts) > 1)
+        Crc32& update(const Parts &...parts) {
+            (this->update(parts), ...);
+
+            return *this;
+        }
+
+        [[nodiscard]] u32 finalize() const {
+            return ~this->m_crc;
+        }
+
+    private:
+        u32 m_crc;
+    };
+
+    template<u32 Polynomial = 0x04C11DB7>
+    [[nodiscard]] u32 crc32(const auto &data, u32 initialValue = 0x00) {
+        return Crc32<Polynomial>(initialValue).update(data).finalize();
+    }
 
-}
\ No newline at end of file
+}
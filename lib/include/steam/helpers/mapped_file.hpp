@@ -0,0 +1,62 @@
+#pragma once
+
+#include <steam.hpp>
+
+#include <span>
+#include <string_view>
+
+#include <steam/helpers/fs.hpp>
+
+namespace steam::fs {
+
+    // Read-only memory mapping of a whole file. The contents are served straight from the page cache,
+    // views into it stay valid until the mapping is closed.
+    class MappedFile {
+    public:
+        enum class Access
+        {
+            Normal,
+            Sequential,
+            Random
+        };
+
+        explicit MappedFile(const std::fs::path &path, Access access = Access::Sequential) noexcept;
+        MappedFile() noexcept = default;
+        MappedFile(const MappedFile &) = delete;
+        MappedFile(MappedFile &&other) noexcept;
+
+        ~MappedFile();
+
+        MappedFile &operator=(MappedFile &&other) noexcept;
+
+
+        [[nodiscard]] bool isValid() const {
+            return this->m_valid;
+        }
+
+        void close();
+
+        // Asks the kernel to start reading in the given range ahead of time
+        void prefetch(size_t offset = 0, size_t size = 0) const;
+
+        [[nodiscard]] const u8 *getData() const { return this->m_data; }
+        [[nodiscard]] size_t getSize() const { return this->m_size; }
+
+        [[nodiscard]] std::span<const u8> getBytes() const {
+            return { this->m_data, this->m_size };
+        }
+
+        [[nodiscard]] std::string_view getString() const {
+            return { reinterpret_cast<const char *>(this->m_data), this->m_size };
+        }
+
+        const std::fs::path &getPath() const { return this->m_path; }
+
+    private:
+        const u8 *m_data = nullptr;
+        size_t m_size = 0;
+        bool m_valid = false;
+        std::fs::path m_path;
+    };
+
+}
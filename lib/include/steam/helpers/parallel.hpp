@@ -0,0 +1,48 @@
+#pragma once
+
+#include <steam.hpp>
+
+#include <algorithm>
+#include <future>
+#include <thread>
+#include <vector>
+
+namespace steam {
+
+    // Calls function(i) for every i in [0, count), splitting the range into contiguous blocks across maxWorkers threads
+    template<typename Function>
+    void parallelFor(size_t count, size_t maxWorkers, Function &&function) {
+        const size_t workerCount = std::min<size_t>(count, std::max<size_t>(1, maxWorkers));
+
+        if (workerCount <= 1) {
+            for (size_t i = 0; i < count; i++)
+                function(i);
+
+            return;
+        }
+
+        auto runBlock = [&](size_t worker) {
+            const size_t begin = count * worker / workerCount;
+            const size_t end   = count * (worker + 1) / workerCount;
+
+            for (size_t i = begin; i < end; i++)
+                function(i);
+        };
+
+        std::vector<std::future<void>> workers;
+        for (size_t worker = 1; worker < workerCount; worker++)
+            workers.push_back(std::async(std::launch::async, runBlock, worker));
+
+        runBlock(0);
+
+        for (auto &worker : workers)
+            worker.get();
+    }
+
+    // Calls function(i) for every i in [0, count), splitting the range into contiguous blocks across all hardware threads
+    template<typename Function>
+    void parallelFor(size_t count, Function &&function) {
+        parallelFor(count, std::thread::hardware_concurrency(), std::forward<Function>(function));
+    }
+
+}
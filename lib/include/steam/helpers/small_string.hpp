@@ -0,0 +1,180 @@
+#pragma once
+
+#include <steam.hpp>
+
+#include <compare>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <string_view>
+
+namespace steam {
+
+    // 16 byte string that stores up to 15 characters inline and longer strings in a separate heap allocation.
+    //
+    // The last byte of the storage holds the remaining inline capacity for inline strings, which makes it double
+    // as the null terminator of a string that uses up the full inline capacity, or HeapTag for heap strings.
+    // Heap strings store their pointer in the first 8 bytes and their length in the following 4 bytes.
+    // Values from ReservedTagStart upwards never occur in that byte and may be used by containers embedding a SmallString.
+    class SmallString {
+    public:
+        constexpr static size_t InlineCapacity = 15;
+        constexpr static u8 HeapTag = 0x80;
+        constexpr static u8 ReservedTagStart = 0xC0;
+
+        SmallString() noexcept {
+            this->assignInline({ });
+        }
+
+        SmallString(std::string_view string) {
+            this->assign(string);
+        }
+
+        SmallString(const std::string &string) : SmallString(std::string_view(string)) { }
+        SmallString(const char *string) : SmallString(std::string_view(string)) { }
+
+        SmallString(const SmallString &other) : SmallString(other.view()) { }
+
+        SmallString(SmallString &&other) noexcept {
+            std::memcpy(this->m_storage, other.m_storage, sizeof(this->m_storage));
+            other.assignInline({ });
+        }
+
+        ~SmallString() {
+            this->release();
+        }
+
+        SmallString& operator=(const SmallString &other) {
+            if (this != &other) {
+                this->release();
+                this->assign(other.view());
+            }
+
+            return *this;
+        }
+
+        SmallString& operator=(SmallString &&other) noexcept {
+            if (this != &other) {
+                this->release();
+
+                std::memcpy(this->m_storage, other.m_storage, sizeof(this->m_storage));
+                other.assignInline({ });
+            }
+
+            return *this;
+        }
+
+        [[nodiscard]]
+        bool isInline() const noexcept {
+            return this->getTag() != HeapTag;
+        }
+
+        [[nodiscard]]
+        const char* data() const noexcept {
+            if (this->isInline())
+                return this->m_storage;
+
+            const char *pointer;
+            std::memcpy(&pointer, this->m_storage, sizeof(pointer));
+
+            return pointer;
+        }
+
+        [[nodiscard]]
+        const char* c_str() const noexcept {
+            return this->data();
+        }
+
+        [[nodiscard]]
+        size_t size() const noexcept {
+            if (this->isInline())
+                return InlineCapacity - this->getTag();
+
+            u32 size;
+            std::memcpy(&size, this->m_storage + sizeof(char*), sizeof(size));
+
+            return size;
+        }
+
+        [[nodiscard]]
+        bool empty() const noexcept {
+            return this->size() == 0;
+        }
+
+        [[nodiscard]]
+        std::string_view view() const noexcept {
+            return { this->data(), this->size() };
+        }
+
+        [[nodiscard]]
+        std::string str() const {
+            return std::string(this->view());
+        }
+
+        operator std::string_view() const noexcept {
+            return this->view();
+        }
+
+        [[nodiscard]]
+        size_t getHeapSize() const noexcept {
+            return this->isInline() ? 0 : this->size() + 1;
+        }
+
+        friend bool operator==(const SmallString &lhs, const SmallString &rhs) noexcept { return lhs.view() == rhs.view(); }
+        friend bool operator==(const SmallString &lhs, std::string_view rhs) noexcept { return lhs.view() == rhs; }
+        friend bool operator==(const SmallString &lhs, const std::string &rhs) noexcept { return lhs.view() == rhs; }
+        friend bool operator==(const SmallString &lhs, const char *rhs) noexcept { return lhs.view() == rhs; }
+
+        friend std::strong_ordering operator<=>(const SmallString &lhs, const SmallString &rhs) noexcept { return lhs.view() <=> rhs.view(); }
+        friend std::strong_ordering operator<=>(const SmallString &lhs, std::string_view rhs) noexcept { return lhs.view() <=> rhs; }
+        friend std::strong_ordering operator<=>(const SmallString &lhs, const std::string &rhs) noexcept { return lhs.view() <=> std::string_view(rhs); }
+        friend std::strong_ordering operator<=>(const SmallString &lhs, const char *rhs) noexcept { return lhs.view() <=> std::string_view(rhs); }
+
+    private:
+        [[nodiscard]]
+        u8 getTag() const noexcept {
+            return static_cast<u8>(this->m_storage[InlineCapacity]);
+        }
+
+        void assignInline(std::string_view string) noexcept {
+            std::memset(this->m_storage, 0x00, sizeof(this->m_storage));
+            if (!string.empty())
+                std::memcpy(this->m_storage, string.data(), string.size());
+            this->m_storage[InlineCapacity] = static_cast<char>(InlineCapacity - string.size());
+        }
+
+        void assign(std::string_view string) {
+            if (string.size() <= InlineCapacity) {
+                this->assignInline(string);
+                return;
+            }
+
+            auto pointer = new char[string.size() + 1];
+            std::memcpy(pointer, string.data(), string.size());
+            pointer[string.size()] = 0x00;
+
+            const u32 size = string.size();
+            std::memcpy(this->m_storage, &pointer, sizeof(pointer));
+            std::memcpy(this->m_storage + sizeof(pointer), &size, sizeof(size));
+            this->m_storage[InlineCapacity] = static_cast<char>(HeapTag);
+        }
+
+        void release() noexcept {
+            if (!this->isInline())
+                delete[] this->data();
+        }
+
+    private:
+        alignas(8) char m_storage[InlineCapacity + 1];
+    };
+
+    static_assert(sizeof(SmallString) == 16);
+
+}
+
+template<>
+struct std::hash<steam::SmallString> {
+    size_t operator()(const steam::SmallString &string) const noexcept {
+        return std::hash<std::string_view>{}(string.view());
+    }
+};
@@ -1,12 +1,13 @@
 #pragma once
 
 #include <string>
+#include <string_view>
 
 namespace steam {
 
     template<typename ... Ts> struct overloaded : Ts... { using Ts::operator()...; };
     template<typename ... Ts> overloaded(Ts...) -> overloaded<Ts...>;
 
-    bool isIntegerString(std::string string);
+    bool isIntegerString(std::string_view string);
 
 }
\ No newline at end of file
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <steam.hpp>
+
+#include <chrono>
+#include <map>
+#include <set>
+#include <vector>
+
+#include <steam/helpers/fs.hpp>
+
+namespace steam::fs {
+
+    // inotify based watcher for individual files. The parent directories are watched instead of the files themselves
+    // so that files getting replaced through a rename, like Steam and writeFileAtomic do, are still being tracked.
+    class Watcher {
+    public:
+        Watcher() noexcept;
+        Watcher(const Watcher &) = delete;
+        Watcher(Watcher &&other) noexcept;
+
+        ~Watcher();
+
+        Watcher &operator=(Watcher &&other) noexcept;
+
+
+        [[nodiscard]] bool isValid() const {
+            return this->m_fd >= 0;
+        }
+
+        bool watchFile(const std::fs::path &path);
+        bool unwatchFile(const std::fs::path &path);
+
+        // Reports changes to any file directly inside of the directory, including subdirectories getting created or removed
+        bool watchDirectory(const std::fs::path &path);
+
+        // Waits up to timeout for the first change. Once something changed, events keep being collected until none
+        // arrived for the debounce duration so that a burst of writes to the same file is only reported once
+        [[nodiscard]] std::vector<std::fs::path> wait(std::chrono::milliseconds timeout, std::chrono::milliseconds debounce);
+
+        // Returns the files that changed since the last call without waiting for anything
+        [[nodiscard]] std::vector<std::fs::path> getChanges();
+
+        // Whether the kernel dropped events during the last wait() or getChanges() call because its queue overflowed.
+        // All watched files get reported as changed in that case, changes inside watched directories have to be found by listing them again
+        [[nodiscard]] bool hasOverflowed() const {
+            return this->m_overflowed;
+        }
+
+        auto getHandle() const { return this->m_fd; }
+
+        // Stops watching everything and releases the inotify instance, the watcher is invalid afterwards
+        void close();
+
+    private:
+        bool readEvents(std::set<std::fs::path> &changedFiles);
+
+    private:
+        int m_fd;
+        std::map<int, std::fs::path> m_directories;
+        std::set<std::fs::path> m_files;
+        std::set<std::fs::path> m_watchedDirectories;
+        bool m_overflowed = false;
+    };
+
+}
@@ -0,0 +1,47 @@
+#include <steam/api/appid.hpp>
+
+#include <steam/file_formats/shortcut_scanner.hpp>
+
+#include <steam/helpers/mapped_file.hpp>
+#include <steam/helpers/parallel.hpp>
+
+#include <thread>
+
+namespace steam::api {
+
+    std::vector<AppId> AppId::generate(std::span<const ShortcutSpec> shortcuts) {
+        // Hashing a single shortcut only takes a few dozen nanoseconds, so threads only pay off for whole libraries
+        constexpr static size_t ParallelThreshold = 16 * 1024;
+
+        const size_t workerCount = shortcuts.size() >= ParallelThreshold ? std::thread::hardware_concurrency() : 1;
+
+        std::vector<AppId> appIds(shortcuts.size());
+        parallelFor(shortcuts.size(), workerCount, [&](size_t i) {
+            appIds[i] = AppId(shortcuts[i].exePath, shortcuts[i].appName);
+        });
+
+        return appIds;
+    }
+
+    std::vector<AppId> AppId::getAppIds(const api::User &user) {
+        auto shortcutsFile = fs::MappedFile(fs::getSteamDirectory() / "userdata" / std::to_string(user.getId()) / "config" / "shortcuts.vdf");
+        if (!shortcutsFile.isValid())
+            return { };
+
+        // Query all app IDs from the list
+        std::vector<AppId> appIds;
+
+        ShortcutScanner scanner(shortcutsFile.getBytes());
+        while (auto shortcut = scanner.next()) {
+            if (shortcut->appId.has_value())
+                appIds.push_back(fromShortAppId(*shortcut->appId));
+        }
+
+        // Only part of a broken file could be scanned, so the list would be incomplete
+        if (!scanner.isValid())
+            return { };
+
+        return appIds;
+    }
+
+}
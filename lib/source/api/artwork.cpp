@@ -0,0 +1,307 @@
+#include <steam/api/artwork.hpp>
+
+#include <steam/file_formats/keyvalues.hpp>
+
+#include <steam/helpers/hash.hpp>
+#include <steam/helpers/mapped_file.hpp>
+#include <steam/helpers/net.hpp>
+#include <steam/helpers/parallel.hpp>
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace steam::api {
+
+    namespace {
+
+        constexpr static size_t MaxConcurrentDownloads = 8;
+
+        std::string_view getSuffix(ArtworkType type) {
+            switch (type) {
+                case ArtworkType::Grid: return "p";
+                case ArtworkType::Hero: return "_hero";
+                case ArtworkType::Logo: return "_logo";
+                case ArtworkType::Icon: return "_icon";
+            }
+
+            return { };
+        }
+
+        // Steam only displays PNG and JPEG images, anything else is most likely an error page anyway
+        std::optional<std::string_view> getImageExtension(std::span<const u8> data) {
+            constexpr static u8 PngMagic[]  = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+            constexpr static u8 JpegMagic[] = { 0xFF, 0xD8, 0xFF };
+
+            if (data.size() >= sizeof(PngMagic) && std::memcmp(data.data(), PngMagic, sizeof(PngMagic)) == 0)
+                return ".png";
+            if (data.size() >= sizeof(JpegMagic) && std::memcmp(data.data(), JpegMagic, sizeof(JpegMagic)) == 0)
+                return ".jpg";
+
+            return std::nullopt;
+        }
+
+        bool isUpToDate(const std::fs::path &cachedPath, const std::fs::path &destination) {
+            struct stat64 cachedStatus = { }, destinationStatus = { };
+            if (::stat64(cachedPath.c_str(), &cachedStatus) != 0 || ::stat64(destination.c_str(), &destinationStatus) != 0)
+                return false;
+
+            if (cachedStatus.st_dev == destinationStatus.st_dev && cachedStatus.st_ino == destinationStatus.st_ino)
+                return true;
+
+            // Copies made because hardlinking wasn't possible need their contents compared
+            if (cachedStatus.st_size != destinationStatus.st_size)
+                return false;
+
+            auto cachedFile = fs::MappedFile(cachedPath), destinationFile = fs::MappedFile(destination);
+            return cachedFile.isValid() && destinationFile.isValid() && std::ranges::equal(cachedFile.getBytes(), destinationFile.getBytes());
+        }
+
+        // Replaces the destination with a hardlink to the cached file, or a copy of it if the cache lives on a different file system
+        bool linkFile(const std::fs::path &cachedPath, const std::fs::path &destination) {
+            auto temporaryPath = destination;
+            temporaryPath += fmt::format(".{}.tmp", ::getpid());
+
+            fs::remove(temporaryPath);
+            if (::link(cachedPath.c_str(), temporaryPath.c_str()) != 0) {
+                if (errno != EXDEV && errno != EPERM && errno != EMLINK)
+                    return false;
+
+                auto file = fs::MappedFile(cachedPath);
+                return file.isValid() && fs::writeFileAtomic(destination, file.getBytes());
+            }
+
+            std::error_code error;
+            std::fs::rename(temporaryPath, destination, error);
+            if (error) {
+                fs::remove(temporaryPath);
+                return false;
+            }
+
+            return true;
+        }
+
+        constexpr static std::string_view LocalUrlPrefix = "file://";
+
+        bool isLocalUrl(std::string_view url) {
+            return url.starts_with(LocalUrlPrefix);
+        }
+
+        std::fs::path getDefaultCacheDirectory() {
+            if (auto cacheHome = std::getenv("XDG_CACHE_HOME"); cacheHome != nullptr && *cacheHome != '\0')
+                return std::fs::path(cacheHome) / "libsteam" / "artwork";
+
+            return fs::getHomeDirectory() / ".cache" / "libsteam" / "artwork";
+        }
+
+    }
+
+    ArtworkManager::ArtworkManager() : ArtworkManager(getDefaultCacheDirectory()) { }
+
+    ArtworkManager::ArtworkManager(std::fs::path cacheDirectory) : m_cacheDirectory(std::move(cacheDirectory)) { }
+
+    std::fs::path ArtworkManager::getGridPath(const User &user, const AppId &appId, ArtworkType type, std::string_view extension) {
+        return fs::getSteamDirectory() / "userdata" / std::to_string(user.getId()) / "config" / "grid" / fmt::format("{}{}{}", getArtworkId(appId), getSuffix(type), extension);
+    }
+
+    void ArtworkManager::loadIndex() {
+        if (this->m_indexLoaded)
+            return;
+
+        this->m_indexLoaded = true;
+
+        auto file = fs::MappedFile(this->m_cacheDirectory / "index.vdf");
+        if (!file.isValid() || !KeyValues::validate(file.getString()))
+            return;
+
+        const auto index = KeyValues(file.getString());
+        auto urls = index.get().find("urls");
+        if (urls == index.get().end() || !urls->second.isSet())
+            return;
+
+        for (const auto &[url, fileName] : urls->second.set()) {
+            if (fileName.isString())
+                this->m_urls.emplace(url.view(), fileName.string());
+        }
+    }
+
+    bool ArtworkManager::saveIndex() const {
+        KeyValues index;
+        KeyValues::Set urls;
+        for (const auto &[url, fileName] : this->m_urls)
+            urls[url] = fileName;
+
+        index["urls"] = std::move(urls);
+
+        return fs::writeFileAtomic(this->m_cacheDirectory / "index.vdf", index.dump());
+    }
+
+    std::optional<std::fs::path> ArtworkManager::findCached(const std::string &url) const {
+        auto it = this->m_urls.find(url);
+        if (it == this->m_urls.end())
+            return std::nullopt;
+
+        // The cache may have been cleaned up in the meantime
+        auto path = this->m_cacheDirectory / it->second;
+        if (!fs::isRegularFile(path))
+            return std::nullopt;
+
+        return path;
+    }
+
+    std::optional<std::fs::path> ArtworkManager::download(const std::string &url, const std::fs::path &temporaryPath) const {
+        // Local files get copied into the cache just like downloaded ones so they can be deduplicated and linked the same way.
+        // Linking them instead would let whoever owns the file modify the cached content
+        if (isLocalUrl(url)) {
+            auto file = fs::MappedFile(std::fs::path(url.substr(LocalUrlPrefix.size())));
+            if (!file.isValid() || !fs::writeFileAtomic(temporaryPath, file.getBytes()))
+                return std::nullopt;
+
+            if (auto path = this->store(temporaryPath); path.has_value())
+                return path;
+
+            fs::remove(temporaryPath);
+            return std::nullopt;
+        }
+
+        Net net;
+        auto response = net.downloadFile(url, temporaryPath, Net::DefaultTimeout).get();
+
+        if (response.code == 200) {
+            if (auto path = this->store(temporaryPath); path.has_value())
+                return path;
+        }
+
+        fs::remove(temporaryPath);
+
+        return std::nullopt;
+    }
+
+    std::optional<std::fs::path> ArtworkManager::store(const std::fs::path &temporaryPath) const {
+        auto file = fs::MappedFile(temporaryPath);
+        if (!file.isValid())
+            return std::nullopt;
+
+        const auto data = file.getBytes();
+        const auto extension = getImageExtension(data);
+        if (!extension.has_value())
+            return std::nullopt;
+
+        // Two independent checksums and the size make an accidental collision practically impossible, but make sure anyway
+        const auto hash = fmt::format("{:08x}{:08x}{:x}", crc32(data), crc32<0x82F63B78>(data), data.size());
+        for (u32 attempt = 0; ; attempt++) {
+            auto path = this->m_cacheDirectory / (attempt == 0 ? fmt::format("{}{}", hash, *extension) : fmt::format("{}-{}{}", hash, attempt, *extension));
+
+            if (!fs::exists(path)) {
+                std::error_code error;
+                std::fs::rename(temporaryPath, path, error);
+                if (error)
+                    return std::nullopt;
+
+                return path;
+            }
+
+            auto existing = fs::MappedFile(path);
+            if (existing.isValid() && std::ranges::equal(existing.getBytes(), data)) {
+                fs::remove(temporaryPath);
+                return path;
+            }
+        }
+    }
+
+    std::vector<std::optional<std::fs::path>> ArtworkManager::fetch(std::span<const ArtworkRequest> requests) {
+        std::scoped_lock lock(this->m_mutex);
+
+        std::vector<std::optional<std::fs::path>> result(requests.size());
+        if (!fs::isDirectory(this->m_cacheDirectory) && !fs::createDirectories(this->m_cacheDirectory))
+            return result;
+
+        this->loadIndex();
+
+        // Download every URL only once, no matter how many apps use it. Local files may have changed since, they're always imported again
+        std::vector<std::string> missingUrls;
+        for (const auto &request : requests) {
+            if (request.url.empty() || (!isLocalUrl(request.url) && this->findCached(request.url).has_value()))
+                continue;
+
+            if (std::ranges::find(missingUrls, request.url) == missingUrls.end())
+                missingUrls.push_back(request.url);
+        }
+
+        // curl initializes itself on first use otherwise, which isn't safe to happen on several threads at once
+        static std::once_flag curlInitialized;
+        if (std::ranges::any_of(missingUrls, [](const auto &url) { return !isLocalUrl(url); }))
+            std::call_once(curlInitialized, Net::init);
+
+        std::vector<std::optional<std::fs::path>> downloads(missingUrls.size());
+        parallelFor(missingUrls.size(), MaxConcurrentDownloads, [&](size_t i) {
+            downloads[i] = this->download(missingUrls[i], this->m_cacheDirectory / fmt::format(".download-{}-{}", ::getpid(), i));
+        });
+
+        std::map<std::string_view, std::fs::path> localFiles;
+        bool indexChanged = false;
+        for (size_t i = 0; i < missingUrls.size(); i++) {
+            if (!downloads[i].has_value())
+                continue;
+
+            if (isLocalUrl(missingUrls[i])) {
+                localFiles.emplace(missingUrls[i], std::move(*downloads[i]));
+            } else {
+                this->m_urls[missingUrls[i]] = downloads[i]->filename().string();
+                indexChanged = true;
+            }
+        }
+
+        if (indexChanged)
+            this->saveIndex();
+
+        for (size_t i = 0; i < requests.size(); i++) {
+            if (auto it = localFiles.find(requests[i].url); it != localFiles.end())
+                result[i] = it->second;
+            else if (!isLocalUrl(requests[i].url))
+                result[i] = this->findCached(requests[i].url);
+        }
+
+        return result;
+    }
+
+    bool ArtworkManager::apply(std::span<const ArtworkRequest> requests, std::span<const User> users) {
+        const auto cachedFiles = this->fetch(requests);
+
+        bool success = true;
+        for (const auto &user : users) {
+            for (size_t i = 0; i < requests.size(); i++) {
+                const auto &cachedFile = cachedFiles[i];
+                if (!cachedFile.has_value()) {
+                    success = false;
+                    continue;
+                }
+
+                const auto extension   = cachedFile->extension().string();
+                const auto destination = getGridPath(user, requests[i].appId, requests[i].type, extension);
+
+                if (isUpToDate(*cachedFile, destination))
+                    continue;
+
+                // Steam would keep showing an older image that was stored with the other extension
+                fs::remove(getGridPath(user, requests[i].appId, requests[i].type, extension == ".png" ? ".jpg" : ".png"));
+
+                if (!fs::isDirectory(destination.parent_path()) && !fs::createDirectories(destination.parent_path())) {
+                    success = false;
+                    continue;
+                }
+
+                if (!linkFile(*cachedFile, destination))
+                    success = false;
+            }
+        }
+
+        return success;
+    }
+
+}
@@ -0,0 +1,283 @@
+#include <steam/api/artwork_resolver.hpp>
+
+#include <algorithm>
+#include <charconv>
+#include <set>
+
+namespace steam::api {
+
+    namespace {
+
+        struct NamePattern {
+            std::string_view suffix;
+            ArtworkType type;
+        };
+
+        // <appid>p.png and friends, the names ArtworkManager::getGridPath uses
+        constexpr static NamePattern GridPatterns[] = {
+            { "p",     ArtworkType::Grid },
+            { "_hero", ArtworkType::Hero },
+            { "_logo", ArtworkType::Logo },
+            { "_icon", ArtworkType::Icon },
+        };
+
+        // Older Steam versions put everything directly into librarycache as <appid>_library_600x900.jpg etc.
+        constexpr static NamePattern LibraryCachePatterns[] = {
+            { "_library_600x900",    ArtworkType::Grid },
+            { "_library_600x900_2x", ArtworkType::Grid },
+            { "_library_hero",       ArtworkType::Hero },
+            { "_logo",               ArtworkType::Logo },
+            { "_icon",               ArtworkType::Icon },
+        };
+
+        // Newer ones use a folder per app, with the icon named after its hash
+        constexpr static NamePattern LibraryCacheAppPatterns[] = {
+            { "library_600x900",    ArtworkType::Grid },
+            { "library_600x900_2x", ArtworkType::Grid },
+            { "library_hero",       ArtworkType::Hero },
+            { "logo",               ArtworkType::Logo },
+        };
+
+        std::optional<u32> parseId(std::string_view string) {
+            u32 id = 0;
+            auto [end, error] = std::from_chars(string.data(), string.data() + string.size(), id);
+            if (error != std::errc() || end != string.data() + string.size())
+                return std::nullopt;
+
+            return id;
+        }
+
+        // Splits "<id><suffix>" into the id and the part following it
+        std::optional<std::pair<u32, std::string_view>> splitId(std::string_view stem) {
+            const auto digits = std::ranges::find_if_not(stem, [](char c) { return c >= '0' && c <= '9'; }) - stem.begin();
+
+            auto id = parseId(stem.substr(0, digits));
+            if (!id.has_value())
+                return std::nullopt;
+
+            return std::pair { *id, stem.substr(digits) };
+        }
+
+        std::optional<ArtworkType> matchPattern(std::span<const NamePattern> patterns, std::string_view suffix) {
+            for (const auto &pattern : patterns) {
+                if (pattern.suffix == suffix)
+                    return pattern.type;
+            }
+
+            return std::nullopt;
+        }
+
+        bool isImage(const std::fs::path &path) {
+            const auto extension = path.extension().native();
+
+            return extension == ".png" || extension == ".jpg" || extension == ".jpeg";
+        }
+
+        bool isHash(std::string_view string) {
+            return string.size() == 40 && std::ranges::all_of(string, [](char c) { return (c >= '0' && c <= '9') || (c >= 'a' && c <= 'f'); });
+        }
+
+        u64 getLookupKey(u32 id, ArtworkType type) {
+            return (u64(id) << 8) | u64(type);
+        }
+
+    }
+
+    ArtworkResolver::ArtworkResolver() : ArtworkResolver(fs::getSteamDirectory()) { }
+
+    ArtworkResolver::ArtworkResolver(std::fs::path steamDirectory) : m_steamDirectory(std::move(steamDirectory)) { }
+
+    void ArtworkResolver::addDirectory(const std::fs::path &path, DirectoryKind kind, u32 appId) {
+        if (this->m_directories.contains(path) || !fs::isDirectory(path))
+            return;
+
+        // Start watching before listing the directory so no change in between gets lost
+        this->m_watcher.watchDirectory(path);
+
+        auto &directory = this->m_directories[path];
+        directory.kind  = kind;
+        directory.appId = appId;
+
+        this->scanDirectory(path, directory);
+    }
+
+    void ArtworkResolver::scanDirectory(const std::fs::path &path, Directory &directory) {
+        directory.artwork.clear();
+
+        std::error_code error;
+        for (const auto &entry : std::fs::directory_iterator(path, error)) {
+            const auto &entryPath = entry.path();
+            const auto fileName   = entryPath.filename().native();
+            const auto stem       = entryPath.stem().native();
+
+            switch (directory.kind) {
+                case DirectoryKind::LibraryCache:
+                    if (auto id = parseId(fileName); id.has_value()) {
+                        this->addDirectory(entryPath, DirectoryKind::LibraryCacheApp, *id);
+                    } else if (auto split = splitId(stem); split.has_value() && isImage(entryPath)) {
+                        if (auto type = matchPattern(LibraryCachePatterns, split->second); type.has_value())
+                            directory.artwork.push_back({ split->first, *type, entryPath });
+                    }
+                    break;
+                case DirectoryKind::LibraryCacheApp:
+                    if (!isImage(entryPath))
+                        break;
+
+                    if (auto type = matchPattern(LibraryCacheAppPatterns, stem); type.has_value())
+                        directory.artwork.push_back({ directory.appId, *type, entryPath });
+                    else if (isHash(stem))
+                        directory.artwork.push_back({ directory.appId, ArtworkType::Icon, entryPath });
+                    break;
+                case DirectoryKind::UserData:
+                    if (parseId(fileName).has_value())
+                        this->addDirectory(entryPath / "config", DirectoryKind::UserConfig);
+                    break;
+                case DirectoryKind::UserConfig:
+                    // The grid folder only gets created once a user sets their first custom artwork
+                    if (fileName == "grid")
+                        this->addDirectory(entryPath, DirectoryKind::Grid);
+                    break;
+                case DirectoryKind::Grid:
+                    if (auto split = splitId(stem); split.has_value() && isImage(entryPath)) {
+                        if (auto type = matchPattern(GridPatterns, split->second); type.has_value())
+                            directory.artwork.push_back({ split->first, *type, entryPath });
+                    }
+                    break;
+            }
+        }
+    }
+
+    void ArtworkResolver::rebuildLookup() {
+        this->m_lookup.clear();
+
+        // Artwork users picked themselves goes first, whatever Steam downloaded only fills the gaps
+        for (const bool grids : { true, false }) {
+            for (const auto &[path, directory] : this->m_directories) {
+                if ((directory.kind == DirectoryKind::Grid) != grids)
+                    continue;
+
+                for (const auto &artwork : directory.artwork)
+                    this->m_lookup.try_emplace(getLookupKey(artwork.id, artwork.type), artwork.path);
+            }
+        }
+    }
+
+    bool ArtworkResolver::refresh() {
+        std::scoped_lock lock(this->m_mutex);
+
+        return this->rescan();
+    }
+
+    bool ArtworkResolver::rescan() {
+        this->m_watcher = fs::Watcher();
+        this->m_directories.clear();
+
+        const auto libraryCache = this->m_steamDirectory / "appcache" / "librarycache";
+        const auto userData     = this->m_steamDirectory / "userdata";
+
+        this->addDirectory(libraryCache, DirectoryKind::LibraryCache);
+        this->addDirectory(userData, DirectoryKind::UserData);
+
+        this->rebuildLookup();
+
+        return this->m_directories.contains(libraryCache) || this->m_directories.contains(userData);
+    }
+
+    void ArtworkResolver::processChanges() {
+        const auto changes = this->m_watcher.getChanges();
+        if (changes.empty() && !this->m_watcher.hasOverflowed())
+            return;
+
+        // Lost events could have been about any of the directories, so there's no way around listing all of them again
+        if (this->m_watcher.hasOverflowed()) {
+            this->rescan();
+            return;
+        }
+
+        std::set<std::fs::path> changedDirectories;
+        for (const auto &path : changes) {
+            // inotify drops the watch of removed directories by itself
+            if (this->m_directories.contains(path) && !fs::isDirectory(path))
+                this->m_directories.erase(path);
+
+            if (this->m_directories.contains(path.parent_path()))
+                changedDirectories.insert(path.parent_path());
+        }
+
+        for (const auto &path : changedDirectories) {
+            if (auto it = this->m_directories.find(path); it != this->m_directories.end())
+                this->scanDirectory(path, it->second);
+        }
+
+        this->rebuildLookup();
+    }
+
+    void ArtworkResolver::update() {
+        std::scoped_lock lock(this->m_mutex);
+
+        this->processChanges();
+    }
+
+    std::optional<std::fs::path> ArtworkResolver::find(const AppId &appId, ArtworkType type) {
+        std::scoped_lock lock(this->m_mutex);
+
+        this->processChanges();
+
+        auto it = this->m_lookup.find(getLookupKey(getArtworkId(appId), type));
+        if (it == this->m_lookup.end())
+            return std::nullopt;
+
+        return it->second;
+    }
+
+    std::vector<ArtworkRequest> ArtworkResolver::resolve(std::span<const AppId> appIds, std::span<const ArtworkType> types, SteamGridDBAPI &steamGridDB, const std::unordered_map<u64, AppId> &gameIds) {
+        std::vector<ArtworkRequest> requests;
+        std::vector<std::pair<AppId, ArtworkType>> missing;
+
+        {
+            std::scoped_lock lock(this->m_mutex);
+
+            this->processChanges();
+
+            for (const auto &appId : appIds) {
+                for (const auto type : types) {
+                    if (auto it = this->m_lookup.find(getLookupKey(getArtworkId(appId), type)); it != this->m_lookup.end())
+                        requests.push_back({ appId, type, "file://" + it->second.string() });
+                    else
+                        missing.emplace_back(appId, type);
+                }
+            }
+        }
+
+        // SteamGridDBAPI handles one request at a time anyway, there's nothing to gain from queueing them all up at once
+        for (const auto &[appId, type] : missing) {
+            AppId gameId;
+            auto idType = SteamGridDBAPI::IdType::SteamGridDB;
+
+            if (auto it = gameIds.find(appId.getAppId()); it != gameIds.end()) {
+                gameId = it->second;
+            } else if (appId.getShortAppId() == 0) {
+                gameId = appId;
+                idType = SteamGridDBAPI::IdType::Steam;
+            } else {
+                continue;
+            }
+
+            std::future<std::vector<SteamGridDBAPI::ImageResult>> images;
+            switch (type) {
+                case ArtworkType::Grid: images = steamGridDB.getGrids(gameId, idType);  break;
+                case ArtworkType::Hero: images = steamGridDB.getHeroes(gameId, idType); break;
+                case ArtworkType::Logo: images = steamGridDB.getLogos(gameId, idType);  break;
+                case ArtworkType::Icon: images = steamGridDB.getIcons(gameId, idType);  break;
+            }
+
+            const auto results = images.get();
+            auto best = std::ranges::max_element(results, { }, &SteamGridDBAPI::ImageResult::score);
+            if (best != results.end())
+                requests.push_back({ appId, type, best->url });
+        }
+
+        return requests;
+    }
+
+}
@@ -0,0 +1,203 @@
+#include <steam/api/library_index.hpp>
+
+#include <steam/file_formats/keyvalues.hpp>
+
+#include <steam/helpers/batch_loader.hpp>
+#include <steam/helpers/mapped_file.hpp>
+#include <steam/helpers/parallel.hpp>
+#include <steam/helpers/utils.hpp>
+
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+
+#include <sys/stat.h>
+
+namespace steam::api {
+
+    namespace {
+
+        template<typename T>
+        bool parseInteger(std::string_view string, T &result) {
+            auto [end, error] = std::from_chars(string.data(), string.data() + string.size(), result);
+
+            return error == std::errc() && end == string.data() + string.size();
+        }
+
+        // Older Steam versions wrote the root keys with different capitalization
+        const KeyValues::Value* findIgnoreCase(const KeyValues::Set &set, std::string_view key) {
+            for (const auto &[name, value] : set) {
+                if (std::ranges::equal(name.view(), key, [](char a, char b) { return std::tolower(u8(a)) == std::tolower(u8(b)); }))
+                    return &value;
+            }
+
+            return nullptr;
+        }
+
+        std::optional<InstalledGame> parseManifest(const fs::LoadedFile &file) {
+            if (!file.isValid() || !KeyValues::validate(file.getString()))
+                return std::nullopt;
+
+            const auto manifest = KeyValues(file.getString());
+
+            auto appState = findIgnoreCase(manifest.get(), "AppState");
+            if (appState == nullptr || !appState->isSet())
+                return std::nullopt;
+
+            auto field = [&fields = appState->set()](std::string_view name) -> std::string_view {
+                auto value = findIgnoreCase(fields, name);
+                if (value == nullptr || !value->isString())
+                    return { };
+
+                return value->string();
+            };
+
+            InstalledGame game;
+            if (!parseInteger(field("appid"), game.appId))
+                return std::nullopt;
+
+            game.name       = field("name");
+            game.installDir = field("installdir");
+            game.library    = file.path.parent_path().parent_path();
+            parseInteger(field("SizeOnDisk"), game.sizeOnDisk);
+            parseInteger(field("StateFlags"), game.stateFlags);
+
+            return game;
+        }
+
+    }
+
+    LibraryIndex::LibraryIndex() : LibraryIndex(fs::getSteamDirectory()) { }
+
+    LibraryIndex::LibraryIndex(std::fs::path steamDirectory) : m_steamDirectory(std::move(steamDirectory)) { }
+
+    std::vector<std::fs::path> LibraryIndex::queryLibraries() const {
+        std::vector<std::fs::path> libraries = { this->m_steamDirectory };
+
+        auto file = fs::MappedFile(this->m_steamDirectory / "steamapps" / "libraryfolders.vdf");
+        if (file.isValid() && KeyValues::validate(file.getString())) {
+            const auto libraryFolders = KeyValues(file.getString());
+
+            auto folders = findIgnoreCase(libraryFolders.get(), "libraryfolders");
+            if (folders != nullptr && folders->isSet()) {
+                for (const auto &[key, value] : folders->set()) {
+                    if (!isIntegerString(key))
+                        continue;
+
+                    // Older versions list the bare path, newer ones a set with the path and some statistics
+                    if (value.isString()) {
+                        libraries.emplace_back(value.string());
+                    } else if (value.isSet()) {
+                        auto path = findIgnoreCase(value.set(), "path");
+                        if (path != nullptr && path->isString())
+                            libraries.emplace_back(path->string());
+                    }
+                }
+            }
+        }
+
+        // The Steam directory itself is usually listed as well, just through a different path
+        std::vector<std::fs::path> result;
+        std::vector<std::fs::path> canonicalPaths;
+        for (const auto &library : libraries) {
+            std::error_code error;
+            auto canonicalPath = std::fs::weakly_canonical(library, error);
+            if (error)
+                canonicalPath = library;
+
+            if (std::ranges::find(canonicalPaths, canonicalPath) != canonicalPaths.end())
+                continue;
+
+            canonicalPaths.push_back(canonicalPath);
+            result.push_back(library);
+        }
+
+        return result;
+    }
+
+    bool LibraryIndex::refresh() {
+        if (!fs::isDirectory(this->m_steamDirectory / "steamapps"))
+            return false;
+
+        auto libraries = this->queryLibraries();
+
+        std::map<std::fs::path, ManifestState> manifests;
+        for (const auto &library : libraries) {
+            std::error_code error;
+            for (const auto &entry : std::fs::directory_iterator(library / "steamapps", error)) {
+                const auto fileName = entry.path().filename().native();
+                if (!fileName.starts_with("appmanifest_") || !fileName.ends_with(".acf"))
+                    continue;
+
+                struct stat64 status = { };
+                if (::stat64(entry.path().c_str(), &status) != 0 || !S_ISREG(status.st_mode))
+                    continue;
+
+                manifests.emplace(entry.path(), ManifestState {
+                    .size             = u64(status.st_size),
+                    .modificationTime = status.st_mtim.tv_sec * 1'000'000'000 + status.st_mtim.tv_nsec
+                });
+            }
+        }
+
+        // Find manifests that need to be parsed again
+        std::vector<std::fs::path> changedManifests;
+        for (auto &[path, state] : manifests) {
+            auto previous = this->m_manifests.find(path);
+            if (previous != this->m_manifests.end() && previous->second.size == state.size && previous->second.modificationTime == state.modificationTime)
+                state.appId = previous->second.appId;
+            else
+                changedManifests.push_back(path);
+        }
+
+        // Games of removed manifests are dropped right away, the ones of changed manifests only once they parsed again
+        for (const auto &[path, state] : this->m_manifests) {
+            if (!manifests.contains(path))
+                this->m_games.erase(*state.appId);
+        }
+
+        const auto files = fs::loadFiles(changedManifests);
+
+        std::vector<std::optional<InstalledGame>> games(files.size());
+        parallelFor(files.size(), [&](size_t i) {
+            games[i] = parseManifest(files[i]);
+        });
+
+        for (size_t i = 0; i < games.size(); i++) {
+            auto previous = this->m_manifests.find(changedManifests[i]);
+
+            // Manifests that are in the middle of getting written keep their previous game and state, so they're parsed
+            // again on the next refresh
+            if (!games[i].has_value()) {
+                if (previous != this->m_manifests.end())
+                    manifests[changedManifests[i]] = previous->second;
+                else
+                    manifests.erase(changedManifests[i]);
+            } else if (previous != this->m_manifests.end() && previous->second.appId != games[i]->appId) {
+                this->m_games.erase(*previous->second.appId);
+            }
+        }
+
+        for (size_t i = 0; i < games.size(); i++) {
+            if (!games[i].has_value())
+                continue;
+
+            manifests[changedManifests[i]].appId = games[i]->appId;
+            this->m_games.insert_or_assign(games[i]->appId, std::move(*games[i]));
+        }
+
+        this->m_manifests = std::move(manifests);
+        this->m_libraries = std::move(libraries);
+
+        return true;
+    }
+
+    const InstalledGame* LibraryIndex::find(u32 appId) const {
+        auto it = this->m_games.find(appId);
+        if (it == this->m_games.end())
+            return nullptr;
+
+        return &it->second;
+    }
+
+}
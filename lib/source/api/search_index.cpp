@@ -0,0 +1,417 @@
+#include <steam/api/search_index.hpp>
+
+#include <algorithm>
+#include <cctype>
+#include <map>
+#include <mutex>
+
+namespace steam::api {
+
+    namespace {
+
+        // Lowercases the text and turns everything that isn't part of a word into a single space
+        std::string normalize(std::string_view text) {
+            std::string result;
+            result.reserve(text.size());
+
+            for (const char c : text) {
+                const auto byte = u8(c);
+                if (std::isalnum(byte) || byte >= 0x80)
+                    result += char(std::tolower(byte));
+                else if (!result.empty() && result.back() != ' ')
+                    result += ' ';
+            }
+
+            if (!result.empty() && result.back() == ' ')
+                result.pop_back();
+
+            return result;
+        }
+
+        constexpr u32 packTrigram(char a, char b, char c) {
+            return (u32(u8(a)) << 16) | (u32(u8(b)) << 8) | u32(u8(c));
+        }
+
+        template<typename Function>
+        void forEachWord(std::string_view text, Function &&function) {
+            size_t start = 0;
+            while (start < text.size()) {
+                auto end = text.find(' ', start);
+                if (end == std::string_view::npos)
+                    end = text.size();
+
+                if (end > start)
+                    function(text.substr(start, end - start));
+
+                start = end + 1;
+            }
+        }
+
+        enum PostingFlags : u32 {
+            InName      = 0b01,
+            AtNameStart = 0b10,
+            FlagBits    = 2
+        };
+
+        // Words are padded with a space on both sides so matches at their start and end weigh more. The first letter
+        // gets a trigram of its own so single letter queries still find words starting with it
+        void addTrigrams(std::string_view text, u32 flags, std::map<u32, u32> &trigrams) {
+            bool firstWord = true;
+
+            forEachWord(text, [&](std::string_view word) {
+                const u32 startFlags = firstWord && (flags & InName) ? flags | AtNameStart : flags;
+                firstWord = false;
+
+                trigrams[packTrigram(' ', word[0], '\0')] |= startFlags;
+
+                const auto padded = " " + std::string(word) + " ";
+                for (size_t i = 0; i + 3 <= padded.size(); i++)
+                    trigrams[packTrigram(padded[i], padded[i + 1], padded[i + 2])] |= i == 0 ? startFlags : flags;
+            });
+        }
+
+        std::optional<u32> getFirstTrigram(std::string_view word) {
+            if (word.empty())
+                return std::nullopt;
+            if (word.size() == 1)
+                return packTrigram(' ', word[0], '\0');
+
+            return packTrigram(' ', word[0], word[1]);
+        }
+
+        // The last word of a query is usually still being typed, so only its start is padded
+        std::vector<u32> getQueryTrigrams(std::string_view query) {
+            std::vector<u32> trigrams;
+
+            forEachWord(query, [&](std::string_view word) {
+                if (word.size() == 1) {
+                    trigrams.push_back(packTrigram(' ', word[0], '\0'));
+                    return;
+                }
+
+                const auto padded = " " + std::string(word);
+                for (size_t i = 0; i + 3 <= padded.size(); i++)
+                    trigrams.push_back(packTrigram(padded[i], padded[i + 1], padded[i + 2]));
+            });
+
+            std::ranges::sort(trigrams);
+            trigrams.erase(std::unique(trigrams.begin(), trigrams.end()), trigrams.end());
+
+            return trigrams;
+        }
+
+        // Older Steam versions wrote some of the shortcut fields in lowercase
+        const VDF::Value* findIgnoreCase(const VDF::Set &set, std::string_view key) {
+            for (const auto &[name, value] : set) {
+                if (std::ranges::equal(name.view(), key, [](char a, char b) { return std::tolower(u8(a)) == std::tolower(u8(b)); }))
+                    return &value;
+            }
+
+            return nullptr;
+        }
+
+        // Steam quotes the paths of shortcuts so ones containing spaces can be launched
+        std::string unquote(std::string string) {
+            if (string.size() >= 2 && string.front() == '"' && string.back() == '"')
+                return string.substr(1, string.size() - 2);
+
+            return string;
+        }
+
+        std::optional<SearchEntry> createShortcutEntry(u32 userId, const VDF::Value &shortcut) {
+            if (!shortcut.isSet())
+                return std::nullopt;
+
+            const auto &fields = shortcut.set();
+
+            auto appId = findIgnoreCase(fields, "appid");
+            if (appId == nullptr || !appId->isInteger())
+                return std::nullopt;
+
+            auto string = [&](std::string_view name) -> std::string {
+                auto value = findIgnoreCase(fields, name);
+                if (value == nullptr || !value->isString())
+                    return { };
+
+                return std::string(value->string());
+            };
+
+            SearchEntry entry = {
+                .source = SearchEntry::Source::Shortcut,
+                .appId  = AppId::fromShortAppId(appId->integer()),
+                .userId = userId,
+                .name   = string("AppName"),
+                .tags   = { },
+                .exe    = unquote(string("Exe"))
+            };
+
+            if (auto tags = findIgnoreCase(fields, "tags"); tags != nullptr && tags->isSet()) {
+                for (const auto &[key, tag] : tags->set()) {
+                    if (tag.isString())
+                        entry.tags.emplace_back(tag.string());
+                }
+            }
+
+            return entry;
+        }
+
+    }
+
+    SearchIndex::~SearchIndex() {
+        for (const auto &[store, id] : this->m_subscriptions)
+            store->unsubscribe(id);
+    }
+
+    void SearchIndex::insert(SearchEntry entry) {
+        const EntryKey key = { entry.source, entry.userId, entry.appId.getAppId() };
+        this->erase(key);
+
+        const auto name = normalize(entry.name);
+
+        std::map<u32, u32> trigrams;
+        addTrigrams(name, InName, trigrams);
+        // Only the file name says anything about the game, the folders leading to it are mostly the same for every game
+        addTrigrams(normalize(std::fs::path(entry.exe).filename().native()), 0, trigrams);
+        for (const auto &tag : entry.tags)
+            addTrigrams(normalize(tag), 0, trigrams);
+
+        u32 id;
+        if (!this->m_freeIds.empty()) {
+            id = this->m_freeIds.back();
+            this->m_freeIds.pop_back();
+        } else {
+            id = u32(this->m_documents.size());
+            this->m_documents.emplace_back();
+            this->m_nameLengths.emplace_back();
+        }
+
+        Document document;
+        for (const auto &[trigram, flags] : trigrams) {
+            auto &posting = this->m_postings[trigram];
+            const u32 value = (id << FlagBits) | flags;
+            posting.insert(std::ranges::upper_bound(posting, value), value);
+
+            document.trigrams.push_back(trigram);
+        }
+
+        document.entry = std::move(entry);
+
+        this->m_documents[id]   = std::move(document);
+        this->m_nameLengths[id] = u16(std::min<size_t>(name.size(), 0xFFFF));
+        this->m_keys.emplace(key, id);
+    }
+
+    bool SearchIndex::erase(const EntryKey &key) {
+        auto it = this->m_keys.find(key);
+        if (it == this->m_keys.end())
+            return false;
+
+        const auto id = it->second;
+        for (const auto trigram : this->m_documents[id]->trigrams) {
+            auto posting = this->m_postings.find(trigram);
+            if (posting == this->m_postings.end())
+                continue;
+
+            auto &ids = posting->second;
+            if (auto position = std::ranges::lower_bound(ids, id << FlagBits); position != ids.end() && (*position >> FlagBits) == id)
+                ids.erase(position);
+
+            if (ids.empty())
+                this->m_postings.erase(posting);
+        }
+
+        this->m_documents[id].reset();
+        this->m_freeIds.push_back(id);
+        this->m_keys.erase(it);
+
+        return true;
+    }
+
+    void SearchIndex::add(SearchEntry entry) {
+        std::unique_lock lock(this->m_mutex);
+
+        this->insert(std::move(entry));
+    }
+
+    bool SearchIndex::remove(SearchEntry::Source source, u32 userId, const AppId &appId) {
+        std::unique_lock lock(this->m_mutex);
+
+        return this->erase({ source, userId, appId.getAppId() });
+    }
+
+    void SearchIndex::addShortcuts(u32 userId, const VDF &shortcuts) {
+        std::unique_lock lock(this->m_mutex);
+
+        std::vector<EntryKey> previous;
+        for (auto it = this->m_keys.lower_bound({ SearchEntry::Source::Shortcut, userId, 0 }); it != this->m_keys.end() && std::get<0>(it->first) == SearchEntry::Source::Shortcut && std::get<1>(it->first) == userId; ++it)
+            previous.push_back(it->first);
+
+        for (const auto &key : previous)
+            this->erase(key);
+
+        auto shortcutsList = shortcuts.get().find("shortcuts");
+        if (shortcutsList == shortcuts.get().end() || !shortcutsList->second.isSet())
+            return;
+
+        for (const auto &[key, shortcut] : shortcutsList->second.set()) {
+            if (auto entry = createShortcutEntry(userId, shortcut); entry.has_value())
+                this->insert(std::move(*entry));
+        }
+    }
+
+    void SearchIndex::addInstalledGames(const LibraryIndex &libraryIndex) {
+        std::unique_lock lock(this->m_mutex);
+
+        std::vector<EntryKey> previous;
+        for (auto it = this->m_keys.lower_bound({ SearchEntry::Source::InstalledGame, 0, 0 }); it != this->m_keys.end() && std::get<0>(it->first) == SearchEntry::Source::InstalledGame; ++it)
+            previous.push_back(it->first);
+
+        for (const auto &key : previous)
+            this->erase(key);
+
+        // Only the folder name is indexed, the library's path is the same for most games and would make them all match it
+        for (const auto &[appId, game] : libraryIndex.getGames()) {
+            this->insert({
+                .source = SearchEntry::Source::InstalledGame,
+                .appId  = AppId(appId),
+                .userId = 0,
+                .name   = game.name,
+                .tags   = { },
+                .exe    = game.installDir
+            });
+        }
+    }
+
+    void SearchIndex::applyChanges(u32 userId, const std::vector<ShortcutsStore::Change> &changes) {
+        std::unique_lock lock(this->m_mutex);
+
+        for (const auto &change : changes) {
+            if (change.kind == ShortcutsStore::Change::Kind::Removed) {
+                this->erase({ SearchEntry::Source::Shortcut, userId, change.appId.getAppId() });
+            } else if (change.shortcut.has_value()) {
+                if (auto entry = createShortcutEntry(userId, *change.shortcut); entry.has_value())
+                    this->insert(std::move(*entry));
+            }
+        }
+    }
+
+    bool SearchIndex::watch(const User &user) {
+        auto &store = ShortcutsStore::get(user);
+        const auto userId = user.getId();
+
+        // Subscribe first so nothing that happens while the current shortcuts get indexed is missed
+        const auto subscription = store.subscribe([this, userId](const std::vector<ShortcutsStore::Change> &changes) {
+            this->applyChanges(userId, changes);
+        });
+
+        {
+            std::unique_lock lock(this->m_mutex);
+            this->m_subscriptions.emplace_back(&store, subscription);
+        }
+
+        std::vector<ShortcutsStore::Change> shortcuts;
+        for (const auto &appId : store.getAppIds()) {
+            if (auto shortcut = store.getShortcut(appId); shortcut.has_value())
+                shortcuts.push_back({ ShortcutsStore::Change::Kind::Added, appId, std::move(shortcut) });
+        }
+
+        this->applyChanges(userId, shortcuts);
+
+        return true;
+    }
+
+    std::vector<SearchResult> SearchIndex::search(std::string_view query, size_t limit) const {
+        std::shared_lock lock(this->m_mutex);
+
+        const auto normalizedQuery = normalize(query);
+        const auto trigrams = getQueryTrigrams(normalizedQuery);
+        if (trigrams.empty() || limit == 0)
+            return { };
+
+        const auto firstTrigram = getFirstTrigram(normalizedQuery.substr(0, normalizedQuery.find(' ')));
+
+        struct Match {
+            u16 count, nameCount;
+            bool atNameStart;
+        };
+
+        // Reused across queries so only the entries that got touched need to be cleared again
+        thread_local std::vector<Match> matches;
+        if (matches.size() < this->m_documents.size())
+            matches.resize(this->m_documents.size());
+
+        std::vector<u32> candidates;
+        for (const auto trigram : trigrams) {
+            auto posting = this->m_postings.find(trigram);
+            if (posting == this->m_postings.end())
+                continue;
+
+            const bool isFirstTrigram = trigram == firstTrigram;
+            for (const auto value : posting->second) {
+                const auto id = value >> FlagBits;
+                auto &match = matches[id];
+
+                if (match.count++ == 0)
+                    candidates.push_back(id);
+                if (value & InName)
+                    match.nameCount++;
+                if (isFirstTrigram && (value & AtNameStart))
+                    match.atNameStart = true;
+            }
+        }
+
+        // Be lenient enough for a typo or two, the ranking takes care of pushing weak matches down
+        const size_t requiredMatches = std::max<size_t>(1, (trigrams.size() + 2) / 3);
+
+        struct Ranked {
+            u32 id;
+            u16 nameLength;
+            float score;
+        };
+
+        std::vector<Ranked> ranked;
+        ranked.reserve(candidates.size());
+        for (const auto id : candidates) {
+            auto &match = matches[id];
+
+            if (match.count >= requiredMatches) {
+                // Everything being found in the name and the name starting with the query is what people are usually looking for
+                float score = float(match.count) / float(trigrams.size());
+                if (match.nameCount == trigrams.size())
+                    score += 1.0F;
+                if (match.atNameStart)
+                    score += 0.5F;
+
+                ranked.push_back({ id, this->m_nameLengths[id], score });
+            }
+
+            match = { };
+        }
+
+        const auto count = std::min(limit, ranked.size());
+        std::partial_sort(ranked.begin(), ranked.begin() + count, ranked.end(), [](const Ranked &a, const Ranked &b) {
+            if (a.score != b.score)
+                return a.score > b.score;
+
+            // Shorter names are closer to what was typed
+            if (a.nameLength != b.nameLength)
+                return a.nameLength < b.nameLength;
+
+            return a.id < b.id;
+        });
+
+        std::vector<SearchResult> results;
+        results.reserve(count);
+        for (size_t i = 0; i < count; i++)
+            results.push_back({ this->m_documents[ranked[i].id]->entry, ranked[i].score });
+
+        return results;
+    }
+
+    size_t SearchIndex::size() const {
+        std::shared_lock lock(this->m_mutex);
+
+        return this->m_keys.size();
+    }
+
+}
@@ -0,0 +1,491 @@
+#include <steam/api/shortcuts_store.hpp>
+
+#include <steam/file_formats/diff.hpp>
+#include <steam/file_formats/journal.hpp>
+
+#include <steam/helpers/file_lock.hpp>
+#include <steam/helpers/hash.hpp>
+#include <steam/helpers/mapped_file.hpp>
+#include <steam/helpers/utils.hpp>
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <map>
+#include <memory>
+
+#include <sys/stat.h>
+
+namespace steam::api {
+
+    constexpr static auto AppIdIndexPattern = "shortcuts/*/appid";
+
+    namespace {
+
+        std::map<u32, const VDF::Value*> collectShortcuts(const VDF *document) {
+            std::map<u32, const VDF::Value*> shortcuts;
+            if (document == nullptr)
+                return shortcuts;
+
+            auto shortcutsList = document->get().find("shortcuts");
+            if (shortcutsList == document->get().end() || !shortcutsList->second.isSet())
+                return shortcuts;
+
+            for (const auto &[key, shortcut] : shortcutsList->second.set()) {
+                if (!shortcut.isSet())
+                    continue;
+
+                auto appId = shortcut.set().find("appid");
+                if (appId != shortcut.set().end() && appId->second.isInteger())
+                    shortcuts.emplace(appId->second.integer(), &shortcut);
+            }
+
+            return shortcuts;
+        }
+
+    }
+
+    ShortcutsStore::ShortcutsStore(const User &user)
+        : ShortcutsStore(fs::getSteamDirectory() / "userdata" / std::to_string(user.getId()) / "config" / "shortcuts.vdf") { }
+
+    ShortcutsStore::ShortcutsStore(std::fs::path path) : m_path(std::move(path)) { }
+
+    ShortcutsStore& ShortcutsStore::get(const User &user) {
+        static std::mutex mutex;
+        static std::map<u32, std::unique_ptr<ShortcutsStore>> stores;
+
+        std::scoped_lock lock(mutex);
+
+        auto &store = stores[user.getId()];
+        if (store == nullptr)
+            store = std::make_unique<ShortcutsStore>(user);
+
+        return *store;
+    }
+
+    VDF::Set ShortcutsStore::createShortcut(const AppId &appId, const std::string &appName, const std::fs::path &exePath, const std::string &launchOptions, const std::vector<std::string> &tags, bool hidden) {
+        VDF::Set tagsSet;
+        {
+            u32 index = 0;
+            for (const auto &tag : tags) {
+                tagsSet[std::to_string(index)] = tag;
+                index++;
+            }
+        }
+
+        VDF::Set shortcut;
+        shortcut["AllowDesktopConfig"]  = true;
+        shortcut["AllowOverlay"]        = true;
+        shortcut["AppName"]             = appName;
+        shortcut["Devkit"]              = false;
+        shortcut["DevkitGameID"]        = "";
+        shortcut["DevkitOverrideAppID"] = false;
+        shortcut["Exe"]                 = fmt::format("\"{0}\"", exePath.string());
+        shortcut["FlatpakAppID"]        = "";
+        shortcut["IsHidden"]            = hidden;
+        shortcut["LastPlayTime"]        = 0;
+        shortcut["LaunchOptions"]       = launchOptions;
+        shortcut["OpenVR"]              = false;
+        shortcut["ShortcutPath"]        = "";
+        shortcut["StartDir"]            = fmt::format("\"{0}\"", exePath.parent_path().string());
+        shortcut["appid"]               = appId.getShortAppId();
+        shortcut["icon"]                = "";
+        shortcut["tags"]                = tagsSet;
+
+        return shortcut;
+    }
+
+    u32 ShortcutsStore::subscribe(Callback callback) {
+        std::scoped_lock lock(this->m_subscriberMutex);
+
+        const auto id = this->m_nextSubscriberId++;
+        this->m_subscribers.emplace(id, std::move(callback));
+
+        return id;
+    }
+
+    bool ShortcutsStore::unsubscribe(u32 id) {
+        std::scoped_lock lock(this->m_subscriberMutex);
+
+        return this->m_subscribers.erase(id) > 0;
+    }
+
+    void ShortcutsStore::notify(const std::optional<VDF> &previous, const VDF &current) {
+        std::scoped_lock lock(this->m_subscriberMutex);
+
+        if (this->m_subscribers.empty())
+            return;
+
+        const auto oldShortcuts = collectShortcuts(previous.has_value() ? &*previous : nullptr);
+        const auto newShortcuts = collectShortcuts(&current);
+
+        std::vector<Change> changes;
+        for (const auto &[appId, shortcut] : oldShortcuts) {
+            if (!newShortcuts.contains(appId))
+                changes.push_back({ Change::Kind::Removed, AppId::fromShortAppId(appId), std::nullopt });
+        }
+
+        for (const auto &[appId, shortcut] : newShortcuts) {
+            auto oldShortcut = oldShortcuts.find(appId);
+            if (oldShortcut == oldShortcuts.end())
+                changes.push_back({ Change::Kind::Added, AppId::fromShortAppId(appId), *shortcut });
+            else if (!diffDocuments(oldShortcut->second->set(), shortcut->set()).empty())
+                changes.push_back({ Change::Kind::Modified, AppId::fromShortAppId(appId), *shortcut });
+        }
+
+        if (changes.empty())
+            return;
+
+        for (const auto &[id, callback] : this->m_subscribers)
+            callback(changes);
+    }
+
+    std::optional<ShortcutsStore::FileIdentity> ShortcutsStore::queryIdentity() const {
+        struct stat64 status = { };
+        if (::stat64(this->m_path.c_str(), &status) != 0) {
+            // Users that never added a shortcut don't have a shortcuts file yet
+            if (errno == ENOENT)
+                return FileIdentity { };
+
+            return std::nullopt;
+        }
+
+        return FileIdentity {
+            .device             = status.st_dev,
+            .inode              = status.st_ino,
+            .size               = u64(status.st_size),
+            .modificationTime   = status.st_mtim.tv_sec * 1'000'000'000 + status.st_mtim.tv_nsec,
+            .exists             = true
+        };
+    }
+
+    bool ShortcutsStore::load(const FileIdentity &identity) {
+        auto file = fs::MappedFile(this->m_path);
+        if (identity.exists && !file.isValid())
+            return false;
+
+        // Make sure the file is intact before touching it, a failed parse would otherwise silently drop its contents
+        if (!file.getBytes().empty() && !VDF::validate(file.getBytes()))
+            return false;
+
+        auto previous = std::move(this->m_original);
+
+        this->m_document.emplace(file.getBytes());
+        this->m_index = addAppIdIndex(*this->m_document);
+        this->m_original = this->m_document;
+        this->m_checksum = crc32(file.getBytes());
+        this->m_identity = identity;
+        this->m_dirty = false;
+
+        this->notify(previous, *this->m_document);
+
+        return true;
+    }
+
+    bool ShortcutsStore::revalidate() {
+        auto identity = this->queryIdentity();
+        if (!identity.has_value())
+            return false;
+
+        if (this->m_document.has_value() && *identity == this->m_identity)
+            return true;
+
+        // Keep pending edits around, flushing them will notice that the file changed underneath them
+        if (this->m_dirty)
+            return true;
+
+        return this->load(*identity);
+    }
+
+    bool ShortcutsStore::reload() {
+        std::scoped_lock lock(this->m_mutex);
+
+        this->m_dirty = false;
+
+        auto identity = this->queryIdentity();
+        if (!identity.has_value())
+            return false;
+
+        return this->load(*identity);
+    }
+
+    const VDF::Index::Entry* ShortcutsStore::find(const AppId &appId) const {
+        if (this->m_index == nullptr)
+            return nullptr;
+
+        return this->m_index->find(appId.getShortAppId());
+    }
+
+    std::optional<AppId> ShortcutsStore::addGameShortcut(const std::string &appName, const std::fs::path &exePath, const std::string &launchOptions, const std::vector<std::string> &tags, bool hidden) {
+        std::scoped_lock lock(this->m_mutex);
+
+        if (!this->revalidate())
+            return std::nullopt;
+
+        auto appId = addShortcut(*this->m_document, appName, exePath, launchOptions, tags, hidden);
+        if (appId.has_value())
+            this->m_dirty = true;
+
+        return appId;
+    }
+
+    const VDF::Index* ShortcutsStore::addAppIdIndex(VDF &document) {
+        return document.addIndex(AppIdIndexPattern);
+    }
+
+    std::optional<AppId> ShortcutsStore::addShortcut(VDF &document, const std::string &appName, const std::fs::path &exePath, const std::string &launchOptions, const std::vector<std::string> &tags, bool hidden) {
+        auto nextShortcutId = getNextShortcutId(document);
+        if (!nextShortcutId.has_value())
+            return std::nullopt;
+
+        // Same as the batched version, a game that already has a shortcut doesn't get a second one
+        auto appId = AppId(exePath, appName);
+        auto index = addAppIdIndex(document);
+        if (index == nullptr || index->contains(appId.getShortAppId()))
+            return std::nullopt;
+
+        document["shortcuts"][std::to_string(*nextShortcutId)] = createShortcut(appId, appName, exePath, launchOptions, tags, hidden);
+
+        return appId;
+    }
+
+    bool ShortcutsStore::removeShortcut(VDF &document, const VDF::Index &index, const AppId &appId) {
+        auto entry = index.find(appId.getShortAppId());
+        if (entry == nullptr || !isIntegerString(entry->key))
+            return false;
+
+        auto &shortcutsList = document["shortcuts"];
+        auto shortcutCount  = shortcutsList.set().size();
+        auto shortcutIndex  = std::stoi(entry->key);
+
+        // Remove the shortcut and move all following entries backwards to keep the array contiguous
+        shortcutsList.erase(std::string(entry->key));
+        for (size_t i = shortcutIndex; i < shortcutCount - 1; i++) {
+            shortcutsList[std::to_string(i)] = std::move(shortcutsList[std::to_string(i + 1)]);
+            shortcutsList.erase(std::to_string(i + 1));
+        }
+
+        return true;
+    }
+
+    std::optional<u32> ShortcutsStore::getNextShortcutId(VDF &document) {
+        u32 nextShortcutId = 0;
+        for (const auto &[key, value] : document["shortcuts"].set()) {
+            if (!isIntegerString(key))
+                return std::nullopt;
+
+            nextShortcutId = std::max<u32>(nextShortcutId, std::stoi(std::string(key)) + 1);
+        }
+
+        return nextShortcutId;
+    }
+
+    std::vector<std::optional<AppId>> ShortcutsStore::addGameShortcuts(std::span<const ShortcutSpec> games) {
+        std::scoped_lock lock(this->m_mutex);
+
+        std::vector<std::optional<AppId>> result(games.size());
+        if (!this->revalidate())
+            return result;
+
+        auto nextShortcutId = getNextShortcutId(*this->m_document);
+        if (!nextShortcutId.has_value())
+            return result;
+
+        const auto appIds = AppId::generate(games);
+
+        auto &shortcutsList = (*this->m_document)["shortcuts"];
+        for (size_t i = 0; i < games.size(); i++) {
+            const auto &game  = games[i];
+            const auto &appId = appIds[i];
+
+            // Catches duplicates within the batch as well since the index picks up every added shortcut
+            if (this->find(appId) != nullptr)
+                continue;
+
+            shortcutsList[std::to_string(*nextShortcutId)] = createShortcut(appId, game.appName, game.exePath, game.launchOptions, game.tags, game.hidden);
+            *nextShortcutId += 1;
+
+            result[i] = appId;
+            this->m_dirty = true;
+        }
+
+        return result;
+    }
+
+    bool ShortcutsStore::removeGameShortcut(const AppId &appId) {
+        std::scoped_lock lock(this->m_mutex);
+
+        if (!this->revalidate() || this->m_index == nullptr)
+            return false;
+
+        if (!removeShortcut(*this->m_document, *this->m_index, appId))
+            return false;
+
+        this->m_dirty = true;
+
+        return true;
+    }
+
+    std::vector<AppId> ShortcutsStore::removeGameShortcutsIf(const std::function<bool(const VDF::Value &shortcut)> &predicate) {
+        std::scoped_lock lock(this->m_mutex);
+
+        if (!this->revalidate())
+            return { };
+
+        auto &shortcutsList = (*this->m_document)["shortcuts"];
+
+        // Collect the shortcuts in array order, the set itself is ordered by key string
+        std::vector<std::pair<u32, VDF::Value*>> shortcuts;
+        for (auto &[key, value] : shortcutsList.set()) {
+            if (!isIntegerString(key))
+                return { };
+
+            shortcuts.emplace_back(std::stoi(std::string(key)), &value);
+        }
+
+        std::ranges::sort(shortcuts, { }, &std::pair<u32, VDF::Value*>::first);
+
+        // Decide on everything before moving any shortcut, a call that matches nothing has to leave the document untouched
+        std::vector<bool> matches;
+        matches.reserve(shortcuts.size());
+        for (const auto &[index, shortcut] : shortcuts)
+            matches.push_back(predicate(*shortcut));
+
+        if (std::ranges::find(matches, true) == matches.end())
+            return { };
+
+        std::vector<AppId> removed;
+        VDF::Set remaining;
+        for (size_t i = 0; i < shortcuts.size(); i++) {
+            auto shortcut = shortcuts[i].second;
+            if (!matches[i]) {
+                remaining[std::to_string(remaining.size())] = std::move(*shortcut);
+                continue;
+            }
+
+            if (shortcut->isSet()) {
+                auto appId = shortcut->set().find("appid");
+                if (appId != shortcut->set().end() && appId->second.isInteger())
+                    removed.push_back(AppId::fromShortAppId(appId->second.integer()));
+            }
+        }
+
+        // Replacing the whole list rebuilds the appid index once instead of for every moved entry
+        shortcutsList = std::move(remaining);
+        this->m_dirty = true;
+
+        return removed;
+    }
+
+    bool ShortcutsStore::contains(const AppId &appId) {
+        std::scoped_lock lock(this->m_mutex);
+
+        return this->revalidate() && this->find(appId) != nullptr;
+    }
+
+    std::optional<VDF::Value> ShortcutsStore::getShortcut(const AppId &appId) {
+        std::scoped_lock lock(this->m_mutex);
+
+        if (!this->revalidate())
+            return std::nullopt;
+
+        auto entry = this->find(appId);
+        if (entry == nullptr)
+            return std::nullopt;
+
+        return *entry->element;
+    }
+
+    std::vector<AppId> ShortcutsStore::getAppIds() {
+        std::scoped_lock lock(this->m_mutex);
+
+        if (!this->revalidate())
+            return { };
+
+        const auto &shortcuts = this->m_document->get();
+        auto shortcutsList = shortcuts.find("shortcuts");
+        if (shortcutsList == shortcuts.end() || !shortcutsList->second.isSet())
+            return { };
+
+        // Query all app IDs from the list, in the order they show up in Steam
+        std::vector<AppId> appIds;
+        for (const auto &[key, value] : shortcutsList->second.set()) {
+            if (!value.isSet())
+                continue;
+
+            auto appId = value.set().find("appid");
+            if (appId != value.set().end() && appId->second.isInteger())
+                appIds.push_back(AppId::fromShortAppId(appId->second.integer()));
+        }
+
+        return appIds;
+    }
+
+    bool ShortcutsStore::write() {
+        auto data = this->m_document->dump();
+        if (!VDF::validate(data))
+            return false;
+
+        const auto checksum = crc32(data);
+
+        if (!Journal<VDF>(this->m_path).record(*this->m_original, this->m_checksum, *this->m_document, checksum))
+            return false;
+
+        if (!fs::writeFileAtomic(this->m_path, std::span<const u8>(data)))
+            return false;
+
+        // An unknown identity simply causes the file to get parsed again on next access
+        auto previous = std::move(this->m_original);
+
+        this->m_identity = this->queryIdentity().value_or(FileIdentity { });
+        this->m_original = this->m_document;
+        this->m_checksum = checksum;
+        this->m_dirty    = false;
+
+        this->notify(previous, *this->m_document);
+
+        return true;
+    }
+
+    bool ShortcutsStore::flush() {
+        std::scoped_lock lock(this->m_mutex);
+
+        if (!this->m_dirty)
+            return true;
+
+        fs::FileLock fileLock(this->m_path);
+        if (!fileLock.isLocked())
+            return false;
+
+        if (this->queryIdentity() != this->m_identity)
+            return false;
+
+        return this->write();
+    }
+
+    bool ShortcutsStore::update(const std::function<bool(ShortcutsStore &store)> &callback) {
+        std::scoped_lock lock(this->m_mutex);
+
+        fs::FileLock fileLock(this->m_path);
+        if (!fileLock.isLocked() || !this->revalidate())
+            return false;
+
+        if (!callback(*this)) {
+            this->reload();
+            return false;
+        }
+
+        if (!this->m_dirty)
+            return true;
+
+        // A rejected edit is dropped, the next flush would otherwise still write it
+        if (this->queryIdentity() != this->m_identity || !this->write()) {
+            this->reload();
+            return false;
+        }
+
+        return true;
+    }
+
+}
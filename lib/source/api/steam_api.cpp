@@ -1,220 +1,138 @@
 #include <steam/api/steam_api.hpp>
 #include <steam/api/appid.hpp>
-
-#include <steam/file_formats/vdf.hpp>
+#include <steam/api/shortcuts_store.hpp>
+#include <steam/api/steam_process.hpp>
+#include <steam/api/transaction.hpp>
 
 #include <steam/helpers/fs.hpp>
-#include <steam/helpers/file.hpp>
-#include <steam/helpers/utils.hpp>
+#include <steam/helpers/mapped_file.hpp>
 
-#include <fmt/format.h>
-#include <signal.h>
+#include <charconv>
 
 namespace steam::api {
 
-    static std::fs::path getShortcutsFilePath(const User &user) {
-        return fs::getSteamDirectory() / "userdata" / std::to_string(user.getId()) / "config";
-    }
-
-    static std::optional<VDF> getShortcuts(const User &user) {
-        auto configPath = getShortcutsFilePath(user);
+    std::optional<AppId> addGameShortcut(const User &user, const std::string &appName, const std::fs::path &exePath, const std::string &launchOptions, const std::vector<std::string> &tags, bool hidden) {
+        std::optional<AppId> appId;
 
-        // Create backup of original shortcuts file if there haven't been any modifications done by us yet
-        if (!fs::exists(configPath / "shortcuts.vdf.orig"))
-            if (!fs::copyFile(configPath / "shortcuts.vdf", configPath / "shortcuts.vdf.orig")) {
-                return std::nullopt;
-            }
+        auto added = ShortcutsStore::get(user).update([&](ShortcutsStore &store) {
+            appId = store.addGameShortcut(appName, exePath, launchOptions, tags, hidden);
+            return appId.has_value();
+        });
 
-        // Create a backup of the current shortcuts file
-        fs::remove(configPath / "shortcuts.vdf.bak");
-        if (!fs::copyFile(configPath / "shortcuts.vdf", configPath / "shortcuts.vdf.bak")) {
+        if (!added)
             return std::nullopt;
-        }
 
-        // Open shortcuts file
-        auto shortcutsFile = fs::File(configPath / "shortcuts.vdf", fs::File::Mode::Write);
-        if (!shortcutsFile.isValid()) {
-            return std::nullopt;
-        }
-
-        // Parse shortcuts
-        auto shortcuts = VDF(shortcutsFile.readBytes());
+        return appId;
+    }
 
-        return shortcuts;
+    bool removeGameShortcut(const User &user, const AppId &appId) {
+        return ShortcutsStore::get(user).update([&](ShortcutsStore &store) {
+            return store.removeGameShortcut(appId);
+        });
     }
 
-    std::optional<AppId> addGameShortcut(const User &user, const std::string &appName, const std::fs::path &exePath, const std::string &launchOptions, const std::vector<std::string> &tags, bool hidden) {
+    std::vector<std::optional<AppId>> addGameShortcuts(const User &user, std::span<const ShortcutSpec> games) {
+        std::vector<std::optional<AppId>> appIds;
 
-        // Generate AppID
-        auto appId = AppId(exePath, appName);
+        auto added = ShortcutsStore::get(user).update([&](ShortcutsStore &store) {
+            appIds = store.addGameShortcuts(games);
+            return true;
+        });
 
-        // Parse shortcuts
-        auto shortcuts = getShortcuts(user);
-        if (!shortcuts)
-            return std::nullopt;
+        if (!added)
+            return std::vector<std::optional<AppId>>(games.size());
 
-        // Find the next free shortcut array index
-        u32 nextShortcutId = 0;
-        {
-            for (const auto &[key, value] : (*shortcuts)["shortcuts"].set()) {
-                if (!isIntegerString(key))
-                    return std::nullopt;
+        return appIds;
+    }
 
-                auto id = std::stoi(key);
-                if (id > nextShortcutId)
-                    nextShortcutId = id;
-            }
+    std::vector<AppId> removeGameShortcutsIf(const User &user, const std::function<bool(const VDF::Value &shortcut)> &predicate) {
+        std::vector<AppId> appIds;
 
-            nextShortcutId++;
-        }
+        auto removed = ShortcutsStore::get(user).update([&](ShortcutsStore &store) {
+            appIds = store.removeGameShortcutsIf(predicate);
+            return true;
+        });
 
-        // Add the new shortcut
-        {
-            VDF::Set tagsSet;
-            {
-                u32 index = 0;
-                for (const auto &tag : tags) {
-                    tagsSet[std::to_string(index)] = tag;
-                    index++;
-                }
-            }
-
-            VDF::Set shortcut;
-            shortcut["AllowDesktopConfig"]  = true;
-            shortcut["AllowOverlay"]        = true;
-            shortcut["AppName"]             = appName;
-            shortcut["Devkit"]              = false;
-            shortcut["DevkitGameID"]        = "";
-            shortcut["DevkitOverrideAppID"] = false;
-            shortcut["Exe"]                 = fmt::format("\"{0}\"", exePath.string());
-            shortcut["FlatpakAppID"]        = "";
-            shortcut["IsHidden"]            = hidden;
-            shortcut["LastPlayTime"]        = 0;
-            shortcut["LaunchOptions"]       = launchOptions;
-            shortcut["OpenVR"]              = false;
-            shortcut["ShortcutPath"]        = "";
-            shortcut["StartDir"]            = fmt::format("\"{0}\"", exePath.parent_path().string());
-            shortcut["appid"]               = appId.getShortAppId();
-            shortcut["icon"]                = "";
-            shortcut["tags"]                = tagsSet;
-
-            (*shortcuts)["shortcuts"][std::to_string(nextShortcutId)] = shortcut;
-        }
+        if (!removed)
+            return { };
 
-        // Dump the shortcut data back to the shortcuts file
-        auto shortcutsFile = fs::File(getShortcutsFilePath(user), fs::File::Mode::Create);
-        shortcutsFile.write(shortcuts->dump());
+        return appIds;
+    }
 
-        return appId;
+    bool enableProtonForApp(AppId appId, bool enabled) {
+        Transaction transaction;
+
+        return transaction.enableProtonForApp(appId, enabled) && transaction.commit();
     }
 
-    bool removeGameShortcut(const User &user, const AppId &appId) {
-        auto shortcuts = getShortcuts(user);
-        if (!shortcuts)
-            return false;
+    bool setCompatTools(std::span<const CompatToolUpdate> updates) {
+        Transaction transaction;
 
-        // Get number of shortcuts
-        auto shortcutCount = (*shortcuts)["shortcuts"].set().size();
+        return transaction.setCompatTools(updates) && transaction.commit();
+    }
 
-        // Find shortcut with appid we want to remove
-        std::string shortcutToRemoveKey;
-        for (const auto &[key, value] : (*shortcuts)["shortcuts"].set()) {
-            if (!value.isSet())
-                return false;
+    static bool parseInteger(std::string_view string, u32 &result) {
+        auto [end, error] = std::from_chars(string.data(), string.data() + string.size(), result);
 
-            const auto &game = value.set();
-            if (!game.contains("appid") || !game.at("appid").isInteger())
-                return false;
+        return error == std::errc() && end == string.data() + string.size();
+    }
 
-            if (game.at("appid").integer() == appId.getShortAppId()) {
-                shortcutToRemoveKey = key;
-                break;
-            }
-        }
+    std::unordered_map<u32, CompatTool> getCompatTools() {
+        auto file = fs::MappedFile(fs::getSteamDirectory() / "config" / "config.vdf");
+        if (!file.isValid() || !KeyValues::validate(file.getString()))
+            return { };
 
-        // Bail out if no shortcut with that appid has been found
-        if (shortcutToRemoveKey.empty() || !isIntegerString(shortcutToRemoveKey))
-            return false;
+        const auto config = KeyValues(file.getString());
 
-        // Remove the shortcut
-        shortcuts->get().erase(shortcutToRemoveKey);
+        // Walk down without operator[] so missing sections don't get created on the way
+        const KeyValues::Set *section = &config.get();
+        for (const auto key : { "InstallConfigStore", "Software", "Valve", "Steam", "CompatToolMapping" }) {
+            auto it = section->find(key);
+            if (it == section->end() || !it->second.isSet())
+                return { };
 
-        // Move all following entries backwards to keep the array contiguous
-        auto shortcutIndex = std::stoi(shortcutToRemoveKey);
-        for (size_t i = shortcutIndex; i < shortcutCount - 1; i++) {
-            shortcuts->get()[std::to_string(i)] = shortcuts->get()[std::to_string(i + 1)];
-            shortcuts->get().erase(std::to_string(i + 1));
+            section = &it->second.set();
         }
 
-        return true;
-    }
+        std::unordered_map<u32, CompatTool> tools;
+        tools.reserve(section->size());
 
-    bool enableProtonForApp(AppId appId, bool enabled) {
-        auto configPath = fs::getSteamDirectory() / "config";
+        for (const auto &[key, value] : *section) {
+            u32 appId = 0;
+            if (!value.isSet() || !parseInteger(key.view(), appId))
+                continue;
 
-        // Create backup of original config file if there haven't been any modifications done by us yet
-        if (!fs::exists(configPath / "config.vdf.orig"))
-            if (!fs::copyFile(configPath / "config.vdf", configPath / "config.vdf.orig")) return false;
+            const auto &entry = value.set();
+            auto field = [&entry](std::string_view name) -> std::string_view {
+                auto it = entry.find(name);
+                if (it == entry.end() || !it->second.isString())
+                    return { };
 
-        // Create a backup of the current config file
-        if (!fs::remove(configPath / "config.vdf.bak")) return false;
-        if (!fs::copyFile(configPath / "config.vdf", configPath / "config.vdf.bak")) return false;
+                return it->second.string();
+            };
 
-        auto configFile = fs::File(configPath / "config.vdf", fs::File::Mode::Read);
-        if (!configFile.isValid())
-            return false;
+            CompatTool tool;
+            tool.name   = field("name");
+            tool.config = field("config");
 
-        auto config = KeyValues(configFile.readString());
+            parseInteger(field("Priority"), tool.priority);
 
-        // Create or remove config entry for proton
-        if (enabled) {
-            KeyValues::Set entry;
+            tools.emplace(appId, std::move(tool));
+        }
 
-            entry["name"]       = "proton_experimental";
-            entry["config"]     = "";
-            entry["Priority"]   = "250";
+        return tools;
+    }
 
-            config["InstallConfigStore"]["Software"]["Valve"]["Steam"]["CompatToolMapping"][std::to_string(appId.getShortAppId())] = entry;
-        } else {
-            config["InstallConfigStore"]["Software"]["Valve"]["Steam"]["CompatToolMapping"].set().erase(std::to_string(appId.getShortAppId()));
-        }
+    bool restartSteam(const std::function<bool()> &whileStopped) {
+        auto steam = SteamProcess::find();
+        if (!steam.has_value() || !steam->shutdown())
+            return false;
 
-        // Dump data to config file
-        configFile = fs::File(configPath / "config.vdf", fs::File::Mode::Create);
-        configFile.write(config.dump());
+        // Steam is guaranteed to be gone here, it can't overwrite anything the callback changes
+        if (whileStopped)
+            return whileStopped();
 
         return true;
     }
 
-    bool restartSteam() {
-        // Get status information of the current process
-        auto statFile = fs::File("/proc/self/stat", fs::File::Mode::Read);
-
-        do {
-            if (!statFile.isValid())
-                return false;
-
-            i32 pid;
-            char comm[0xFF];
-            char state;
-            i32 ppid;
-
-            // Parse stat data
-            fscanf(statFile.getHandle(), "%d %s %c %d", &pid, comm, &state, &ppid);
-
-            // Bail out when we reached the init process
-            if (ppid <= 1)
-                return false;
-
-            if (std::string(comm) == "(steam)") {
-                // If the steam executable is reached, kill it
-                kill(pid, SIGKILL);
-            }
-            else {
-                // If the executable isn't steam yet, read the stat file of the parent process
-                statFile = fs::File(fmt::format("/proc/{}/stat", ppid), fs::File::Mode::Read);
-            }
-        } while (true);
-    }
-
 }
\ No newline at end of file
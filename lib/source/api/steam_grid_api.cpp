@@ -66,10 +66,14 @@ namespace steam::api {
         return result;
     }
 
-    std::future<std::vector<SteamGridDBAPI::ImageResult>> SteamGridDBAPI::getGrids(const AppId &appId) {
+    static std::string getGamePath(const AppId &appId, SteamGridDBAPI::IdType idType) {
+        return (idType == SteamGridDBAPI::IdType::Steam ? "steam/" : "game/") + std::to_string(appId.getAppId());
+    }
+
+    std::future<std::vector<SteamGridDBAPI::ImageResult>> SteamGridDBAPI::getGrids(const AppId &appId, IdType idType) {
         return std::async(std::launch::async, [=, this]() -> std::vector<SteamGridDBAPI::ImageResult> {
             auto response = this->m_net.getJson(
-                    SteamGridDBAPI::BaseUrl + "/grids/game/" + std::to_string(appId.getAppId()),
+                    SteamGridDBAPI::BaseUrl + "/grids/" + getGamePath(appId, idType),
                     Net::DefaultTimeout,
                     { { "Authorization", "Bearer " + this->m_apiKey } }
             ).get();
@@ -85,10 +89,10 @@ namespace steam::api {
         });
     }
 
-    std::future<std::vector<SteamGridDBAPI::ImageResult>> SteamGridDBAPI::getHeroes(const AppId &appId) {
+    std::future<std::vector<SteamGridDBAPI::ImageResult>> SteamGridDBAPI::getHeroes(const AppId &appId, IdType idType) {
         return std::async(std::launch::async, [=, this]() -> std::vector<SteamGridDBAPI::ImageResult> {
             auto response = this->m_net.getJson(
-                    SteamGridDBAPI::BaseUrl + "/heroes/game/" + std::to_string(appId.getAppId()),
+                    SteamGridDBAPI::BaseUrl + "/heroes/" + getGamePath(appId, idType),
                     Net::DefaultTimeout,
                     { { "Authorization", "Bearer " + this->m_apiKey } }
             ).get();
@@ -104,10 +108,10 @@ namespace steam::api {
         });
     }
 
-    std::future<std::vector<SteamGridDBAPI::ImageResult>> SteamGridDBAPI::getLogos(const AppId &appId) {
+    std::future<std::vector<SteamGridDBAPI::ImageResult>> SteamGridDBAPI::getLogos(const AppId &appId, IdType idType) {
         return std::async(std::launch::async, [=, this]() -> std::vector<SteamGridDBAPI::ImageResult> {
             auto response = this->m_net.getJson(
-                    SteamGridDBAPI::BaseUrl + "/logos/game/" + std::to_string(appId.getAppId()),
+                    SteamGridDBAPI::BaseUrl + "/logos/" + getGamePath(appId, idType),
                     Net::DefaultTimeout,
                     { { "Authorization", "Bearer " + this->m_apiKey } }
             ).get();
@@ -123,10 +127,10 @@ namespace steam::api {
         });
     }
 
-    std::future<std::vector<SteamGridDBAPI::ImageResult>> SteamGridDBAPI::getIcons(const AppId &appId) {
+    std::future<std::vector<SteamGridDBAPI::ImageResult>> SteamGridDBAPI::getIcons(const AppId &appId, IdType idType) {
         return std::async(std::launch::async, [=, this]() -> std::vector<SteamGridDBAPI::ImageResult> {
             auto response = this->m_net.getJson(
-                    SteamGridDBAPI::BaseUrl + "/icons/game/" + std::to_string(appId.getAppId()),
+                    SteamGridDBAPI::BaseUrl + "/icons/" + getGamePath(appId, idType),
                     Net::DefaultTimeout,
                     { { "Authorization", "Bearer " + this->m_apiKey } }
             ).get();
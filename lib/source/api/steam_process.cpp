@@ -0,0 +1,240 @@
+#include <steam/api/steam_process.hpp>
+
+#include <steam/helpers/fs.hpp>
+#include <steam/helpers/watcher.hpp>
+
+#include <fmt/format.h>
+
+#include <cerrno>
+#include <charconv>
+#include <csignal>
+#include <string_view>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace steam::api {
+
+    namespace {
+
+        using Clock = std::chrono::steady_clock;
+
+        std::fs::path getPidFilePath() {
+            return fs::getHomeDirectory() / ".steam" / "steam.pid";
+        }
+
+        // Reads small files from /proc and the like whose size isn't known upfront
+        std::string readSmallFile(const std::string &path) {
+            const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+            if (fd < 0)
+                return { };
+
+            char buffer[64];
+            const auto size = ::read(fd, buffer, sizeof(buffer));
+            ::close(fd);
+
+            if (size <= 0)
+                return { };
+
+            return { buffer, size_t(size) };
+        }
+
+        std::optional<pid_t> parsePid(std::string_view string) {
+            while (!string.empty() && (string.back() == '\n' || string.back() == ' '))
+                string.remove_suffix(1);
+
+            pid_t pid = 0;
+            auto [end, error] = std::from_chars(string.data(), string.data() + string.size(), pid);
+            if (error != std::errc() || end != string.data() + string.size() || pid <= 0)
+                return std::nullopt;
+
+            return pid;
+        }
+
+        bool isSteamProcess(pid_t pid) {
+            // Only look at our own processes, other users may be running their own Steam client
+            struct stat status = { };
+            if (::stat(fmt::format("/proc/{}", pid).c_str(), &status) != 0 || status.st_uid != ::getuid())
+                return false;
+
+            return readSmallFile(fmt::format("/proc/{}/comm", pid)) == "steam\n";
+        }
+
+        // Waits for the fd to become readable until the deadline, retrying if a signal interrupts the wait
+        bool waitReadable(int fd, Clock::time_point deadline) {
+            pollfd pollDescriptor = { .fd = fd, .events = POLLIN, .revents = 0 };
+
+            while (true) {
+                const auto remaining = std::chrono::ceil<std::chrono::milliseconds>(deadline - Clock::now());
+
+                int result = ::poll(&pollDescriptor, 1, int(std::max<i64>(remaining.count(), 0)));
+                if (result < 0 && errno == EINTR)
+                    continue;
+
+                return result > 0;
+            }
+        }
+
+    }
+
+    SteamProcess::SteamProcess() noexcept : m_fd(-1), m_pid(0) { }
+
+    SteamProcess::SteamProcess(int fd, pid_t pid) noexcept : m_fd(fd), m_pid(pid) { }
+
+    SteamProcess::SteamProcess(SteamProcess &&other) noexcept {
+        this->m_fd  = other.m_fd;
+        this->m_pid = other.m_pid;
+        other.m_fd  = -1;
+        other.m_pid = 0;
+    }
+
+    SteamProcess::~SteamProcess() {
+        this->close();
+    }
+
+    SteamProcess &SteamProcess::operator=(SteamProcess &&other) noexcept {
+        if (this == &other)
+            return *this;
+
+        this->close();
+
+        this->m_fd  = other.m_fd;
+        this->m_pid = other.m_pid;
+        other.m_fd  = -1;
+        other.m_pid = 0;
+
+        return *this;
+    }
+
+    void SteamProcess::close() {
+        if (this->isValid())
+            ::close(this->m_fd);
+
+        this->m_fd  = -1;
+        this->m_pid = 0;
+    }
+
+    std::optional<SteamProcess> SteamProcess::open(pid_t pid) {
+        const int fd = int(::syscall(SYS_pidfd_open, pid, 0));
+        if (fd < 0)
+            return std::nullopt;
+
+        SteamProcess process(fd, pid);
+
+        // Checking the process only after the pidfd got opened makes sure the pid didn't get reused in between
+        if (!isSteamProcess(pid) || !process.isRunning())
+            return std::nullopt;
+
+        return process;
+    }
+
+    std::optional<SteamProcess> SteamProcess::find() {
+        if (auto pid = parsePid(readSmallFile(getPidFilePath())); pid.has_value()) {
+            if (auto process = open(*pid); process.has_value())
+                return process;
+        }
+
+        // The pid file is left behind when Steam crashes, and its pid might've gotten reused since then
+        std::error_code error;
+        for (const auto &entry : std::fs::directory_iterator("/proc", error)) {
+            auto pid = parsePid(entry.path().filename().native());
+            if (!pid.has_value())
+                continue;
+
+            if (auto process = open(*pid); process.has_value())
+                return process;
+        }
+
+        return std::nullopt;
+    }
+
+    std::optional<SteamProcess> SteamProcess::waitForStart(std::chrono::milliseconds timeout) {
+        // The pid file can get written before the process took on its final name, e.g while steam.sh is still starting
+        // the client. It's checked again for a little while after every write instead of waiting for one that never comes
+        constexpr static auto StartupRetryInterval = 50ms;
+        constexpr static auto StartupRetryDuration = 5s;
+
+        const auto deadline = Clock::now() + timeout;
+
+        // Steam writes its pid file on startup. Start watching before looking for the process so the write can't be missed
+        fs::Watcher watcher;
+        const bool watching = watcher.watchFile(getPidFilePath());
+
+        auto retryDeadline = Clock::time_point::min();
+        while (true) {
+            if (auto process = find(); process.has_value())
+                return process;
+
+            const auto now       = Clock::now();
+            const auto remaining = std::chrono::ceil<std::chrono::milliseconds>(deadline - now);
+            if (!watching || remaining.count() <= 0)
+                return std::nullopt;
+
+            const bool retrying = now < retryDeadline;
+            const auto changes  = watcher.wait(retrying ? std::min<std::chrono::milliseconds>(remaining, StartupRetryInterval) : remaining, 0ms);
+
+            if (!changes.empty())
+                retryDeadline = Clock::now() + StartupRetryDuration;
+            else if (!retrying)
+                return find();
+        }
+    }
+
+    bool SteamProcess::isRunning() const {
+        if (!this->isValid())
+            return false;
+
+        pollfd pollDescriptor = { .fd = this->m_fd, .events = POLLIN, .revents = 0 };
+        return ::poll(&pollDescriptor, 1, 0) == 0;
+    }
+
+    bool SteamProcess::waitForExit(std::chrono::milliseconds timeout) const {
+        if (!this->isValid())
+            return true;
+
+        // A pidfd becomes readable once its process exited
+        return waitReadable(this->m_fd, Clock::now() + timeout);
+    }
+
+    std::optional<SteamProcess> SteamProcess::waitForRestart(std::chrono::milliseconds timeout) const {
+        const auto deadline = Clock::now() + timeout;
+
+        if (!this->waitForExit(timeout))
+            return std::nullopt;
+
+        const auto remaining = std::chrono::ceil<std::chrono::milliseconds>(deadline - Clock::now());
+        return waitForStart(std::max(remaining, 0ms));
+    }
+
+    bool SteamProcess::sendSignal(int signal) const {
+        if (!this->isValid())
+            return false;
+
+        if (::syscall(SYS_pidfd_send_signal, this->m_fd, signal, nullptr, 0) == 0)
+            return true;
+
+        // The process already being gone is what the caller wanted anyway
+        return errno == ESRCH;
+    }
+
+    bool SteamProcess::shutdown(std::chrono::milliseconds gracePeriod, std::chrono::milliseconds killTimeout) const {
+        if (!this->isRunning())
+            return true;
+
+        if (this->sendSignal(SIGTERM) && this->waitForExit(gracePeriod))
+            return true;
+
+        return this->sendSignal(SIGKILL) && this->waitForExit(killTimeout);
+    }
+
+    bool SteamProcess::kill(std::chrono::milliseconds timeout) const {
+        if (!this->isRunning())
+            return true;
+
+        return this->sendSignal(SIGKILL) && this->waitForExit(timeout);
+    }
+
+}
@@ -0,0 +1,130 @@
+#include <steam/api/storage.hpp>
+#include <steam/api/appid.hpp>
+
+#include <steam/file_formats/shortcut_scanner.hpp>
+
+#include <steam/helpers/mapped_file.hpp>
+
+#include <charconv>
+#include <optional>
+#include <unordered_set>
+
+namespace steam::api {
+
+    namespace {
+
+        std::optional<u32> parseAppId(const std::fs::path &folder) {
+            const auto name = folder.filename().native();
+
+            u32 appId = 0;
+            auto [end, error] = std::from_chars(name.data(), name.data() + name.size(), appId);
+            if (error != std::errc() || end != name.data() + name.size())
+                return std::nullopt;
+
+            return appId;
+        }
+
+        bool isShortcutAppId(u32 appId) {
+            return (appId & 0x8000'0000) != 0;
+        }
+
+        // Short appids of all shortcuts of all users. Returns std::nullopt if any shortcuts file couldn't be read,
+        // a prefix must never be reported as orphaned just because its shortcut couldn't be found
+        std::optional<std::unordered_set<u32>> queryShortcutAppIds() {
+            std::unordered_set<u32> appIds;
+
+            std::error_code error;
+            for (const auto &userFolder : std::fs::directory_iterator(fs::getSteamDirectory() / "userdata", error)) {
+                const auto shortcutsPath = userFolder.path() / "config" / "shortcuts.vdf";
+                if (!parseAppId(userFolder.path()).has_value() || !fs::exists(shortcutsPath))
+                    continue;
+
+                auto file = fs::MappedFile(shortcutsPath);
+                if (!file.isValid())
+                    return std::nullopt;
+
+                ShortcutScanner scanner(file.getBytes());
+                while (auto shortcut = scanner.next()) {
+                    if (shortcut->appId.has_value())
+                        appIds.insert(*shortcut->appId);
+                }
+
+                if (!scanner.isValid())
+                    return std::nullopt;
+            }
+
+            if (error)
+                return std::nullopt;
+
+            return appIds;
+        }
+
+    }
+
+    StorageReport scanStorage(const LibraryIndex &libraryIndex) {
+        enum class Kind { Install, CompatData, ShaderCache };
+
+        struct Root {
+            u32 appId;
+            Kind kind;
+        };
+
+        // Collect everything that needs measuring first so all of it gets spread across the same thread pool
+        std::vector<std::fs::path> paths;
+        std::vector<Root> roots;
+
+        for (const auto &[appId, game] : libraryIndex.getGames()) {
+            if (game.installDir.empty() || !fs::isDirectory(game.getInstallPath()))
+                continue;
+
+            paths.push_back(game.getInstallPath());
+            roots.push_back({ appId, Kind::Install });
+        }
+
+        for (const auto &library : libraryIndex.getLibraries()) {
+            for (const auto kind : { Kind::CompatData, Kind::ShaderCache }) {
+                std::error_code error;
+                for (const auto &folder : std::fs::directory_iterator(library / "steamapps" / (kind == Kind::CompatData ? "compatdata" : "shadercache"), error)) {
+                    auto appId = parseAppId(folder.path());
+                    if (!appId.has_value())
+                        continue;
+
+                    paths.push_back(folder.path());
+                    roots.push_back({ *appId, kind });
+                }
+            }
+        }
+
+        const auto usages = fs::measureDirectories(paths);
+
+        StorageReport report;
+        for (size_t i = 0; i < roots.size(); i++) {
+            auto &app = report.apps[roots[i].appId];
+
+            switch (roots[i].kind) {
+                case Kind::Install:     app.install     += usages[i]; break;
+                case Kind::CompatData:  app.compatData  += usages[i]; break;
+                case Kind::ShaderCache: app.shaderCache += usages[i]; break;
+            }
+        }
+
+        if (auto shortcutAppIds = queryShortcutAppIds(); shortcutAppIds.has_value()) {
+            for (size_t i = 0; i < roots.size(); i++) {
+                const auto &[appId, kind] = roots[i];
+
+                if (kind == Kind::CompatData && isShortcutAppId(appId) && !shortcutAppIds->contains(appId))
+                    report.orphanedPrefixes.push_back(paths[i]);
+            }
+        }
+
+        return report;
+    }
+
+    StorageReport scanStorage() {
+        LibraryIndex libraryIndex;
+        libraryIndex.refresh();
+
+        return scanStorage(libraryIndex);
+    }
+
+}
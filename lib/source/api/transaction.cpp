@@ -0,0 +1,215 @@
+#include <steam/api/transaction.hpp>
+#include <steam/api/shortcuts_store.hpp>
+
+#include <steam/file_formats/journal.hpp>
+
+#include <steam/helpers/hash.hpp>
+#include <steam/helpers/mapped_file.hpp>
+#include <steam/helpers/utils.hpp>
+
+namespace steam::api {
+
+    static std::fs::path getShortcutsFilePath(const User &user) {
+        return fs::getSteamDirectory() / "userdata" / std::to_string(user.getId()) / "config" / "shortcuts.vdf";
+    }
+
+    static std::fs::path getConfigFilePath() {
+        return fs::getSteamDirectory() / "config" / "config.vdf";
+    }
+
+    Transaction::Transaction() {
+        this->m_config.path = getConfigFilePath();
+        this->m_config.lock = fs::FileLock(this->m_config.path);
+    }
+
+    Transaction::Transaction(const User &user) {
+        // Always lock in the same order so two transactions can never deadlock each other
+        this->m_shortcuts.emplace();
+        this->m_shortcuts->path = getShortcutsFilePath(user);
+        this->m_shortcuts->lock = fs::FileLock(this->m_shortcuts->path);
+
+        this->m_config.path = getConfigFilePath();
+        this->m_config.lock = fs::FileLock(this->m_config.path);
+    }
+
+    template<typename Document>
+    Document* Transaction::load(LockedDocument<Document> &document) {
+        if (document.document.has_value())
+            return &*document.document;
+
+        if (document.failed || !document.lock.isLocked()) {
+            document.failed = true;
+            return nullptr;
+        }
+
+        auto file = fs::MappedFile(document.path);
+
+        // Make sure the file is intact before touching it, a failed parse would otherwise silently drop its contents
+        if constexpr (std::same_as<Document, VDF>) {
+            // Users that never added a shortcut don't have a shortcuts file yet
+            if (!file.isValid() && fs::exists(document.path)) {
+                document.failed = true;
+                return nullptr;
+            }
+
+            if (!file.getBytes().empty() && !VDF::validate(file.getBytes())) {
+                document.failed = true;
+                return nullptr;
+            }
+
+            document.document.emplace(file.getBytes());
+            document.checksum = crc32(file.getBytes());
+        } else {
+            if (!file.isValid() || !KeyValues::validate(file.getString())) {
+                document.failed = true;
+                return nullptr;
+            }
+
+            document.document.emplace(file.getString());
+            document.checksum = crc32(file.getString());
+        }
+
+        document.original = document.document;
+
+        return &*document.document;
+    }
+
+    VDF* Transaction::getShortcuts() {
+        if (!this->m_shortcuts.has_value())
+            return nullptr;
+
+        auto shortcuts = load(*this->m_shortcuts);
+        if (shortcuts != nullptr)
+            this->m_shortcuts->modified = true;
+
+        return shortcuts;
+    }
+
+    KeyValues* Transaction::getConfig() {
+        auto config = load(this->m_config);
+        if (config != nullptr)
+            this->m_config.modified = true;
+
+        return config;
+    }
+
+    std::optional<AppId> Transaction::addGameShortcut(const std::string &appName, const std::fs::path &exePath, const std::string &launchOptions, const std::vector<std::string> &tags, bool hidden) {
+        auto shortcuts = this->getShortcuts();
+        if (shortcuts == nullptr)
+            return std::nullopt;
+
+        return ShortcutsStore::addShortcut(*shortcuts, appName, exePath, launchOptions, tags, hidden);
+    }
+
+    bool Transaction::removeGameShortcut(const AppId &appId) {
+        auto shortcuts = this->getShortcuts();
+        if (shortcuts == nullptr)
+            return false;
+
+        // The index is only built on first use and kept up to date by every edit after that
+        auto index = ShortcutsStore::addAppIdIndex(*shortcuts);
+        if (index == nullptr)
+            return false;
+
+        return ShortcutsStore::removeShortcut(*shortcuts, *index, appId);
+    }
+
+    bool Transaction::enableProtonForApp(AppId appId, bool enabled) {
+        const CompatToolUpdate update = { .appId = appId, .enabled = enabled };
+
+        return this->setCompatTools({ &update, 1 });
+    }
+
+    bool Transaction::setCompatTools(std::span<const CompatToolUpdate> updates) {
+        auto config = this->getConfig();
+        if (config == nullptr)
+            return false;
+
+        auto &compatToolMapping = (*config)["InstallConfigStore"]["Software"]["Valve"]["Steam"]["CompatToolMapping"];
+
+        // Create or remove config entries for the tools
+        for (const auto &update : updates) {
+            // Shortcuts are mapped by the upper half of their appid, Steam games by their regular appid
+            const auto &appId = update.appId;
+            auto key = std::to_string(appId.getShortAppId() != 0 ? appId.getShortAppId() : u32(appId.getAppId()));
+
+            if (update.enabled) {
+                KeyValues::Set entry;
+
+                entry["name"]       = update.tool.name;
+                entry["config"]     = update.tool.config;
+                entry["Priority"]   = std::to_string(update.tool.priority);
+
+                compatToolMapping[key] = std::move(entry);
+            } else {
+                compatToolMapping.erase(key);
+            }
+        }
+
+        return true;
+    }
+
+    // Records the edit in the journal and replaces the file with its new contents
+    template<typename Document>
+    bool Transaction::write(LockedDocument<Document> &document, auto data) {
+        const auto checksum = crc32(data);
+
+        if (!Journal<Document>(document.path).record(*document.original, document.checksum, *document.document, checksum))
+            return false;
+
+        if (!fs::writeFileAtomic(document.path, data))
+            return false;
+
+        document.original = document.document;
+        document.checksum = checksum;
+        document.modified = false;
+
+        return true;
+    }
+
+    // Documents are handed out for arbitrary edits, so whether they really changed is only known by comparing them
+    static bool isChanged(const auto &document) {
+        return document.modified && document.document.has_value() && document.document != document.original;
+    }
+
+    bool Transaction::commit() {
+        const bool writeShortcuts = this->m_shortcuts.has_value() && isChanged(*this->m_shortcuts);
+        const bool writeConfig    = isChanged(this->m_config);
+
+        // Dump and check everything first so a broken document doesn't cause only some of the files to get written
+        std::vector<u8> shortcutsData;
+        if (writeShortcuts) {
+            shortcutsData = this->m_shortcuts->document->dump();
+            if (!VDF::validate(shortcutsData))
+                return false;
+        }
+
+        std::string configData;
+        if (writeConfig) {
+            configData = this->m_config.document->dump();
+            if (!KeyValues::validate(configData))
+                return false;
+        }
+
+        if (writeShortcuts && !write(*this->m_shortcuts, std::span<const u8>(shortcutsData)))
+            return false;
+
+        if (writeConfig && !write(this->m_config, std::string_view(configData)))
+            return false;
+
+        return true;
+    }
+
+    void Transaction::rollback() {
+        if (this->m_shortcuts.has_value()) {
+            this->m_shortcuts->document.reset();
+            this->m_shortcuts->original.reset();
+            this->m_shortcuts->modified = false;
+        }
+
+        this->m_config.document.reset();
+        this->m_config.original.reset();
+        this->m_config.modified = false;
+    }
+
+}
@@ -0,0 +1,184 @@
+#include <steam/api/user.hpp>
+
+#include <steam/file_formats/keyvalues.hpp>
+
+#include <steam/helpers/mapped_file.hpp>
+#include <steam/helpers/parallel.hpp>
+
+#include <algorithm>
+#include <charconv>
+#include <mutex>
+#include <optional>
+
+namespace steam::api {
+
+    namespace {
+
+        template<typename T>
+        std::optional<T> parseInteger(std::string_view string) {
+            T result = 0;
+            auto [end, error] = std::from_chars(string.data(), string.data() + string.size(), result);
+            if (error != std::errc() || end != string.data() + string.size())
+                return std::nullopt;
+
+            return result;
+        }
+
+        // Walks down a path of keys without creating anything along the way
+        const KeyValues::Value* findPath(const KeyValues::Set &root, std::initializer_list<std::string_view> path) {
+            const KeyValues::Set *set = &root;
+            const KeyValues::Value *value = nullptr;
+
+            for (const auto key : path) {
+                if (set == nullptr)
+                    return nullptr;
+
+                auto it = set->find(key);
+                if (it == set->end())
+                    return nullptr;
+
+                value = &it->second;
+                set   = value->isSet() ? &value->set() : nullptr;
+            }
+
+            return value;
+        }
+
+        std::optional<KeyValues> loadKeyValues(const std::fs::path &path) {
+            auto file = fs::MappedFile(path);
+            if (!file.isValid() || !KeyValues::validate(file.getString()))
+                return std::nullopt;
+
+            return KeyValues(file.getString());
+        }
+
+        std::fs::file_time_type getModificationTime(const std::fs::path &path) {
+            std::error_code error;
+            auto time = std::fs::last_write_time(path, error);
+            if (error)
+                return { };
+
+            return time;
+        }
+
+        std::string queryLocalConfigName(u32 userId) {
+            auto localConfig = loadKeyValues(fs::getSteamDirectory() / "userdata" / std::to_string(userId) / "config" / "localconfig.vdf");
+            if (!localConfig.has_value())
+                return { };
+
+            auto name = findPath(localConfig->get(), { "UserLocalConfigStore", "friends", std::to_string(userId), "name" });
+            if (name == nullptr || !name->isString())
+                return { };
+
+            return std::string(name->string());
+        }
+
+        struct UserCache {
+            std::mutex mutex;
+            std::fs::file_time_type loginUsersTime, userDataTime;
+            std::optional<std::vector<User>> users;
+        };
+
+        UserCache& getUserCache() {
+            static UserCache cache;
+
+            return cache;
+        }
+
+    }
+
+    std::string User::queryUserName(u32 userId) {
+        if (auto loginUsers = queryLoginUsers(); loginUsers.contains(userId))
+            return loginUsers[userId];
+
+        return queryLocalConfigName(userId);
+    }
+
+    std::unordered_map<u32, std::string> User::queryLoginUsers() {
+        auto loginUsers = loadKeyValues(fs::getSteamDirectory() / "config" / "loginusers.vdf");
+        if (!loginUsers.has_value())
+            return { };
+
+        auto users = findPath(loginUsers->get(), { "users" });
+        if (users == nullptr || !users->isSet())
+            return { };
+
+        std::unordered_map<u32, std::string> result;
+        for (const auto &[key, value] : users->set()) {
+            // Accounts are listed by their SteamID64, userdata folders are named after the account id in its lower half
+            auto steamId = parseInteger<u64>(key.view());
+            if (!steamId.has_value() || !value.isSet())
+                continue;
+
+            auto name = findPath(value.set(), { "PersonaName" });
+            if (name == nullptr || !name->isString())
+                continue;
+
+            result.emplace(u32(*steamId), std::string(name->string()));
+        }
+
+        return result;
+    }
+
+    std::vector<User> User::getUsers() {
+        auto &cache = getUserCache();
+        std::scoped_lock lock(cache.mutex);
+
+        const auto steamDirectory = fs::getSteamDirectory();
+        const auto loginUsersTime = getModificationTime(steamDirectory / "config" / "loginusers.vdf");
+        const auto userDataTime   = getModificationTime(steamDirectory / "userdata");
+
+        if (cache.users.has_value() && cache.loginUsersTime == loginUsersTime && cache.userDataTime == userDataTime)
+            return *cache.users;
+
+        std::vector<u32> userIds;
+        {
+            std::error_code error;
+            for (const auto &folder : std::fs::directory_iterator(steamDirectory / "userdata", error)) {
+                auto userId = parseInteger<u32>(folder.path().filename().native());
+                if (!userId.has_value() || *userId == 0)
+                    continue;
+
+                userIds.push_back(*userId);
+            }
+        }
+
+        std::sort(userIds.begin(), userIds.end());
+
+        auto loginUsers = queryLoginUsers();
+
+        std::vector<std::string> names(userIds.size());
+        std::vector<size_t> unknownUsers;
+        for (size_t i = 0; i < userIds.size(); i++) {
+            if (auto it = loginUsers.find(userIds[i]); it != loginUsers.end())
+                names[i] = std::move(it->second);
+            else
+                unknownUsers.push_back(i);
+        }
+
+        // Only users that never logged in through this Steam installation need their localconfig.vdf parsed
+        parallelFor(unknownUsers.size(), [&](size_t i) {
+            names[unknownUsers[i]] = queryLocalConfigName(userIds[unknownUsers[i]]);
+        });
+
+        std::vector<User> users;
+        for (size_t i = 0; i < userIds.size(); i++) {
+            if (!names[i].empty())
+                users.emplace_back(userIds[i], std::move(names[i]));
+        }
+
+        cache.users          = users;
+        cache.loginUsersTime = loginUsersTime;
+        cache.userDataTime   = userDataTime;
+
+        return users;
+    }
+
+    void User::refreshUsers() {
+        auto &cache = getUserCache();
+        std::scoped_lock lock(cache.mutex);
+
+        cache.users.reset();
+    }
+
+}
@@ -0,0 +1,149 @@
+#include <steam/file_formats/document_watcher.hpp>
+
+#include <steam/helpers/mapped_file.hpp>
+
+#include <optional>
+
+#include <sys/stat.h>
+
+namespace steam {
+
+    template<typename Document>
+    DocumentWatcher<Document>::DocumentWatcher(const std::fs::path &path, std::chrono::milliseconds debounce) : m_path(path), m_debounce(debounce) {
+        // Without a watch nothing would ever get reported, so the watcher is marked as invalid instead
+        if (!this->m_watcher.watchFile(path)) {
+            this->m_watcher.close();
+            return;
+        }
+
+        this->reload();
+    }
+
+    template<typename Document>
+    DocumentWatcher<Document>::~DocumentWatcher() {
+        this->stop();
+    }
+
+    template<typename Document>
+    u32 DocumentWatcher<Document>::subscribe(Callback callback) {
+        std::scoped_lock lock(this->m_subscriberMutex);
+
+        auto id = this->m_nextSubscriberId++;
+        this->m_subscribers.emplace(id, std::move(callback));
+
+        return id;
+    }
+
+    template<typename Document>
+    bool DocumentWatcher<Document>::unsubscribe(u32 id) {
+        std::scoped_lock lock(this->m_subscriberMutex);
+
+        return this->m_subscribers.erase(id) > 0;
+    }
+
+    template<typename Document>
+    Document DocumentWatcher<Document>::getDocument() const {
+        std::scoped_lock lock(this->m_documentMutex);
+
+        return this->m_document;
+    }
+
+    template<typename Document>
+    bool DocumentWatcher<Document>::reload() {
+        struct stat64 status = { };
+        if (::stat64(this->m_path.c_str(), &status) != 0)
+            return false;
+
+        const FileIdentity identity = {
+            .device             = status.st_dev,
+            .inode              = status.st_ino,
+            .size               = u64(status.st_size),
+            .modificationTime   = status.st_mtim.tv_sec * 1'000'000'000 + status.st_mtim.tv_nsec
+        };
+
+        // Events that didn't actually modify the file, e.g closing it after opening it for writing, don't need a reparse
+        if (identity == this->m_identity)
+            return false;
+
+        auto file = fs::MappedFile(this->m_path);
+        if (!file.isValid())
+            return false;
+
+        // The file might still be in the middle of getting written, the next event will pick up the complete version
+        std::optional<Document> document;
+        if constexpr (std::same_as<Document, VDF>) {
+            if (file.getSize() != 0 && !VDF::validate(file.getBytes()))
+                return false;
+
+            document.emplace(file.getBytes());
+        } else {
+            if (!KeyValues::validate(file.getString()))
+                return false;
+
+            document.emplace(file.getString());
+        }
+
+        file.close();
+
+        const auto changes = diffDocuments(this->m_document.get(), document->get());
+
+        {
+            std::scoped_lock lock(this->m_documentMutex);
+
+            this->m_document = std::move(*document);
+            this->m_identity = identity;
+        }
+
+        if (changes.empty())
+            return true;
+
+        std::vector<Callback> subscribers;
+        {
+            std::scoped_lock lock(this->m_subscriberMutex);
+
+            for (const auto &[id, callback] : this->m_subscribers)
+                subscribers.push_back(callback);
+        }
+
+        // Only this thread ever replaces the document, so it can be handed out without holding the lock
+        for (const auto &callback : subscribers)
+            callback(this->m_document, changes);
+
+        return true;
+    }
+
+    template<typename Document>
+    bool DocumentWatcher<Document>::process(std::chrono::milliseconds timeout) {
+        // Lost events after a queue overflow report the file as changed too, reload() only reparses it if it really was
+        if (this->m_watcher.wait(timeout, this->m_debounce).empty())
+            return false;
+
+        return this->reload();
+    }
+
+    template<typename Document>
+    void DocumentWatcher<Document>::start() {
+        if (this->m_thread.joinable() || !this->isValid())
+            return;
+
+        this->m_thread = std::jthread([this](std::stop_token stopToken) {
+            constexpr static auto PollInterval = std::chrono::milliseconds(250);
+
+            while (!stopToken.stop_requested())
+                this->process(PollInterval);
+        });
+    }
+
+    template<typename Document>
+    void DocumentWatcher<Document>::stop() {
+        if (!this->m_thread.joinable())
+            return;
+
+        this->m_thread.request_stop();
+        this->m_thread.join();
+    }
+
+    template class DocumentWatcher<VDF>;
+    template class DocumentWatcher<KeyValues>;
+
+}
@@ -0,0 +1,647 @@
+#include <steam/file_formats/journal.hpp>
+
+#include <steam/helpers/file.hpp>
+#include <steam/helpers/hash.hpp>
+#include <steam/helpers/utils.hpp>
+
+#include <chrono>
+#include <cstring>
+#include <map>
+#include <mutex>
+
+#include <sys/stat.h>
+
+namespace steam {
+
+    namespace {
+
+        constexpr static char Magic[4] = { 'S', 'J', 'N', 'L' };
+        constexpr static u32 Version = 1;
+        constexpr static size_t HeaderSize = sizeof(Magic) + sizeof(u32) + sizeof(u32);
+        constexpr static size_t EntryHeaderSize = sizeof(u32) + sizeof(u32);
+
+        // Both files are only ever replaced or appended to, so any change to them changes their identity as well
+        struct FileIdentity {
+            u64 device = 0, inode = 0, size = 0;
+            i64 modificationTime = 0;
+
+            bool operator==(const FileIdentity &other) const = default;
+        };
+
+        std::optional<FileIdentity> queryIdentity(const std::fs::path &path) {
+            struct stat64 status = { };
+            if (::stat64(path.c_str(), &status) != 0)
+                return std::nullopt;
+
+            return FileIdentity {
+                .device             = status.st_dev,
+                .inode              = status.st_ino,
+                .size               = u64(status.st_size),
+                .modificationTime   = status.st_mtim.tv_sec * 1'000'000'000 + status.st_mtim.tv_nsec
+            };
+        }
+
+        template<typename State>
+        struct CachedState {
+            FileIdentity baseline;
+            std::optional<FileIdentity> journal;
+            State state;
+        };
+
+        template<typename State>
+        struct StateCache {
+            std::mutex mutex;
+            std::map<std::fs::path, CachedState<State>> entries;
+        };
+
+        template<typename State>
+        StateCache<State>& getStateCache() {
+            static StateCache<State> cache;
+
+            return cache;
+        }
+
+        enum class ValueTag : u8 {
+            Set,
+            String,
+            Integer
+        };
+
+        class ByteWriter {
+        public:
+            explicit ByteWriter(std::vector<u8> &buffer) : m_buffer(buffer) { }
+
+            void write(u8 value) {
+                this->m_buffer.push_back(value);
+            }
+
+            void write(u32 value) {
+                this->writeRaw(&value, sizeof(value));
+            }
+
+            void write(u64 value) {
+                this->writeRaw(&value, sizeof(value));
+            }
+
+            void write(std::string_view string) {
+                this->write(u32(string.size()));
+                this->writeRaw(string.data(), string.size());
+            }
+
+            void writeRaw(const void *data, size_t size) {
+                auto bytes = static_cast<const u8 *>(data);
+                this->m_buffer.insert(this->m_buffer.end(), bytes, bytes + size);
+            }
+
+        private:
+            std::vector<u8> &m_buffer;
+        };
+
+        class ByteReader {
+        public:
+            explicit ByteReader(std::span<const u8> data) : m_data(data) { }
+
+            template<typename T>
+            std::optional<T> read() {
+                if (this->m_data.size() - this->m_offset < sizeof(T))
+                    return std::nullopt;
+
+                T value;
+                std::memcpy(&value, this->m_data.data() + this->m_offset, sizeof(T));
+                this->m_offset += sizeof(T);
+
+                return value;
+            }
+
+            std::optional<std::string_view> readString() {
+                auto size = this->read<u32>();
+                if (!size.has_value() || this->m_data.size() - this->m_offset < *size)
+                    return std::nullopt;
+
+                std::string_view string(reinterpret_cast<const char *>(this->m_data.data() + this->m_offset), *size);
+                this->m_offset += *size;
+
+                return string;
+            }
+
+        private:
+            std::span<const u8> m_data;
+            size_t m_offset = 0;
+        };
+
+        template<typename Value>
+        using SetOf = std::remove_cvref_t<decltype(std::declval<const Value &>().set())>;
+
+        template<typename Value>
+        void encodeValue(ByteWriter &writer, const Value &value) {
+            value.visit(overloaded {
+                [&](std::string_view string) {
+                    writer.write(u8(ValueTag::String));
+                    writer.write(string);
+                },
+                [&](u32 integer) {
+                    writer.write(u8(ValueTag::Integer));
+                    writer.write(integer);
+                },
+                [&](const SetOf<Value> &set) {
+                    writer.write(u8(ValueTag::Set));
+                    writer.write(u32(set.size()));
+
+                    for (const auto &[key, child] : set) {
+                        writer.write(key.view());
+                        encodeValue(writer, child);
+                    }
+                }
+            });
+        }
+
+        template<typename Value>
+        std::optional<Value> decodeValue(ByteReader &reader) {
+            auto tag = reader.read<u8>();
+            if (!tag.has_value())
+                return std::nullopt;
+
+            Value value;
+            switch (ValueTag(*tag)) {
+                case ValueTag::String: {
+                    auto string = reader.readString();
+                    if (!string.has_value())
+                        return std::nullopt;
+
+                    value = *string;
+                    return value;
+                }
+                case ValueTag::Integer: {
+                    if constexpr (std::same_as<Value, VDF::Value>) {
+                        auto integer = reader.read<u32>();
+                        if (!integer.has_value())
+                            return std::nullopt;
+
+                        value = *integer;
+                        return value;
+                    } else {
+                        return std::nullopt;
+                    }
+                }
+                case ValueTag::Set: {
+                    auto count = reader.read<u32>();
+                    if (!count.has_value())
+                        return std::nullopt;
+
+                    SetOf<Value> set;
+                    for (u32 i = 0; i < *count; i++) {
+                        auto key = reader.readString();
+                        if (!key.has_value())
+                            return std::nullopt;
+
+                        auto child = decodeValue<Value>(reader);
+                        if (!child.has_value())
+                            return std::nullopt;
+
+                        set.emplace(*key, std::move(*child));
+                    }
+
+                    value = std::move(set);
+                    return value;
+                }
+                default:
+                    return std::nullopt;
+            }
+        }
+
+        template<typename Document>
+        std::optional<Document> parseDocument(std::span<const u8> data) {
+            if constexpr (std::same_as<Document, VDF>) {
+                if (!data.empty() && !VDF::validate(data))
+                    return std::nullopt;
+
+                return Document(data);
+            } else {
+                std::string_view string(reinterpret_cast<const char *>(data.data()), data.size());
+                if (!KeyValues::validate(string))
+                    return std::nullopt;
+
+                return Document(string);
+            }
+        }
+
+        std::vector<u8> dumpDocument(const VDF &document) {
+            return document.dump();
+        }
+
+        std::vector<u8> dumpDocument(const KeyValues &document) {
+            auto string = document.dump();
+            return { string.begin(), string.end() };
+        }
+
+        std::vector<u8> createHeader(u32 baselineChecksum) {
+            std::vector<u8> header;
+            ByteWriter writer(header);
+
+            writer.writeRaw(Magic, sizeof(Magic));
+            writer.write(Version);
+            writer.write(baselineChecksum);
+
+            return header;
+        }
+
+        // Applies a single change to a set. Parents of changed nodes are always present in the previous version
+        template<typename Set>
+        bool applyChange(Set &root, u8 kind, const std::vector<std::string_view> &path, std::optional<typename Set::mapped_type> &&value) {
+            Set *set = &root;
+            for (size_t i = 0; i + 1 < path.size(); i++) {
+                auto it = set->find(path[i]);
+                if (it == set->end() || !it->second.isSet())
+                    return false;
+
+                set = &it->second.set();
+            }
+
+            using Kind = typename DocumentChange<typename Set::mapped_type>::Kind;
+            switch (Kind(kind)) {
+                case Kind::Removed:
+                    return set->erase(path.back()) > 0;
+                case Kind::Added:
+                case Kind::Modified: {
+                    if (!value.has_value())
+                        return false;
+
+                    auto it = set->lower_bound(path.back());
+                    if (it == set->end() || it->first != path.back())
+                        it = set->emplace_hint(it, path.back(), std::move(*value));
+                    else
+                        it->second = std::move(*value);
+
+                    return true;
+                }
+                default:
+                    return false;
+            }
+        }
+
+    }
+
+    template<typename Document>
+    Journal<Document>::Journal(const std::fs::path &path) : m_path(path) {
+        this->m_journalPath  = path;
+        this->m_journalPath += ".journal";
+        this->m_baselinePath  = path;
+        this->m_baselinePath += ".orig";
+    }
+
+    template<typename Document>
+    auto Journal<Document>::readState() const -> std::optional<State> {
+        const auto baselineIdentity = queryIdentity(this->m_baselinePath);
+        if (!baselineIdentity.has_value())
+            return std::nullopt;
+
+        const auto journalIdentity = queryIdentity(this->m_journalPath);
+
+        auto &cache = getStateCache<State>();
+        std::optional<u32> baselineChecksum;
+        {
+            std::scoped_lock lock(cache.mutex);
+
+            auto it = cache.entries.find(this->m_path);
+            if (it != cache.entries.end() && it->second.baseline == *baselineIdentity) {
+                if (it->second.journal == journalIdentity)
+                    return it->second.state;
+
+                baselineChecksum = it->second.state.baselineChecksum;
+            }
+        }
+
+        State state;
+        if (baselineChecksum.has_value()) {
+            state.baselineChecksum = *baselineChecksum;
+        } else {
+            auto baselineFile = fs::File(this->m_baselinePath, fs::File::Mode::Read);
+            if (!baselineFile.isValid())
+                return std::nullopt;
+
+            state.baselineChecksum = crc32(baselineFile.readBytes());
+        }
+
+        auto journalFile = fs::File(this->m_journalPath, fs::File::Mode::Read);
+        if (!journalFile.isValid()) {
+            this->storeState(state);
+            return state;
+        }
+
+        const auto journal = journalFile.readBytes();
+
+        // A journal belonging to a different baseline is left over from an interrupted compaction and can't be used anymore
+        if (journal.size() < HeaderSize || std::memcmp(journal.data(), createHeader(state.baselineChecksum).data(), HeaderSize) != 0) {
+            this->storeState(state);
+            return state;
+        }
+
+        state.validEnd = HeaderSize;
+
+        // Stop at the first entry that's incomplete or corrupted, it was being written when the process got interrupted
+        ByteReader reader(std::span<const u8>(journal).subspan(HeaderSize));
+        while (true) {
+            const u64 offset = state.validEnd;
+
+            auto payloadSize     = reader.read<u32>();
+            auto payloadChecksum = reader.read<u32>();
+            if (!payloadSize.has_value() || !payloadChecksum.has_value())
+                break;
+
+            if (journal.size() - offset - EntryHeaderSize < *payloadSize || *payloadSize < sizeof(u64) + sizeof(u32))
+                break;
+
+            auto payload = std::span<const u8>(journal).subspan(offset + EntryHeaderSize, *payloadSize);
+            if (crc32(payload) != *payloadChecksum)
+                break;
+
+            u32 resultChecksum;
+            std::memcpy(&resultChecksum, payload.data() + sizeof(u64), sizeof(resultChecksum));
+
+            state.entries.push_back({ offset, *payloadSize, resultChecksum });
+            state.validEnd = offset + EntryHeaderSize + *payloadSize;
+
+            reader = ByteReader(std::span<const u8>(journal).subspan(state.validEnd));
+        }
+
+        this->storeState(state);
+
+        return state;
+    }
+
+    template<typename Document>
+    void Journal<Document>::storeState(const State &state) const {
+        const auto baselineIdentity = queryIdentity(this->m_baselinePath);
+        if (!baselineIdentity.has_value())
+            return;
+
+        auto &cache = getStateCache<State>();
+        std::scoped_lock lock(cache.mutex);
+
+        cache.entries.insert_or_assign(this->m_path, CachedState<State> { *baselineIdentity, queryIdentity(this->m_journalPath), state });
+    }
+
+    template<typename Document>
+    std::optional<Document> Journal<Document>::replay(const State &state, size_t entryCount) const {
+        if (entryCount > state.entries.size())
+            return std::nullopt;
+
+        auto baselineFile = fs::File(this->m_baselinePath, fs::File::Mode::Read);
+        if (!baselineFile.isValid())
+            return std::nullopt;
+
+        auto document = parseDocument<Document>(baselineFile.readBytes());
+        if (!document.has_value())
+            return std::nullopt;
+
+        std::vector<u8> journal;
+        if (entryCount > 0) {
+            auto journalFile = fs::File(this->m_journalPath, fs::File::Mode::Read);
+            if (!journalFile.isValid())
+                return std::nullopt;
+
+            journal = journalFile.readBytes();
+            if (journal.size() < state.validEnd)
+                return std::nullopt;
+        }
+
+        using Value = typename Document::Value;
+
+        for (size_t i = 0; i < entryCount; i++) {
+            const auto &entry = state.entries[i];
+            ByteReader reader(std::span<const u8>(journal).subspan(entry.offset + EntryHeaderSize + sizeof(u64) + sizeof(u32), entry.size - sizeof(u64) - sizeof(u32)));
+
+            auto changeCount = reader.read<u32>();
+            if (!changeCount.has_value())
+                return std::nullopt;
+
+            for (u32 change = 0; change < *changeCount; change++) {
+                auto kind       = reader.read<u8>();
+                auto pathLength = reader.read<u32>();
+                if (!kind.has_value() || !pathLength.has_value() || *pathLength == 0)
+                    return std::nullopt;
+
+                std::vector<std::string_view> path;
+                for (u32 segment = 0; segment < *pathLength; segment++) {
+                    auto key = reader.readString();
+                    if (!key.has_value())
+                        return std::nullopt;
+
+                    path.push_back(*key);
+                }
+
+                std::optional<Value> value;
+                if (*kind != u8(DocumentChange<Value>::Kind::Removed)) {
+                    value = decodeValue<Value>(reader);
+                    if (!value.has_value())
+                        return std::nullopt;
+                }
+
+                if (!applyChange(document->get(), *kind, path, std::move(value)))
+                    return std::nullopt;
+            }
+        }
+
+        return document;
+    }
+
+    template<typename Document>
+    bool Journal<Document>::resetBaseline(const Document &document) {
+        const auto data = dumpDocument(document);
+
+        // Write the journal first. If we get interrupted in between, its header won't match the old baseline anymore
+        if (!fs::writeFileAtomic(this->m_journalPath, createHeader(crc32(data))))
+            return false;
+
+        return fs::writeFileAtomic(this->m_baselinePath, data);
+    }
+
+    template<typename Document>
+    bool Journal<Document>::append(State &state, const std::vector<DocumentChange<typename Document::Value>> &changes, u32 resultChecksum) {
+        std::vector<u8> payload;
+        ByteWriter writer(payload);
+
+        const auto timestamp = std::chrono::duration_cast<std::chrono::seconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+        writer.write(u64(timestamp));
+        writer.write(resultChecksum);
+        writer.write(u32(changes.size()));
+
+        for (const auto &change : changes) {
+            writer.write(u8(change.kind));
+            writer.write(u32(change.path.size()));
+            for (const auto &segment : change.path)
+                writer.write(segment);
+
+            if (change.newValue.has_value())
+                encodeValue(writer, *change.newValue);
+        }
+
+        // A journal that's missing or doesn't belong to the baseline is started over
+        const u64 writeOffset = state.validEnd;
+
+        std::vector<u8> entry;
+        if (writeOffset == 0)
+            entry = createHeader(state.baselineChecksum);
+
+        ByteWriter entryWriter(entry);
+        entryWriter.write(u32(payload.size()));
+        entryWriter.write(crc32(payload));
+        entryWriter.writeRaw(payload.data(), payload.size());
+
+        auto file = fs::File(this->m_journalPath, fs::File::Mode::Write);
+        if (!file.isValid())
+            return false;
+
+        // Cut off whatever is left of an entry that didn't get written completely
+        file.setSize(writeOffset);
+        if (!file.writeAt(writeOffset, entry.data(), entry.size()) || !file.sync())
+            return false;
+
+        if (writeOffset == 0)
+            state.validEnd = HeaderSize;
+
+        state.entries.push_back({ state.validEnd, u32(payload.size()), resultChecksum });
+        state.validEnd += EntryHeaderSize + payload.size();
+
+        this->storeState(state);
+
+        return true;
+    }
+
+    template<typename Document>
+    bool Journal<Document>::record(const Document &previous, u32 previousChecksum, const Document &current, u32 currentChecksum) {
+        // Keep the untouched file around as the baseline on the first edit
+        if (!fs::exists(this->m_baselinePath)) {
+            const bool created = fs::exists(this->m_path) ? fs::backupFile(this->m_path, this->m_baselinePath) : this->resetBaseline(previous);
+            if (!created)
+                return false;
+        }
+
+        auto state = this->readState();
+        if (!state.has_value())
+            return false;
+
+        // The file got changed behind our back since the last recorded edit. Record that change as well so replaying stays accurate
+        const auto lastChecksum = state->entries.empty() ? state->baselineChecksum : state->entries.back().resultChecksum;
+        if (lastChecksum != previousChecksum) {
+            auto reconstructed = this->replay(*state, state->entries.size());
+            if (!reconstructed.has_value()) {
+                if (!this->resetBaseline(previous))
+                    return false;
+
+                state = this->readState();
+                if (!state.has_value())
+                    return false;
+            } else {
+                // Only the formatting differs, e.g after the baseline got serialized from a document
+                auto external = diffDocuments(reconstructed->get(), previous.get());
+                if (!external.empty() && !this->append(*state, external, previousChecksum))
+                    return false;
+            }
+        }
+
+        auto changes = diffDocuments(previous.get(), current.get());
+        if (changes.empty())
+            return true;
+
+        if (!this->append(*state, changes, currentChecksum))
+            return false;
+
+        if (state->entries.size() > MaxEntryCount)
+            return this->compact();
+
+        return true;
+    }
+
+    template<typename Document>
+    size_t Journal<Document>::getEntryCount() const {
+        auto state = this->readState();
+        if (!state.has_value())
+            return 0;
+
+        return state->entries.size();
+    }
+
+    template<typename Document>
+    std::optional<Document> Journal<Document>::reconstruct(size_t entryCount) const {
+        auto state = this->readState();
+        if (!state.has_value())
+            return std::nullopt;
+
+        return this->replay(*state, entryCount);
+    }
+
+    template<typename Document>
+    bool Journal<Document>::restore(size_t entryCount) {
+        auto state = this->readState();
+        if (!state.has_value())
+            return false;
+
+        auto document = this->replay(*state, entryCount);
+        if (!document.has_value())
+            return false;
+
+        if (!fs::writeFileAtomic(this->m_path, dumpDocument(*document)))
+            return false;
+
+        if (entryCount == state->entries.size())
+            return true;
+
+        auto file = fs::File(this->m_journalPath, fs::File::Mode::Write);
+        if (!file.isValid())
+            return false;
+
+        file.setSize(state->entries[entryCount].offset);
+
+        return file.sync();
+    }
+
+    template<typename Document>
+    bool Journal<Document>::undo() {
+        auto entryCount = this->getEntryCount();
+        if (entryCount == 0)
+            return false;
+
+        return this->restore(entryCount - 1);
+    }
+
+    template<typename Document>
+    bool Journal<Document>::compact(size_t keepEntries) {
+        auto state = this->readState();
+        if (!state.has_value())
+            return false;
+
+        if (state->entries.size() <= keepEntries)
+            return true;
+
+        const auto foldedEntries = state->entries.size() - keepEntries;
+
+        auto baseline = this->replay(*state, foldedEntries);
+        if (!baseline.has_value())
+            return false;
+
+        const auto baselineData = dumpDocument(*baseline);
+
+        auto journalFile = fs::File(this->m_journalPath, fs::File::Mode::Read);
+        if (!journalFile.isValid())
+            return false;
+
+        const auto previousJournal = journalFile.readBytes();
+        if (previousJournal.size() < state->validEnd)
+            return false;
+
+        // Write the journal first. If we get interrupted in between, its header won't match the old baseline anymore
+        auto journal = createHeader(crc32(baselineData));
+        const auto keptBegin = previousJournal.begin() + state->entries[foldedEntries].offset;
+        journal.insert(journal.end(), keptBegin, previousJournal.begin() + state->validEnd);
+
+        if (!fs::writeFileAtomic(this->m_journalPath, journal))
+            return false;
+
+        return fs::writeFileAtomic(this->m_baselinePath, baselineData);
+    }
+
+    template class Journal<VDF>;
+    template class Journal<KeyValues>;
+
+}
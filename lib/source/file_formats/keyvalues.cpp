@@ -1,61 +1,127 @@
 #include <steam/file_formats/keyvalues.hpp>
 
 #include <steam/helpers/utils.hpp>
+#include <steam/helpers/parallel.hpp>
 
-#include <codecvt>
+#include <cctype>
+#include <unordered_set>
 
 #include <fmt/format.h>
 
 namespace steam {
 
-    std::pair<KeyValues::KeyValuePair, size_t> parseElement(std::u32string_view data);
-    std::string dumpElement(const std::string &key, const KeyValues::Value &value, u32 indent);
+    KeyValues::KeyValues(const KeyValues &other) : m_content(other.m_content) {
+        for (const auto &index : other.m_indexes)
+            this->addIndex(index->getPattern());
+    }
+
+    KeyValues::KeyValues(KeyValues &&other) noexcept : m_content(std::move(other.m_content)), m_indexes(std::move(other.m_indexes)) {
+        for (auto &index : this->m_indexes)
+            index->setRoot(this->m_content);
+    }
+
+    KeyValues& KeyValues::operator=(const KeyValues &other) {
+        if (this == &other)
+            return *this;
+
+        this->m_indexes.clear();
+        this->m_content = other.m_content;
+
+        for (const auto &index : other.m_indexes)
+            this->addIndex(index->getPattern());
+
+        return *this;
+    }
+
+    KeyValues& KeyValues::operator=(KeyValues &&other) noexcept {
+        this->m_indexes = std::move(other.m_indexes);
+        this->m_content = std::move(other.m_content);
+
+        for (auto &index : this->m_indexes)
+            index->setRoot(this->m_content);
+
+        return *this;
+    }
+
+    const KeyValues::Index* KeyValues::addIndex(const std::string &pattern) {
+        if (auto index = this->getIndex(pattern); index != nullptr)
+            return index;
+
+        auto parsedPattern = Index::parsePattern(pattern);
+        if (!parsedPattern.has_value())
+            return nullptr;
 
-    std::pair<std::u32string, size_t> parseString(std::u32string_view data) {
-        std::u32string result;
+        auto &[segments, wildcard] = *parsedPattern;
+        return this->m_indexes.emplace_back(std::make_unique<Index>(this->m_content, std::move(segments), wildcard)).get();
+    }
+
+    bool KeyValues::removeIndex(const std::string &pattern) {
+        return std::erase_if(this->m_indexes, [&](const auto &index) {
+            if (index->getPattern() != pattern)
+                return false;
+
+            index->detach();
+            return true;
+        }) > 0;
+    }
+
+    const KeyValues::Index* KeyValues::getIndex(const std::string &pattern) const {
+        for (const auto &index : this->m_indexes) {
+            if (index->getPattern() == pattern)
+                return index.get();
+        }
+
+        return nullptr;
+    }
+
+    void KeyValues::reindex() {
+        for (auto &index : this->m_indexes)
+            index->rebuild();
+    }
+
+    // All characters with a meaning in the format are ASCII and bytes of multi-byte UTF-8 sequences never are,
+    // so the input is parsed as raw bytes without decoding it first
+    std::pair<KeyValues::KeyValuePair, size_t> parseElement(std::string_view data);
+
+    std::pair<std::string, size_t> parseString(std::string_view data) {
+        std::string result;
         size_t advance = 0;
 
         if (!data.starts_with('"'))
             return { { }, 0 };
 
-        for (u32 i = 1; i < data.length(); i++) {
+        for (size_t i = 1; i < data.length(); i++) {
             advance++;
             auto character = data[i];
 
-            if (character < 0x7F) {
-                // If this is an ASCII character...
+            if (character == '\\') {
+                if (i == (data.length() - 1))
+                    return { { }, 0 };
 
-                if (character == '\\') {
-                    if (i == (data.length() - 1))
-                        return { { }, 0 };
-
-                    switch (data[i + 1]) {
-                        case 'n': result += '\n'; break;
-                        case 't': result += '\t'; break;
-                        case '\\': result += '\\'; break;
-                        case '"': result += '"'; break;
-                        default: return { { }, 0 };
-                    }
-                    i++;
-                    advance++;
-                } else if (character == '"') {
-                    break;
-                } else {
-                    result += character;
+                switch (data[i + 1]) {
+                    case 'n': result += '\n'; break;
+                    case 't': result += '\t'; break;
+                    case '\\': result += '\\'; break;
+                    case '"': result += '"'; break;
+                    default: return { { }, 0 };
                 }
+                i++;
+                advance++;
+            } else if (character == '"') {
+                break;
             } else {
                 result += character;
             }
         }
 
-        return { result, advance + 1 };
+        return { std::move(result), advance + 1 };
     }
 
-    size_t consumeWhitespace(std::u32string_view data) {
+    size_t consumeWhitespace(std::string_view data) {
         size_t advance = 0;
 
         for (const auto &character : data) {
-            if (character < 0x7F && std::isspace(static_cast<char>(character & 0x7F))) {
+            if (u8(character) < 0x7F && std::isspace(static_cast<u8>(character))) {
                 advance++;
             } else {
                 break;
@@ -65,7 +131,7 @@ namespace steam {
         return advance;
     }
 
-    std::pair<KeyValues::Set, size_t> parseSet(std::u32string_view data) {
+    std::pair<KeyValues::Set, size_t> parseSet(std::string_view data) {
         KeyValues::Set result;
         size_t advance = 0;
 
@@ -83,41 +149,41 @@ namespace steam {
             advance += valueBytesUsed;
             advance += consumeWhitespace(data.substr(advance));
 
-            result.emplace(keyValue.key, keyValue.value);
+            result.emplace(std::move(keyValue.key), std::move(keyValue.value));
         }
 
-        return { result, advance + 1 };
+        return { std::move(result), advance + 1 };
     }
 
-    std::pair<KeyValues::KeyValuePair, size_t> parseElement(std::u32string_view data) {
+    std::pair<KeyValues::KeyValuePair, size_t> parseElement(std::string_view data) {
         KeyValues::KeyValuePair result;
         size_t advance = 0;
 
-        std::wstring_convert<std::codecvt_utf8<char32_t>, char32_t> converter;
-
         advance += consumeWhitespace(data);
 
         {
-            const auto [value, bytesUsed] = parseString(data.substr(advance));
+            auto [value, bytesUsed] = parseString(data.substr(advance));
             if (bytesUsed == 0)
                 return { { }, 0 };
 
-            result.key = converter.to_bytes(value);
+            result.key = std::move(value);
             advance += bytesUsed;
         }
 
         advance += consumeWhitespace(data.substr(advance));
+        if (advance >= data.length())
+            return { { }, 0 };
 
         switch (data[advance]) {
             case '"': {
                 auto [value, bytesUsed] = parseString(data.substr(advance));
-                result.value.content = converter.to_bytes(value);
+                result.value = std::string_view(value);
                 advance += bytesUsed;
                 break;
             }
             case '{': {
                 auto [value, bytesUsed] = parseSet(data.substr(advance));
-                result.value.content = value;
+                result.value = std::move(value);
                 advance += bytesUsed;
                 break;
             }
@@ -125,88 +191,315 @@ namespace steam {
                 return { { }, 0 };
         }
 
-        return { result, advance };
+        return { std::move(result), advance };
     }
 
-    KeyValues::Set KeyValues::parse(const std::string &data) {
-        std::wstring_convert<std::codecvt_utf8<char32_t>, char32_t> converter;
-        const auto convertedData = converter.from_bytes(data);
-
+    KeyValues::Set KeyValues::parse(std::string_view data) {
         KeyValues::Set result;
-        size_t advance = 0;
+        size_t advance = consumeWhitespace(data);
 
-        while (advance < convertedData.size()) {
-            auto [keyValue, bytesUsed] = parseElement(convertedData.substr(advance));
+        while (advance < data.size()) {
+            auto [keyValue, bytesUsed] = parseElement(data.substr(advance));
             if (bytesUsed == 0)
                 return { };
 
             advance += bytesUsed;
 
-            result.emplace(keyValue.key, keyValue.value);
+            result.emplace(std::move(keyValue.key), std::move(keyValue.value));
 
-            advance += consumeWhitespace(convertedData.substr(advance));
+            advance += consumeWhitespace(data.substr(advance));
         }
 
         return result;
     }
 
-    std::string dumpString(const std::string &string) {
-        std::u32string result;
+    static size_t getUtf8SequenceLength(std::string_view data) {
+        constexpr static u32 MinimumCodepoint[] = { 0, 0, 0x80, 0x800, 0x1'0000 };
+
+        const auto lead = static_cast<u8>(data[0]);
+
+        size_t length;
+        u32 codepoint;
+        if ((lead & 0xE0) == 0xC0) {
+            length = 2;
+            codepoint = lead & 0x1F;
+        } else if ((lead & 0xF0) == 0xE0) {
+            length = 3;
+            codepoint = lead & 0x0F;
+        } else if ((lead & 0xF8) == 0xF0) {
+            length = 4;
+            codepoint = lead & 0x07;
+        } else {
+            return 0;
+        }
 
-        std::wstring_convert<std::codecvt_utf8<char32_t>, char32_t> converter;
-        const auto convertedString = converter.from_bytes(string);
+        if (data.size() < length)
+            return 0;
 
-        for (const auto &character : convertedString) {
-            switch (character) {
-                case '\\': result += U"\\\\"; break;
-                case '\"': result += U"\\\""; break;
-                case '\t': result += U"\\t"; break;
-                case '\n': result += U"\\n"; break;
-                default:   result += character; break;
-            }
+        for (size_t i = 1; i < length; i++) {
+            const auto continuation = static_cast<u8>(data[i]);
+            if ((continuation & 0xC0) != 0x80)
+                return 0;
+
+            codepoint = (codepoint << 6) | (continuation & 0x3F);
         }
 
-        return fmt::format("\"{0}\"", converter.to_bytes(result));
+        // Reject overlong encodings, surrogates and anything outside of the unicode range
+        if (codepoint < MinimumCodepoint[length] || codepoint > 0x10'FFFF || (codepoint >= 0xD800 && codepoint <= 0xDFFF))
+            return 0;
+
+        return length;
     }
 
-    std::string dumpSet(const KeyValues::Set &set, u32 indent) {
-        std::string result;
+    ValidationResult KeyValues::validate(std::string_view data) {
+        ValidationResult result;
+        u32 depth = 0;
+        size_t offset = 0;
+
+        auto fail = [&](ValidationError error, size_t errorOffset) {
+            result.error  = error;
+            result.offset = errorOffset;
+            return result;
+        };
+
+        auto skipWhitespace = [&] {
+            while (offset < data.size() && static_cast<u8>(data[offset]) < 0x7F && std::isspace(data[offset]))
+                offset++;
+        };
+
+        // Advances past the quoted string starting at the current offset
+        auto skipString = [&]() -> ValidationError {
+            offset++;
+
+            while (offset < data.size()) {
+                const auto character = static_cast<u8>(data[offset]);
+
+                if (character == '"') {
+                    offset++;
+                    return ValidationError::None;
+                } else if (character == '\\') {
+                    if (offset + 1 >= data.size())
+                        return ValidationError::UnexpectedEnd;
+
+                    switch (data[offset + 1]) {
+                        case 'n': case 't': case '\\': case '"': break;
+                        default: return ValidationError::InvalidEscapeSequence;
+                    }
 
-        result += fmt::format("{0: >{1}}{{\n", "", indent);
+                    offset += 2;
+                } else if (character < 0x80) {
+                    offset++;
+                } else {
+                    const auto length = getUtf8SequenceLength(data.substr(offset));
+                    if (length == 0)
+                        return ValidationError::InvalidEncoding;
 
-        for (const auto &[key, value] : set) {
-            result += dumpElement(key, value, indent + 4);
-        }
+                    offset += length;
+                }
+            }
 
-        result += fmt::format("{0: >{1}}}}", "", indent);
+            return ValidationError::UnexpectedEnd;
+        };
 
-        return result;
+        while (true) {
+            skipWhitespace();
+
+            if (offset >= data.size()) {
+                if (depth != 0)
+                    return fail(ValidationError::UnexpectedEnd, offset);
+
+                return result;
+            }
+
+            if (data[offset] == '}') {
+                if (depth == 0)
+                    return fail(ValidationError::UnbalancedSet, offset);
+
+                depth--;
+                offset++;
+                continue;
+            }
+
+            if (data[offset] != '"')
+                return fail(ValidationError::UnexpectedCharacter, offset);
+
+            if (auto error = skipString(); error != ValidationError::None)
+                return fail(error, offset);
+
+            result.nodeCount++;
+            result.maxDepth = std::max(result.maxDepth, depth + 1);
+
+            skipWhitespace();
+            if (offset >= data.size())
+                return fail(ValidationError::UnexpectedEnd, offset);
+
+            if (data[offset] == '"') {
+                if (auto error = skipString(); error != ValidationError::None)
+                    return fail(error, offset);
+            } else if (data[offset] == '{') {
+                depth++;
+                offset++;
+            } else {
+                return fail(ValidationError::UnexpectedCharacter, offset);
+            }
+        }
     }
 
-    std::string dumpElement(const std::string &key, const KeyValues::Value &value, u32 indent) {
-        std::string result;
+    namespace {
+
+        // Documents smaller than this are always dumped on the calling thread
+        constexpr static size_t ParallelDumpThreshold = 1024 * 1024;
+
+        // Sets larger than this are split up into their children when distributing the work across threads
+        constexpr static size_t ParallelDumpChunkSize = 64 * 1024;
 
-        result += fmt::format("{0: >{1}}{2}", "", indent, dumpString(key));
+        // All escaped characters are ASCII, so strings can be escaped byte by byte without decoding them first
+        size_t measureString(std::string_view string) {
+            size_t size = 2 + string.size();
 
-        result += std::visit(overloaded {
-            [](const std::string &value) {
-                return fmt::format("\t\t{0}\n", dumpString(value));
-            },
-            [&indent](const KeyValues::Set &value) {
-                return fmt::format("\n{0}\n", dumpSet(value, indent));
+            for (char character : string) {
+                switch (character) {
+                    case '\\': case '\"': case '\t': case '\n': size++; break;
+                    default: break;
+                }
             }
-        }, value.content);
 
-        return result;
+            return size;
+        }
+
+        // Sets that planDump splits up, found while measuring the document so they don't have to be measured again
+        using LargeSets = std::unordered_set<const KeyValues::Value*>;
+
+        size_t measureElement(std::string_view key, const KeyValues::Value &value, u32 indent, LargeSets *largeSets = nullptr) {
+            const auto keySize = indent + measureString(key);
+
+            return keySize + value.visit(overloaded {
+                [](std::string_view value) -> size_t {
+                    return 2 + measureString(value) + 1;
+                },
+                [&](const KeyValues::Set &set) -> size_t {
+                    size_t size = 1 + (indent + 2) + (indent + 1) + 1;
+                    for (const auto &[childKey, child] : set)
+                        size += measureElement(childKey, child, indent + 4, largeSets);
+
+                    if (largeSets != nullptr && keySize + size >= ParallelDumpChunkSize)
+                        largeSets->insert(&value);
+
+                    return size;
+                }
+            });
+        }
+
+        void dumpIndent(u32 indent, char *&result) {
+            result = std::fill_n(result, indent, ' ');
+        }
+
+        void dumpString(std::string_view string, char *&result) {
+            *result++ = '"';
+
+            for (char character : string) {
+                switch (character) {
+                    case '\\': *result++ = '\\'; *result++ = '\\'; break;
+                    case '\"': *result++ = '\\'; *result++ = '"';  break;
+                    case '\t': *result++ = '\\'; *result++ = 't';  break;
+                    case '\n': *result++ = '\\'; *result++ = 'n';  break;
+                    default:   *result++ = character; break;
+                }
+            }
+
+            *result++ = '"';
+        }
+
+        void dumpSetOpening(std::string_view key, u32 indent, char *&result) {
+            dumpIndent(indent, result);
+            dumpString(key, result);
+            *result++ = '\n';
+
+            dumpIndent(indent, result);
+            *result++ = '{';
+            *result++ = '\n';
+        }
+
+        void dumpSetClosing(u32 indent, char *&result) {
+            dumpIndent(indent, result);
+            *result++ = '}';
+            *result++ = '\n';
+        }
+
+        void dumpElement(std::string_view key, const KeyValues::Value &value, u32 indent, char *&result) {
+            value.visit(overloaded {
+                [&](std::string_view value) {
+                    dumpIndent(indent, result);
+                    dumpString(key, result);
+
+                    *result++ = '\t';
+                    *result++ = '\t';
+                    dumpString(value, result);
+                    *result++ = '\n';
+                },
+                [&](const KeyValues::Set &value) {
+                    dumpSetOpening(key, indent, result);
+
+                    for (const auto &[childKey, child] : value)
+                        dumpElement(childKey, child, indent + 4, result);
+
+                    dumpSetClosing(indent, result);
+                }
+            });
+        }
+
+        struct DumpTask {
+            std::string_view key;
+            const KeyValues::Value *value;
+            u32 indent;
+            char *destination;
+        };
+
+        // Writes the framing of large sets directly and turns everything small enough into a task that dumps into its final location
+        void planDump(std::string_view key, const KeyValues::Value &value, u32 indent, const LargeSets &largeSets, char *&result, std::vector<DumpTask> &tasks) {
+            // Everything that isn't split up is small, measuring it once more is cheap
+            if (!largeSets.contains(&value)) {
+                tasks.push_back({ key, &value, indent, result });
+                result += measureElement(key, value, indent);
+                return;
+            }
+
+            dumpSetOpening(key, indent, result);
+
+            for (const auto &[childKey, child] : value.set())
+                planDump(childKey, child, indent + 4, largeSets, result, tasks);
+
+            dumpSetClosing(indent, result);
+        }
+
     }
 
     std::string KeyValues::dump() const {
-        std::string result;
+        LargeSets largeSets;
+
+        size_t size = 0;
+        for (const auto &[key, value] : this->m_content)
+            size += measureElement(key, value, 0, &largeSets);
+
+        std::string result(size, '\0');
+        auto cursor = result.data();
 
-        for (const auto &[key, value] : this->m_content) {
-            result += dumpElement(key, value, 0);
+        if (size < ParallelDumpThreshold) {
+            for (const auto &[key, value] : this->m_content)
+                dumpElement(key, value, 0, cursor);
+
+            return result;
         }
 
+        std::vector<DumpTask> tasks;
+        for (const auto &[key, value] : this->m_content)
+            planDump(key, value, 0, largeSets, cursor, tasks);
+
+        parallelFor(tasks.size(), [&tasks](size_t i) {
+            auto destination = tasks[i].destination;
+            dumpElement(tasks[i].key, *tasks[i].value, tasks[i].indent, destination);
+        });
+
         return result;
     }
 }
\ No newline at end of file
@@ -0,0 +1,109 @@
+#include <steam/file_formats/shortcut_scanner.hpp>
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+
+namespace steam {
+
+    namespace {
+
+        // Depth of the fields inside of a shortcut, the root "shortcuts" set sits at depth 1
+        constexpr static u32 ShortcutDepth = 2;
+
+        bool equalsIgnoreCase(std::string_view a, std::string_view b) {
+            return std::ranges::equal(a, b, [](char x, char y) {
+                return std::tolower(u8(x)) == std::tolower(u8(y));
+            });
+        }
+
+    }
+
+    std::optional<std::string_view> ShortcutScanner::readString() {
+        const auto remaining = this->m_data.size() - this->m_offset;
+        const auto begin = reinterpret_cast<const char*>(this->m_data.data() + this->m_offset);
+
+        auto terminator = static_cast<const char*>(std::memchr(begin, 0x00, remaining));
+        if (terminator == nullptr)
+            return std::nullopt;
+
+        this->m_offset += terminator - begin + 1;
+
+        return std::string_view(begin, terminator);
+    }
+
+    std::optional<ShortcutEntry> ShortcutScanner::next() {
+        auto fail = [this] {
+            this->m_valid  = false;
+            this->m_offset = this->m_data.size();
+            return std::nullopt;
+        };
+
+        while (this->m_offset < this->m_data.size()) {
+            const auto type = static_cast<VDF::Type>(this->m_data[this->m_offset]);
+            this->m_offset++;
+
+            if (type == VDF::Type::EndSet) {
+                if (this->m_depth == 0) {
+                    this->m_offset   = this->m_data.size();
+                    this->m_complete = true;
+                    return std::nullopt;
+                }
+
+                this->m_depth--;
+                if (this->m_depth == ShortcutDepth - 1)
+                    return this->m_entry;
+
+                continue;
+            }
+
+            auto key = this->readString();
+            if (!key.has_value())
+                return fail();
+
+            switch (type) {
+                case VDF::Type::Set:
+                    this->m_depth++;
+                    if (this->m_depth == ShortcutDepth)
+                        this->m_entry = { .key = *key };
+                    break;
+                case VDF::Type::String: {
+                    auto value = this->readString();
+                    if (!value.has_value())
+                        return fail();
+
+                    if (this->m_depth != ShortcutDepth)
+                        break;
+
+                    if (equalsIgnoreCase(*key, "AppName"))
+                        this->m_entry.appName = *value;
+                    else if (equalsIgnoreCase(*key, "Exe"))
+                        this->m_entry.exe = *value;
+                    break;
+                }
+                case VDF::Type::Integer: {
+                    if (this->m_data.size() - this->m_offset < sizeof(u32))
+                        return fail();
+
+                    if (this->m_depth == ShortcutDepth && equalsIgnoreCase(*key, "appid")) {
+                        u32 value;
+                        std::memcpy(&value, this->m_data.data() + this->m_offset, sizeof(value));
+                        this->m_entry.appId = value;
+                    }
+
+                    this->m_offset += sizeof(u32);
+                    break;
+                }
+                default:
+                    return fail();
+            }
+        }
+
+        // Ran out of data before the root set ended. Empty buffers are fine, users without shortcuts have an empty file
+        if (!this->m_complete && !this->m_data.empty())
+            return fail();
+
+        return std::nullopt;
+    }
+
+}
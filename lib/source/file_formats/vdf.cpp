@@ -1,13 +1,85 @@
 #include <steam/file_formats/vdf.hpp>
 
 #include <steam/helpers/utils.hpp>
+#include <steam/helpers/parallel.hpp>
 
+#include <cstring>
 #include <span>
+#include <unordered_set>
 
 #include <fmt/format.h>
 
 namespace steam {
 
+    VDF::VDF(const VDF &other) : m_content(other.m_content) {
+        for (const auto &index : other.m_indexes)
+            this->addIndex(index->getPattern());
+    }
+
+    VDF::VDF(VDF &&other) noexcept : m_content(std::move(other.m_content)), m_indexes(std::move(other.m_indexes)) {
+        for (auto &index : this->m_indexes)
+            index->setRoot(this->m_content);
+    }
+
+    VDF& VDF::operator=(const VDF &other) {
+        if (this == &other)
+            return *this;
+
+        this->m_indexes.clear();
+        this->m_content = other.m_content;
+
+        for (const auto &index : other.m_indexes)
+            this->addIndex(index->getPattern());
+
+        return *this;
+    }
+
+    VDF& VDF::operator=(VDF &&other) noexcept {
+        this->m_indexes = std::move(other.m_indexes);
+        this->m_content = std::move(other.m_content);
+
+        for (auto &index : this->m_indexes)
+            index->setRoot(this->m_content);
+
+        return *this;
+    }
+
+    const VDF::Index* VDF::addIndex(const std::string &pattern) {
+        if (auto index = this->getIndex(pattern); index != nullptr)
+            return index;
+
+        auto parsedPattern = Index::parsePattern(pattern);
+        if (!parsedPattern.has_value())
+            return nullptr;
+
+        auto &[segments, wildcard] = *parsedPattern;
+        return this->m_indexes.emplace_back(std::make_unique<Index>(this->m_content, std::move(segments), wildcard)).get();
+    }
+
+    bool VDF::removeIndex(const std::string &pattern) {
+        return std::erase_if(this->m_indexes, [&](const auto &index) {
+            if (index->getPattern() != pattern)
+                return false;
+
+            index->detach();
+            return true;
+        }) > 0;
+    }
+
+    const VDF::Index* VDF::getIndex(const std::string &pattern) const {
+        for (const auto &index : this->m_indexes) {
+            if (index->getPattern() == pattern)
+                return index.get();
+        }
+
+        return nullptr;
+    }
+
+    void VDF::reindex() {
+        for (auto &index : this->m_indexes)
+            index->rebuild();
+    }
+
     std::pair<VDF::KeyValuePair, size_t> parseElement(std::span<const u8> data);
 
     std::pair<std::string, size_t> parseString(std::span<const u8> data) {
@@ -48,7 +120,7 @@ namespace steam {
 
         {
             auto [value, bytesUsed] = parseString({ &data[advance], data.size() - advance });
-            result.value.content = value;
+            result.value = value;
             advance += bytesUsed;
         }
 
@@ -67,7 +139,7 @@ namespace steam {
 
         {
             auto [value, bytesUsed] = parseInteger({ &data[advance], data.size() - advance });
-            result.value.content = value;
+            result.value = value;
             advance += bytesUsed;
         }
 
@@ -85,7 +157,7 @@ namespace steam {
             advance += usedBytes;
         }
 
-        result.value.content = VDF::Set{};
+        result.value = VDF::Set{};
 
         while (true) {
             if (advance >= data.size())
@@ -101,7 +173,7 @@ namespace steam {
                 return { { }, 0 };
 
             advance += usedBytes;
-            std::get<VDF::Set>(result.value.content).emplace(element.key, element.value);
+            result.value.set().emplace(std::move(element.key), std::move(element.value));
         }
 
         return { result, advance };
@@ -133,7 +205,7 @@ namespace steam {
         return { result, advance + 1 };
     }
 
-    VDF::Set VDF::parse(const std::vector<u8> &data) {
+    VDF::Set VDF::parse(std::span<const u8> data) {
         Set result;
 
         u64 offset = 0;
@@ -147,67 +219,230 @@ namespace steam {
                 break;
 
             offset += bytesUsed;
-            result.emplace(element.key, element.value);
+            result.emplace(std::move(element.key), std::move(element.value));
         }
 
         return result;
     }
 
-    void dumpKey(VDF::Type type, const std::string &key, std::vector<u8> &result) {
-        if (key.empty()) return;
+    ValidationResult VDF::validate(std::span<const u8> data) {
+        ValidationResult result;
+        u32 depth = 0;
 
-        result.push_back(static_cast<u8>(type));
+        auto fail = [&](ValidationError error, size_t offset) {
+            result.error  = error;
+            result.offset = offset;
+            return result;
+        };
 
-        std::copy(key.begin(), key.end(), std::back_inserter(result));
-        result.push_back(0x00);
-    }
+        // Returns the offset right after the null terminator of the string starting at offset
+        auto skipString = [&](size_t offset) -> size_t {
+            auto terminator = static_cast<const u8*>(std::memchr(data.data() + offset, 0x00, data.size() - offset));
+            if (terminator == nullptr)
+                return 0;
 
-    void dumpString(const std::string &key, const std::string &content, std::vector<u8> &result) {
-        dumpKey(VDF::Type::String, key, result);
+            return terminator - data.data() + 1;
+        };
 
-        std::copy(content.begin(), content.end(), std::back_inserter(result));
-        result.push_back(0x00);
-    }
+        size_t offset = 0;
+        while (offset < data.size()) {
+            const auto type = static_cast<Type>(data[offset]);
 
-    void dumpInteger(const std::string &key, u32 content, std::vector<u8> &result) {
-        dumpKey(VDF::Type::Integer, key, result);
+            if (type == Type::EndSet) {
+                offset++;
 
-        result.push_back((content >> 0)  & 0xFF);
-        result.push_back((content >> 8)  & 0xFF);
-        result.push_back((content >> 16) & 0xFF);
-        result.push_back((content >> 24) & 0xFF);
-    }
+                if (depth == 0) {
+                    if (offset != data.size())
+                        return fail(ValidationError::TrailingData, offset);
 
-    void dumpElement(const std::string &key, const VDF::Value &value, std::vector<u8> &result);
+                    return result;
+                }
 
-    void dumpSet(const std::string &setKey, const VDF::Set &content, std::vector<u8> &result) {
-        dumpKey(VDF::Type::Set, setKey, result);
+                depth--;
+                continue;
+            }
 
-        for (const auto &[key, value] : content) {
-            dumpElement(key, value, result);
+            if (type != Type::Set && type != Type::String && type != Type::Integer)
+                return fail(ValidationError::InvalidType, offset);
+
+            const auto keyOffset = offset + 1;
+            if (keyOffset >= data.size())
+                return fail(ValidationError::UnexpectedEnd, data.size());
+            if (data[keyOffset] == 0x00)
+                return fail(ValidationError::EmptyKey, keyOffset);
+
+            offset = skipString(keyOffset);
+            if (offset == 0)
+                return fail(ValidationError::UnexpectedEnd, data.size());
+
+            result.nodeCount++;
+            result.maxDepth = std::max(result.maxDepth, depth + 1);
+
+            switch (type) {
+                case Type::Set:
+                    depth++;
+                    break;
+                case Type::String:
+                    if (offset >= data.size())
+                        return fail(ValidationError::UnexpectedEnd, data.size());
+
+                    offset = skipString(offset);
+                    if (offset == 0)
+                        return fail(ValidationError::UnexpectedEnd, data.size());
+                    break;
+                case Type::Integer:
+                    if (data.size() - offset < sizeof(u32))
+                        return fail(ValidationError::UnexpectedEnd, data.size());
+
+                    offset += sizeof(u32);
+                    break;
+                default:
+                    break;
+            }
         }
 
-        result.push_back(static_cast<u8>(VDF::Type::EndSet));
+        return fail(ValidationError::UnexpectedEnd, data.size());
     }
 
-    void dumpElement(const std::string &key, const VDF::Value &value, std::vector<u8> &result) {
-        std::visit(overloaded {
-                [&](const std::string &string) {
-                    dumpString(key, string, result);
-                },
-                [&](const u32 &integer) {
-                    dumpInteger(key, integer, result);
-                },
-                [&](const VDF::Set &set) {
-                    dumpSet(key, set, result);
-                }
-        }, value.content);
+    namespace {
+
+        // Documents smaller than this are always dumped on the calling thread
+        constexpr static size_t ParallelDumpThreshold = 1024 * 1024;
+
+        // Sets larger than this are split up into their children when distributing the work across threads
+        constexpr static size_t ParallelDumpChunkSize = 64 * 1024;
+
+        size_t measureKey(std::string_view key) {
+            if (key.empty()) return 0;
+
+            return 1 + key.size() + 1;
+        }
+
+        // Sets that planDump splits up, found while measuring the document so they don't have to be measured again
+        using LargeSets = std::unordered_set<const VDF::Value*>;
+
+        size_t measureElement(std::string_view key, const VDF::Value &value, LargeSets *largeSets = nullptr) {
+            return measureKey(key) + value.visit(overloaded {
+                    [&](std::string_view string) -> size_t {
+                        return string.size() + 1;
+                    },
+                    [&](const u32 &) -> size_t {
+                        return sizeof(u32);
+                    },
+                    [&](const VDF::Set &set) -> size_t {
+                        size_t size = 1;
+                        for (const auto &[childKey, child] : set)
+                            size += measureElement(childKey, child, largeSets);
+
+                        if (largeSets != nullptr && measureKey(key) + size >= ParallelDumpChunkSize)
+                            largeSets->insert(&value);
+
+                        return size;
+                    }
+            });
+        }
+
+        void dumpKey(VDF::Type type, std::string_view key, u8 *&result) {
+            if (key.empty()) return;
+
+            *result++ = static_cast<u8>(type);
+
+            result = std::copy(key.begin(), key.end(), result);
+            *result++ = 0x00;
+        }
+
+        void dumpString(std::string_view key, std::string_view content, u8 *&result) {
+            dumpKey(VDF::Type::String, key, result);
+
+            result = std::copy(content.begin(), content.end(), result);
+            *result++ = 0x00;
+        }
+
+        void dumpInteger(std::string_view key, u32 content, u8 *&result) {
+            dumpKey(VDF::Type::Integer, key, result);
+
+            *result++ = (content >> 0)  & 0xFF;
+            *result++ = (content >> 8)  & 0xFF;
+            *result++ = (content >> 16) & 0xFF;
+            *result++ = (content >> 24) & 0xFF;
+        }
+
+        void dumpElement(std::string_view key, const VDF::Value &value, u8 *&result);
+
+        void dumpSet(std::string_view setKey, const VDF::Set &content, u8 *&result) {
+            dumpKey(VDF::Type::Set, setKey, result);
+
+            for (const auto &[key, value] : content) {
+                dumpElement(key, value, result);
+            }
+
+            *result++ = static_cast<u8>(VDF::Type::EndSet);
+        }
+
+        void dumpElement(std::string_view key, const VDF::Value &value, u8 *&result) {
+            value.visit(overloaded {
+                    [&](std::string_view string) {
+                        dumpString(key, string, result);
+                    },
+                    [&](const u32 &integer) {
+                        dumpInteger(key, integer, result);
+                    },
+                    [&](const VDF::Set &set) {
+                        dumpSet(key, set, result);
+                    }
+            });
+        }
+
+        struct DumpTask {
+            std::string_view key;
+            const VDF::Value *value;
+            u8 *destination;
+        };
+
+        // Writes the framing of large sets directly and turns everything small enough into a task that dumps into its final location
+        void planDump(std::string_view key, const VDF::Value &value, const LargeSets &largeSets, u8 *&result, std::vector<DumpTask> &tasks) {
+            // Everything that isn't split up is small, measuring it once more is cheap
+            if (!largeSets.contains(&value)) {
+                tasks.push_back({ key, &value, result });
+                result += measureElement(key, value);
+                return;
+            }
+
+            dumpKey(VDF::Type::Set, key, result);
+
+            for (const auto &[childKey, child] : value.set())
+                planDump(childKey, child, largeSets, result, tasks);
+
+            *result++ = static_cast<u8>(VDF::Type::EndSet);
+        }
+
     }
 
     std::vector<u8> VDF::dump() const {
-        std::vector<u8> result;
+        LargeSets largeSets;
+
+        size_t size = 1;
+        for (const auto &[key, value] : this->m_content)
+            size += measureElement(key, value, &largeSets);
+
+        std::vector<u8> result(size);
+        auto cursor = result.data();
+
+        if (size < ParallelDumpThreshold) {
+            dumpSet("", this->m_content, cursor);
+            return result;
+        }
+
+        std::vector<DumpTask> tasks;
+        for (const auto &[key, value] : this->m_content)
+            planDump(key, value, largeSets, cursor, tasks);
+
+        *cursor = static_cast<u8>(VDF::Type::EndSet);
 
-        dumpSet("", this->m_content, result);
+        parallelFor(tasks.size(), [&tasks](size_t i) {
+            auto destination = tasks[i].destination;
+            dumpElement(tasks[i].key, *tasks[i].value, destination);
+        });
 
         return result;
     }
@@ -216,9 +451,9 @@ namespace steam {
         std::string result;
 
         for (auto &[key, value] : content) {
-            result += fmt::format(",\n{0: >{1}}\"{2}\": ", "", indent, key);
-            std::visit(steam::overloaded {
-                    [&](const std::string& x) {
+            result += fmt::format(",\n{0: >{1}}\"{2}\": ", "", indent, key.view());
+            value.visit(steam::overloaded {
+                    [&](std::string_view x) {
                         result += fmt::format("\"{0}\"", x);
                     },
                     [&](const steam::u32& x) {
@@ -233,7 +468,7 @@ namespace steam {
                         }
                         result += fmt::format("\n{0: >{1}}}}", "", indent);
                     }
-            }, value.content);
+            });
         }
 
         return result;
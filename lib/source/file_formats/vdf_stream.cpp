@@ -0,0 +1,359 @@
+#include <steam/file_formats/vdf_stream.hpp>
+
+#include <steam/helpers/utils.hpp>
+
+#include <cstring>
+
+namespace steam {
+
+    VDFStreamReader::VDFStreamReader(fs::File &file, size_t bufferSize) : m_file(file), m_buffer(bufferSize) { }
+
+    // Makes sure at least count bytes starting at the current position are buffered
+    bool VDFStreamReader::ensure(size_t count) {
+        if (this->m_size - this->m_position >= count)
+            return true;
+
+        // Move the unread data to the front of the buffer and grow it if a single token doesn't fit
+        std::memmove(this->m_buffer.data(), this->m_buffer.data() + this->m_position, this->m_size - this->m_position);
+        this->m_size -= this->m_position;
+        this->m_position = 0;
+
+        if (count > this->m_buffer.size())
+            this->m_buffer.resize(std::max(count, this->m_buffer.size() * 2));
+
+        while (this->m_size < count && !this->m_endOfFile) {
+            auto bytesRead = this->m_file.readBuffer(this->m_buffer.data() + this->m_size, this->m_buffer.size() - this->m_size);
+            if (bytesRead == 0)
+                this->m_endOfFile = true;
+
+            this->m_size += bytesRead;
+        }
+
+        return this->m_size >= count;
+    }
+
+    // Returns the offset of the next null terminator relative to the current position
+    std::optional<size_t> VDFStreamReader::findTerminator(size_t offset) {
+        while (true) {
+            const auto available = this->m_size - this->m_position;
+            const auto start     = this->m_buffer.data() + this->m_position;
+
+            if (offset < available) {
+                auto terminator = static_cast<const u8*>(std::memchr(start + offset, 0x00, available - offset));
+                if (terminator != nullptr)
+                    return terminator - start;
+
+                offset = available;
+            }
+
+            if (!this->ensure(available + 1))
+                return std::nullopt;
+        }
+    }
+
+    std::optional<VDFEvent> VDFStreamReader::fail() {
+        this->m_error = true;
+        return std::nullopt;
+    }
+
+    std::optional<VDFEvent> VDFStreamReader::next() {
+        if (this->m_done || this->m_error)
+            return std::nullopt;
+
+        if (!this->ensure(1)) {
+            // Like the regular parser, accept documents that are missing their final terminator
+            if (this->m_depth != 0)
+                return this->fail();
+
+            this->m_done = true;
+            return std::nullopt;
+        }
+
+        const auto type = static_cast<VDF::Type>(this->m_buffer[this->m_position]);
+
+        if (type == VDF::Type::EndSet) {
+            this->m_position++;
+
+            if (this->m_depth == 0) {
+                this->m_done = true;
+                return std::nullopt;
+            }
+
+            this->m_depth--;
+            return VDFEvent { VDF::Type::EndSet };
+        }
+
+        if (type != VDF::Type::Set && type != VDF::Type::String && type != VDF::Type::Integer)
+            return this->fail();
+
+        auto keyEnd = this->findTerminator(1);
+        if (!keyEnd.has_value())
+            return this->fail();
+
+        // Locate the whole element first, the buffer may move while more data is read in
+        size_t valueEnd = *keyEnd + 1;
+        switch (type) {
+            case VDF::Type::String: {
+                auto stringEnd = this->findTerminator(*keyEnd + 1);
+                if (!stringEnd.has_value())
+                    return this->fail();
+
+                valueEnd = *stringEnd + 1;
+                break;
+            }
+            case VDF::Type::Integer:
+                if (!this->ensure(*keyEnd + 1 + sizeof(u32)))
+                    return this->fail();
+
+                valueEnd = *keyEnd + 1 + sizeof(u32);
+                break;
+            default:
+                break;
+        }
+
+        const auto start = reinterpret_cast<const char*>(this->m_buffer.data() + this->m_position);
+
+        VDFEvent event = { type };
+        event.key = { start + 1, *keyEnd - 1 };
+
+        switch (type) {
+            case VDF::Type::Set:
+                this->m_depth++;
+                break;
+            case VDF::Type::String:
+                event.string = { start + *keyEnd + 1, valueEnd - *keyEnd - 2 };
+                break;
+            case VDF::Type::Integer: {
+                auto bytes = reinterpret_cast<const u8*>(start + *keyEnd + 1);
+                event.integer = bytes[0] | (bytes[1] << 8) | (bytes[2] << 16) | (u32(bytes[3]) << 24);
+                break;
+            }
+            default:
+                break;
+        }
+
+        this->m_position += valueEnd;
+
+        return event;
+    }
+
+
+    VDFStreamWriter::VDFStreamWriter(fs::File &file, size_t bufferSize) : m_file(file), m_bufferSize(bufferSize) {
+        this->m_buffer.reserve(bufferSize);
+    }
+
+    void VDFStreamWriter::append(std::string_view data) {
+        this->m_buffer.insert(this->m_buffer.end(), data.begin(), data.end());
+
+        if (this->m_buffer.size() >= this->m_bufferSize)
+            this->flush();
+    }
+
+    void VDFStreamWriter::append(u8 byte) {
+        this->m_buffer.push_back(byte);
+
+        if (this->m_buffer.size() >= this->m_bufferSize)
+            this->flush();
+    }
+
+    void VDFStreamWriter::flush() {
+        // Everything after a failed write would end up at the wrong place in the file, so writing stops there
+        if (!this->m_error && !this->m_file.write(this->m_buffer))
+            this->m_error = true;
+
+        this->m_buffer.clear();
+    }
+
+    void VDFStreamWriter::write(const VDFEvent &event) {
+        if (event.type == VDF::Type::EndSet) {
+            this->append(static_cast<u8>(VDF::Type::EndSet));
+            return;
+        }
+
+        if (!event.key.empty()) {
+            this->append(static_cast<u8>(event.type));
+            this->append(event.key);
+            this->append(u8(0x00));
+        }
+
+        switch (event.type) {
+            case VDF::Type::String:
+                this->append(event.string);
+                this->append(u8(0x00));
+                break;
+            case VDF::Type::Integer:
+                for (u32 i = 0; i < sizeof(u32); i++)
+                    this->append(u8((event.integer >> (i * 8)) & 0xFF));
+                break;
+            default:
+                break;
+        }
+    }
+
+    void VDFStreamWriter::write(std::string_view key, const VDF::Value &value) {
+        value.visit(overloaded {
+            [&](std::string_view string) {
+                this->write(VDFEvent { VDF::Type::String, key, string });
+            },
+            [&](u32 integer) {
+                this->write(VDFEvent { VDF::Type::Integer, key, { }, integer });
+            },
+            [&](const VDF::Set &set) {
+                this->write(VDFEvent { VDF::Type::Set, key });
+
+                for (const auto &[childKey, child] : set)
+                    this->write(childKey, child);
+
+                this->write(VDFEvent { VDF::Type::EndSet });
+            }
+        });
+    }
+
+    bool VDFStreamWriter::finish() {
+        this->append(static_cast<u8>(VDF::Type::EndSet));
+        this->flush();
+
+        return !this->m_error;
+    }
+
+
+    VDFTransform::VDFTransform(std::string_view recordPattern) {
+        while (true) {
+            auto separator = recordPattern.find('/');
+            this->m_pattern.emplace_back(recordPattern.substr(0, separator));
+
+            if (separator == std::string_view::npos)
+                break;
+
+            recordPattern.remove_prefix(separator + 1);
+        }
+    }
+
+    VDFTransform& VDFTransform::filter(Filter filter) {
+        this->m_stages.emplace_back(std::move(filter));
+        return *this;
+    }
+
+    VDFTransform& VDFTransform::map(Map map) {
+        this->m_stages.emplace_back(std::move(map));
+        return *this;
+    }
+
+    VDFTransform& VDFTransform::renumber(bool enabled) {
+        this->m_renumber = enabled;
+        return *this;
+    }
+
+    bool VDFTransform::isRecord(const std::vector<std::string> &path, std::string_view key) const {
+        if (path.size() + 1 != this->m_pattern.size())
+            return false;
+
+        for (size_t i = 0; i < path.size(); i++) {
+            if (this->m_pattern[i] != "*" && this->m_pattern[i] != path[i])
+                return false;
+        }
+
+        return this->m_pattern.back() == "*" || this->m_pattern.back() == key;
+    }
+
+    // Reads the rest of the node started by event into memory
+    static std::optional<VDF::Value> readValue(VDFStreamReader &reader, const VDFEvent &event) {
+        VDF::Value value;
+
+        switch (event.type) {
+            case VDF::Type::String:
+                value = event.string;
+                return value;
+            case VDF::Type::Integer:
+                value = event.integer;
+                return value;
+            default:
+                break;
+        }
+
+        auto &set = value.set();
+        while (auto child = reader.next()) {
+            if (child->type == VDF::Type::EndSet)
+                return value;
+
+            SmallString key = child->key;
+            auto childValue = readValue(reader, *child);
+            if (!childValue.has_value())
+                return std::nullopt;
+
+            set.emplace(std::move(key), std::move(*childValue));
+        }
+
+        return std::nullopt;
+    }
+
+    bool VDFTransform::apply(fs::File &input, fs::File &output) const {
+        VDFStreamReader reader(input);
+        VDFStreamWriter writer(output);
+
+        std::vector<std::string> path;
+        u32 nextRecordIndex = 0;
+
+        while (auto event = reader.next()) {
+            if (event->type == VDF::Type::EndSet) {
+                path.pop_back();
+                writer.write(*event);
+                continue;
+            }
+
+            if (this->isRecord(path, event->key)) {
+                std::string key(event->key);
+
+                auto record = readValue(reader, *event);
+                if (!record.has_value())
+                    return false;
+
+                bool keep = true;
+                for (const auto &stage : this->m_stages) {
+                    keep = std::visit(overloaded {
+                        [&](const Filter &filter) { return filter(key, *record); },
+                        [&](const Map &map) { map(key, *record); return true; }
+                    }, stage);
+
+                    if (!keep)
+                        break;
+                }
+
+                if (keep) {
+                    if (this->m_renumber)
+                        key = std::to_string(nextRecordIndex++);
+
+                    writer.write(key, *record);
+                }
+
+                continue;
+            }
+
+            if (event->type == VDF::Type::Set) {
+                path.emplace_back(event->key);
+
+                if (path.size() + 1 == this->m_pattern.size())
+                    nextRecordIndex = 0;
+            }
+
+            writer.write(*event);
+        }
+
+        if (reader.hasError())
+            return false;
+
+        return writer.finish();
+    }
+
+    bool VDFTransform::apply(const std::fs::path &input, const std::fs::path &output) const {
+        auto inputFile = fs::File(input, fs::File::Mode::Read);
+        if (!inputFile.isValid())
+            return false;
+
+        // A failed transform leaves the previous output untouched instead of a truncated file
+        return fs::writeFileAtomic(output, [&](fs::File &outputFile) {
+            return this->apply(inputFile, outputFile);
+        });
+    }
+
+}
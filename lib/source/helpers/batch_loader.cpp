@@ -0,0 +1,407 @@
+#include <steam/helpers/batch_loader.hpp>
+#include <steam/helpers/file.hpp>
+#include <steam/helpers/parallel.hpp>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <initializer_list>
+
+#include <fcntl.h>
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace steam::fs {
+
+    namespace {
+
+        // Minimal io_uring submission and completion queue pair, set up through the raw system calls
+        class Ring {
+        public:
+            explicit Ring(u32 entries) {
+                this->m_fd = int(::syscall(__NR_io_uring_setup, entries, &this->m_params));
+                if (this->m_fd < 0)
+                    return;
+
+                const auto &sqOffsets = this->m_params.sq_off;
+                const auto &cqOffsets = this->m_params.cq_off;
+
+                this->m_sqRingSize = sqOffsets.array + this->m_params.sq_entries * sizeof(u32);
+                this->m_cqRingSize = cqOffsets.cqes + this->m_params.cq_entries * sizeof(io_uring_cqe);
+
+                // Newer kernels map both rings with a single mapping
+                const bool singleMapping = (this->m_params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+                if (singleMapping)
+                    this->m_sqRingSize = this->m_cqRingSize = std::max(this->m_sqRingSize, this->m_cqRingSize);
+
+                this->m_sqRing = map(this->m_sqRingSize, IORING_OFF_SQ_RING);
+                this->m_cqRing = singleMapping ? this->m_sqRing : map(this->m_cqRingSize, IORING_OFF_CQ_RING);
+                this->m_sqes   = static_cast<io_uring_sqe *>(static_cast<void *>(map(this->m_params.sq_entries * sizeof(io_uring_sqe), IORING_OFF_SQES)));
+
+                if (this->m_sqRing == nullptr || this->m_cqRing == nullptr || this->m_sqes == nullptr) {
+                    this->release();
+                    return;
+                }
+
+                this->m_sqHead  = reinterpret_cast<u32 *>(this->m_sqRing + sqOffsets.head);
+                this->m_sqTail  = reinterpret_cast<u32 *>(this->m_sqRing + sqOffsets.tail);
+                this->m_sqMask  = *reinterpret_cast<u32 *>(this->m_sqRing + sqOffsets.ring_mask);
+                this->m_sqArray = reinterpret_cast<u32 *>(this->m_sqRing + sqOffsets.array);
+
+                this->m_cqHead  = reinterpret_cast<u32 *>(this->m_cqRing + cqOffsets.head);
+                this->m_cqTail  = reinterpret_cast<u32 *>(this->m_cqRing + cqOffsets.tail);
+                this->m_cqMask  = *reinterpret_cast<u32 *>(this->m_cqRing + cqOffsets.ring_mask);
+                this->m_cqes    = reinterpret_cast<io_uring_cqe *>(this->m_cqRing + cqOffsets.cqes);
+
+                this->m_localTail = *this->m_sqTail;
+            }
+
+            Ring(const Ring &) = delete;
+            Ring& operator=(const Ring &) = delete;
+
+            ~Ring() {
+                this->release();
+            }
+
+            [[nodiscard]] bool isValid() const {
+                return this->m_fd >= 0;
+            }
+
+            [[nodiscard]] u32 getCapacity() const {
+                return this->m_params.sq_entries;
+            }
+
+            // Kernels can have io_uring without supporting every operation, which would then fail each request with -EINVAL
+            [[nodiscard]] bool supports(std::initializer_list<u8> operations) const {
+                constexpr static size_t MaxOperations = 256;
+
+                std::vector<u8> buffer(sizeof(io_uring_probe) + MaxOperations * sizeof(io_uring_probe_op));
+                auto probe = reinterpret_cast<io_uring_probe *>(buffer.data());
+
+                // Kernels without probing support predate most of the operations as well
+                if (::syscall(__NR_io_uring_register, this->m_fd, IORING_REGISTER_PROBE, probe, MaxOperations) < 0)
+                    return false;
+
+                return std::ranges::all_of(operations, [probe](u8 operation) {
+                    return operation < probe->ops_len && (probe->ops[operation].flags & IO_URING_OP_SUPPORTED) != 0;
+                });
+            }
+
+            // Returns a cleared submission queue entry or nullptr if the queue is full
+            io_uring_sqe *getSqe() {
+                const auto head = __atomic_load_n(this->m_sqHead, __ATOMIC_ACQUIRE);
+                if (this->m_localTail - head >= this->m_params.sq_entries)
+                    return nullptr;
+
+                const auto index = this->m_localTail & this->m_sqMask;
+                this->m_sqArray[index] = index;
+                this->m_localTail++;
+
+                auto sqe = &this->m_sqes[index];
+                std::memset(sqe, 0x00, sizeof(*sqe));
+
+                return sqe;
+            }
+
+            // Submits all queued entries and waits for at least one completion
+            bool submitAndWait() {
+                __atomic_store_n(this->m_sqTail, this->m_localTail, __ATOMIC_RELEASE);
+
+                while (true) {
+                    const u32 toSubmit = this->m_localTail - this->m_submitted;
+
+                    auto result = ::syscall(__NR_io_uring_enter, this->m_fd, toSubmit, 1, IORING_ENTER_GETEVENTS, nullptr, 0);
+                    if (result >= 0) {
+                        this->m_submitted += result;
+                        return true;
+                    }
+
+                    if (errno != EINTR && errno != EAGAIN && errno != EBUSY)
+                        return false;
+
+                    // The completion queue is full, make room before trying again
+                    if (errno != EINTR && this->hasCompletions())
+                        return true;
+                }
+            }
+
+            template<typename Callback>
+            void forEachCompletion(Callback &&callback) {
+                auto head = *this->m_cqHead;
+                const auto tail = __atomic_load_n(this->m_cqTail, __ATOMIC_ACQUIRE);
+
+                while (head != tail) {
+                    callback(this->m_cqes[head & this->m_cqMask]);
+                    head++;
+                }
+
+                __atomic_store_n(this->m_cqHead, head, __ATOMIC_RELEASE);
+            }
+
+        private:
+            [[nodiscard]] bool hasCompletions() const {
+                return *this->m_cqHead != __atomic_load_n(this->m_cqTail, __ATOMIC_ACQUIRE);
+            }
+
+            u8 *map(size_t size, u64 offset) const {
+                void *address = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, this->m_fd, offset);
+                if (address == MAP_FAILED)
+                    return nullptr;
+
+                return static_cast<u8 *>(address);
+            }
+
+            void release() {
+                if (this->m_sqes != nullptr)
+                    ::munmap(this->m_sqes, this->m_params.sq_entries * sizeof(io_uring_sqe));
+                if (this->m_cqRing != nullptr && this->m_cqRing != this->m_sqRing)
+                    ::munmap(this->m_cqRing, this->m_cqRingSize);
+                if (this->m_sqRing != nullptr)
+                    ::munmap(this->m_sqRing, this->m_sqRingSize);
+                if (this->m_fd >= 0)
+                    ::close(this->m_fd);
+
+                this->m_sqes   = nullptr;
+                this->m_sqRing = this->m_cqRing = nullptr;
+                this->m_fd     = -1;
+            }
+
+        private:
+            int m_fd = -1;
+            io_uring_params m_params = { };
+
+            u8 *m_sqRing = nullptr, *m_cqRing = nullptr;
+            size_t m_sqRingSize = 0, m_cqRingSize = 0;
+            io_uring_sqe *m_sqes = nullptr;
+
+            u32 *m_sqHead = nullptr, *m_sqTail = nullptr, *m_sqArray = nullptr;
+            u32 *m_cqHead = nullptr, *m_cqTail = nullptr;
+            u32 m_sqMask = 0, m_cqMask = 0;
+            io_uring_cqe *m_cqes = nullptr;
+
+            u32 m_localTail = 0, m_submitted = 0;
+        };
+
+        constexpr static u32 RingEntries = 128;
+        constexpr static size_t ChunkSize = 4096;
+
+        enum class Operation : u64 {
+            Open,
+            Stat,
+            Read
+        };
+
+        struct FileState {
+            int fd = -1;
+            u32 pendingOperations = 0;
+            bool failed = false, finished = false, unsupported = false;
+            size_t bytesRead = 0;
+            struct statx status = { };
+        };
+
+        u64 encodeUserData(size_t index, Operation operation) {
+            return (u64(index) << 2) | u64(operation);
+        }
+
+        // Errors that stem from the ring rather than the file, e.g a filesystem that can't do the operation through io_uring
+        bool isUnsupported(i32 result) {
+            return result == -EINVAL || result == -EOPNOTSUPP;
+        }
+
+        bool loadFilesIoUring(std::span<const std::fs::path> paths, std::vector<LoadedFile> &result, std::vector<FileState> &states) {
+            Ring ring(RingEntries);
+            if (!ring.isValid() || !ring.supports({ IORING_OP_OPENAT, IORING_OP_STATX, IORING_OP_READ }))
+                return false;
+
+            // Every file has at most two operations in flight, this keeps the completion queue from ever overflowing
+            const size_t window = ring.getCapacity() / 2;
+
+            size_t nextFile = 0, activeFiles = 0, finishedFiles = 0;
+
+            auto finish = [&](size_t index) {
+                auto &state = states[index];
+                if (state.fd >= 0)
+                    ::close(state.fd);
+
+                // Unsupported files are left unfinished so the thread pool can retry them
+                state.fd       = -1;
+                state.finished = !state.unsupported;
+                result[index].valid = !state.failed;
+                if (state.failed)
+                    result[index].content.clear();
+
+                activeFiles--;
+                finishedFiles++;
+            };
+
+            auto queueRead = [&](size_t index) {
+                auto &state   = states[index];
+                auto &content = result[index].content;
+
+                auto sqe = ring.getSqe();
+                sqe->opcode    = IORING_OP_READ;
+                sqe->fd        = state.fd;
+                sqe->addr      = reinterpret_cast<u64>(content.data() + state.bytesRead);
+                sqe->len       = u32(std::min<size_t>(content.size() - state.bytesRead, 0x7FFF'F000));
+                sqe->off       = state.bytesRead;
+                sqe->user_data = encodeUserData(index, Operation::Read);
+
+                state.pendingOperations++;
+            };
+
+            auto queueOpenAndStat = [&](size_t index) {
+                auto &state = states[index];
+
+                auto open = ring.getSqe();
+                open->opcode     = IORING_OP_OPENAT;
+                open->fd         = AT_FDCWD;
+                open->addr       = reinterpret_cast<u64>(paths[index].c_str());
+                open->open_flags = O_RDONLY | O_CLOEXEC;
+                open->user_data  = encodeUserData(index, Operation::Open);
+
+                // Stat by path so it doesn't have to wait for the open to complete
+                auto stat = ring.getSqe();
+                stat->opcode      = IORING_OP_STATX;
+                stat->fd          = AT_FDCWD;
+                stat->addr        = reinterpret_cast<u64>(paths[index].c_str());
+                stat->len         = STATX_TYPE | STATX_SIZE;
+                stat->off         = reinterpret_cast<u64>(&state.status);
+                stat->statx_flags = AT_STATX_SYNC_AS_STAT;
+                stat->user_data   = encodeUserData(index, Operation::Stat);
+
+                state.pendingOperations += 2;
+                activeFiles++;
+            };
+
+            auto handleCompletion = [&](const io_uring_cqe &cqe) {
+                const auto index     = size_t(cqe.user_data >> 2);
+                const auto operation = Operation(cqe.user_data & 0b11);
+
+                auto &state   = states[index];
+                auto &content = result[index].content;
+
+                state.pendingOperations--;
+
+                if (isUnsupported(cqe.res))
+                    state.unsupported = true;
+
+                switch (operation) {
+                    case Operation::Open:
+                        if (cqe.res < 0)
+                            state.failed = true;
+                        else
+                            state.fd = cqe.res;
+                        break;
+                    case Operation::Stat:
+                        if (cqe.res < 0 || S_ISDIR(state.status.stx_mode))
+                            state.failed = true;
+                        break;
+                    case Operation::Read:
+                        if (cqe.res < 0) {
+                            if (cqe.res == -EINTR || cqe.res == -EAGAIN) {
+                                queueRead(index);
+                                return;
+                            }
+
+                            state.failed = true;
+                            finish(index);
+                            return;
+                        }
+
+                        state.bytesRead += cqe.res;
+
+                        if (cqe.res == 0 || (state.bytesRead == content.size() && state.status.stx_size != 0)) {
+                            content.resize(state.bytesRead);
+                            finish(index);
+                            return;
+                        }
+
+                        // Files in e.g /proc report a size of zero, keep reading chunks until the end
+                        if (state.bytesRead == content.size())
+                            content.resize(content.size() + ChunkSize);
+
+                        queueRead(index);
+                        return;
+                }
+
+                // Open and stat both completed
+                if (state.pendingOperations == 0) {
+                    if (state.failed) {
+                        finish(index);
+                        return;
+                    }
+
+                    content.resize(state.status.stx_size != 0 ? state.status.stx_size : ChunkSize);
+                    queueRead(index);
+                }
+            };
+
+            while (finishedFiles < paths.size()) {
+                while (nextFile < paths.size() && activeFiles < window)
+                    queueOpenAndStat(nextFile++);
+
+                if (!ring.submitAndWait()) {
+                    // Something went wrong with the ring itself. Leave the remaining files to the fallback
+                    for (auto &state : states) {
+                        if (state.fd >= 0)
+                            ::close(state.fd);
+                        state.fd = -1;
+                    }
+
+                    return false;
+                }
+
+                ring.forEachCompletion(handleCompletion);
+            }
+
+            return true;
+        }
+
+        void loadFilesThreadPool(std::span<const std::fs::path> paths, std::vector<LoadedFile> &result, const std::vector<FileState> &states) {
+            // Loading is bound by I/O latency rather than CPU time, so use more threads than there are cores
+            constexpr static size_t MaxThreads = 16;
+
+            parallelFor(paths.size(), MaxThreads, [&](size_t index) {
+                if (states[index].finished)
+                    return;
+
+                auto file = File(paths[index], File::Mode::Read);
+                if (!file.isValid())
+                    return;
+
+                result[index].content = file.readBytes();
+                result[index].valid   = true;
+            });
+        }
+
+    }
+
+    std::vector<LoadedFile> loadFiles(std::span<const std::fs::path> paths, LoadBackend backend) {
+        std::vector<LoadedFile> result(paths.size());
+        std::vector<FileState> states(paths.size());
+
+        for (size_t i = 0; i < paths.size(); i++)
+            result[i].path = paths[i];
+
+        if (paths.empty())
+            return result;
+
+        if (backend != LoadBackend::ThreadPool) {
+            const bool loaded = loadFilesIoUring(paths, result, states);
+            if (backend == LoadBackend::IoUring)
+                return result;
+
+            // Files the ring couldn't handle, or all of them if there's no usable ring, are left to the thread pool
+            if (loaded && std::ranges::all_of(states, &FileState::finished))
+                return result;
+        }
+
+        loadFilesThreadPool(paths, result, states);
+
+        return result;
+    }
+
+}
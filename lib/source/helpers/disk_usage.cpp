@@ -0,0 +1,203 @@
+#include <steam/helpers/disk_usage.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace steam::fs {
+
+    namespace {
+
+        struct Task {
+            std::string path;
+            u32 root;
+        };
+
+        // Owners push and pop on the back of their own queue, idle workers steal the oldest tasks from the front.
+        // The oldest tasks are the directories closest to the root and usually have the most work below them
+        class WorkQueue {
+        public:
+            void push(Task task) {
+                std::scoped_lock lock(this->m_mutex);
+                this->m_tasks.push_back(std::move(task));
+            }
+
+            std::optional<Task> pop() {
+                std::scoped_lock lock(this->m_mutex);
+                if (this->m_tasks.empty())
+                    return std::nullopt;
+
+                auto task = std::move(this->m_tasks.back());
+                this->m_tasks.pop_back();
+
+                return task;
+            }
+
+            std::optional<Task> steal() {
+                std::scoped_lock lock(this->m_mutex);
+                if (this->m_tasks.empty())
+                    return std::nullopt;
+
+                auto task = std::move(this->m_tasks.front());
+                this->m_tasks.pop_front();
+
+                return task;
+            }
+
+        private:
+            std::mutex m_mutex;
+            std::deque<Task> m_tasks;
+        };
+
+        void addEntry(DiskUsage &usage, const struct statx &status) {
+            usage.size          += status.stx_size;
+            usage.allocatedSize += status.stx_blocks * 512;
+
+            if (S_ISDIR(status.stx_mode))
+                usage.directoryCount++;
+            else
+                usage.fileCount++;
+        }
+
+        // Adds up all entries of a single directory and hands its subdirectories to pushTask
+        void scanDirectory(const Task &task, DiskUsage &usage, auto &&pushTask) {
+            const int fd = ::open(task.path.c_str(), O_RDONLY | O_DIRECTORY | O_NOFOLLOW | O_CLOEXEC);
+            if (fd < 0)
+                return;
+
+            constexpr static u32 StatxMask  = STATX_TYPE | STATX_SIZE | STATX_BLOCKS;
+            constexpr static int StatxFlags = AT_SYMLINK_NOFOLLOW | AT_STATX_DONT_SYNC;
+
+            alignas(8) u8 buffer[32 * 1024];
+            while (true) {
+                const auto size = ::syscall(SYS_getdents64, fd, buffer, sizeof(buffer));
+                if (size <= 0)
+                    break;
+
+                for (long offset = 0; offset < size;) {
+                    u16 recordLength;
+                    std::memcpy(&recordLength, buffer + offset + offsetof(struct dirent64, d_reclen), sizeof(recordLength));
+
+                    const u8 type  = buffer[offset + offsetof(struct dirent64, d_type)];
+                    const auto name = reinterpret_cast<const char*>(buffer + offset + offsetof(struct dirent64, d_name));
+                    offset += recordLength;
+
+                    if (std::strcmp(name, ".") == 0 || std::strcmp(name, "..") == 0)
+                        continue;
+
+                    struct statx status = { };
+                    if (::statx(fd, name, StatxFlags, StatxMask, &status) != 0)
+                        continue;
+
+                    addEntry(usage, status);
+
+                    if (type == DT_DIR || (type == DT_UNKNOWN && S_ISDIR(status.stx_mode)))
+                        pushTask(Task { task.path + '/' + name, task.root });
+                }
+            }
+
+            ::close(fd);
+        }
+
+    }
+
+    std::vector<DiskUsage> measureDirectories(std::span<const std::fs::path> roots) {
+        const size_t workerCount = std::max<size_t>(1, std::thread::hardware_concurrency());
+
+        std::vector<WorkQueue> queues(workerCount);
+        std::vector<std::vector<DiskUsage>> partialUsages(workerCount, std::vector<DiskUsage>(roots.size()));
+
+        // Counts queued and running tasks, workers are done once it drops to zero
+        std::atomic<size_t> pendingTasks = 0;
+
+        // Idle workers are parked here instead of spinning, every pushed task bumps the generation and wakes one of them
+        std::mutex idleMutex;
+        std::condition_variable idle;
+        u64 generation = 0;
+
+        for (u32 root = 0; root < roots.size(); root++) {
+            struct statx status = { };
+            if (::statx(AT_FDCWD, roots[root].c_str(), AT_SYMLINK_NOFOLLOW, STATX_TYPE | STATX_SIZE | STATX_BLOCKS, &status) != 0)
+                continue;
+
+            addEntry(partialUsages[0][root], status);
+            if (!S_ISDIR(status.stx_mode))
+                continue;
+
+            pendingTasks++;
+            queues[root % workerCount].push(Task { roots[root].native(), root });
+        }
+
+        auto work = [&](size_t worker) {
+            auto pushTask = [&](Task task) {
+                pendingTasks.fetch_add(1, std::memory_order_relaxed);
+                queues[worker].push(std::move(task));
+
+                {
+                    std::scoped_lock lock(idleMutex);
+                    generation++;
+                }
+                idle.notify_one();
+            };
+
+            while (pendingTasks.load(std::memory_order_acquire) > 0) {
+                u64 seenGeneration;
+                {
+                    std::scoped_lock lock(idleMutex);
+                    seenGeneration = generation;
+                }
+
+                auto task = queues[worker].pop();
+                for (size_t i = 1; i < workerCount && !task.has_value(); i++)
+                    task = queues[(worker + i) % workerCount].steal();
+
+                // Nothing to steal right now. Sleep until a task got pushed after looking through the queues or everything is done
+                if (!task.has_value()) {
+                    std::unique_lock lock(idleMutex);
+                    idle.wait(lock, [&] {
+                        return generation != seenGeneration || pendingTasks.load(std::memory_order_acquire) == 0;
+                    });
+
+                    continue;
+                }
+
+                scanDirectory(*task, partialUsages[worker][task->root], pushTask);
+
+                // Taking the lock makes sure no worker is between checking its wait condition and going to sleep
+                if (pendingTasks.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                    std::scoped_lock lock(idleMutex);
+                    idle.notify_all();
+                }
+            }
+        };
+
+        {
+            std::vector<std::jthread> workers;
+            for (size_t worker = 1; worker < workerCount; worker++)
+                workers.emplace_back(work, worker);
+
+            work(0);
+        }
+
+        std::vector<DiskUsage> result(roots.size());
+        for (const auto &usages : partialUsages) {
+            for (size_t root = 0; root < roots.size(); root++)
+                result[root] += usages[root];
+        }
+
+        return result;
+    }
+
+}
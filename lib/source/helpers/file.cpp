@@ -1,25 +1,43 @@
 #include <steam/helpers/file.hpp>
+
+#include <algorithm>
+#include <cerrno>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
 #include <unistd.h>
 
 namespace steam::fs {
 
     File::File(const std::fs::path &path, Mode mode) noexcept : m_path(path) {
+        constexpr static int Flags = O_CLOEXEC | O_LARGEFILE;
+
         if (mode == File::Mode::Read)
-            this->m_file = fopen64(path.string().c_str(), "rb");
+            this->m_fd = ::open(path.c_str(), Flags | O_RDONLY);
         else if (mode == File::Mode::Write)
-            this->m_file = fopen64(path.string().c_str(), "r+b");
+            this->m_fd = ::open(path.c_str(), Flags | O_RDWR);
+        else
+            this->m_fd = -1;
+
+        if (mode == File::Mode::Create || (mode == File::Mode::Write && this->m_fd < 0))
+            this->m_fd = ::open(path.c_str(), Flags | O_RDWR | O_CREAT | O_TRUNC, 0666);
 
-        if (mode == File::Mode::Create || (mode == File::Mode::Write && this->m_file == nullptr))
-            this->m_file = fopen64(path.string().c_str(), "w+b");
+        // Directories can be opened for reading but aren't files
+        struct stat64 status = { };
+        if (this->m_fd >= 0 && (::fstat64(this->m_fd, &status) != 0 || S_ISDIR(status.st_mode)))
+            this->close();
     }
 
     File::File() noexcept {
-        this->m_file = nullptr;
+        this->m_fd = -1;
     }
 
     File::File(File &&other) noexcept {
-        this->m_file = other.m_file;
-        other.m_file = nullptr;
+        this->m_fd = other.m_fd;
+        other.m_fd = -1;
+
+        this->m_path = std::move(other.m_path);
     }
 
     File::~File() {
@@ -27,8 +45,13 @@ namespace steam::fs {
     }
 
     File &File::operator=(File &&other) noexcept {
-        this->m_file = other.m_file;
-        other.m_file = nullptr;
+        if (this == &other)
+            return *this;
+
+        this->close();
+
+        this->m_fd = other.m_fd;
+        other.m_fd = -1;
 
         this->m_path = std::move(other.m_path);
 
@@ -37,100 +60,215 @@ namespace steam::fs {
 
 
     void File::seek(u64 offset) {
-        fseeko64(this->m_file, offset, SEEK_SET);
+        if (!isValid()) return;
+
+        ::lseek64(this->m_fd, offset, SEEK_SET);
     }
 
     void File::close() {
         if (isValid()) {
-            std::fclose(this->m_file);
-            this->m_file = nullptr;
+            ::close(this->m_fd);
+            this->m_fd = -1;
         }
     }
 
     size_t File::readBuffer(u8 *buffer, size_t size) {
         if (!isValid()) return 0;
 
-        return fread(buffer, size, 1, this->m_file);
+        size_t bytesRead = 0;
+        while (bytesRead < size) {
+            auto result = ::read(this->m_fd, buffer + bytesRead, size - bytesRead);
+            if (result < 0 && errno == EINTR)
+                continue;
+            if (result <= 0)
+                break;
+
+            bytesRead += result;
+        }
+
+        return bytesRead;
     }
 
-    std::vector<u8> File::readBytes(size_t numBytes) {
-        if (!isValid()) return {};
+    size_t File::readBufferAt(u64 offset, u8 *buffer, size_t size) const {
+        if (!isValid()) return 0;
+
+        size_t bytesRead = 0;
+        while (bytesRead < size) {
+            auto result = ::pread64(this->m_fd, buffer + bytesRead, size - bytesRead, offset + bytesRead);
+            if (result < 0 && errno == EINTR)
+                continue;
+            if (result <= 0)
+                break;
+
+            bytesRead += result;
+        }
+
+        return bytesRead;
+    }
+
+    template<typename Container>
+    static Container readContainer(File &file, size_t numBytes) {
+        Container result;
+
+        if (numBytes != 0) {
+            result.resize(numBytes);
+            result.resize(file.readBuffer(reinterpret_cast<u8 *>(result.data()), numBytes));
 
-        auto size = numBytes ?: getSize();
-        if (size == 0) return {};
+            return result;
+        }
+
+        // Read everything that's left. Files in e.g /proc report a size of zero, fall back to reading chunks until the end
+        auto offset = ::lseek64(file.getHandle(), 0, SEEK_CUR);
+        auto size   = file.getSize();
+
+        if (offset >= 0 && size_t(offset) < size) {
+            result.resize(size - offset);
+            result.resize(file.readBuffer(reinterpret_cast<u8 *>(result.data()), result.size()));
+
+            return result;
+        }
+
+        constexpr static size_t ChunkSize = 4096;
+        while (true) {
+            const auto oldSize = result.size();
+            result.resize(oldSize + ChunkSize);
 
-        std::vector<u8> bytes(size);
-        auto bytesRead = fread(bytes.data(), 1, bytes.size(), this->m_file);
+            auto bytesRead = file.readBuffer(reinterpret_cast<u8 *>(result.data()) + oldSize, ChunkSize);
+            result.resize(oldSize + bytesRead);
 
-        bytes.resize(bytesRead);
+            if (bytesRead < ChunkSize)
+                break;
+        }
 
-        return bytes;
+        return result;
+    }
+
+    std::vector<u8> File::readBytes(size_t numBytes) {
+        if (!isValid()) return {};
+
+        return readContainer<std::vector<u8>>(*this, numBytes);
     }
 
     std::string File::readString(size_t numBytes) {
         if (!isValid()) return {};
 
-        if (getSize() == 0) return {};
+        return readContainer<std::string>(*this, numBytes);
+    }
+
+    bool File::write(const u8 *buffer, size_t size) {
+        if (!isValid()) return false;
 
-        auto bytes = readBytes(numBytes);
+        size_t bytesWritten = 0;
+        while (bytesWritten < size) {
+            auto result = ::write(this->m_fd, buffer + bytesWritten, size - bytesWritten);
+            if (result < 0 && errno == EINTR)
+                continue;
+            if (result <= 0)
+                return false;
 
-        if (bytes.empty())
-            return "";
+            bytesWritten += result;
+        }
 
-        return { reinterpret_cast<char *>(bytes.data()), bytes.size() };
+        return true;
     }
 
-    void File::write(const u8 *buffer, size_t size) {
-        if (!isValid()) return;
+    bool File::write(const std::vector<u8> &bytes) {
+        return this->write(bytes.data(), bytes.size());
+    }
 
-        std::fwrite(buffer, size, 1, this->m_file);
+    bool File::write(const std::string &string) {
+        return this->write(reinterpret_cast<const u8 *>(string.data()), string.size());
     }
 
-    void File::write(const std::vector<u8> &bytes) {
-        if (!isValid()) return;
+    bool File::writeAt(u64 offset, const u8 *buffer, size_t size) {
+        if (!isValid()) return false;
+
+        size_t bytesWritten = 0;
+        while (bytesWritten < size) {
+            auto result = ::pwrite64(this->m_fd, buffer + bytesWritten, size - bytesWritten, offset + bytesWritten);
+            if (result < 0 && errno == EINTR)
+                continue;
+            if (result <= 0)
+                return false;
+
+            bytesWritten += result;
+        }
 
-        std::fwrite(bytes.data(), 1, bytes.size(), this->m_file);
+        return true;
     }
 
-    void File::write(const std::string &string) {
-        if (!isValid()) return;
+    bool File::writeVectored(std::span<const std::span<const u8>> buffers) {
+        if (!isValid()) return false;
+
+        constexpr static size_t MaxBatchSize = 64;
+
+        std::vector<iovec> vectors;
+        vectors.reserve(std::min(buffers.size(), MaxBatchSize));
 
-        std::fwrite(string.data(), string.size(), 1, this->m_file);
+        while (!buffers.empty()) {
+            vectors.clear();
+            for (const auto &buffer : buffers.first(std::min(buffers.size(), MaxBatchSize)))
+                vectors.push_back({ const_cast<u8 *>(buffer.data()), buffer.size() });
+
+            auto remaining = std::span(vectors);
+            while (!remaining.empty()) {
+                auto result = ::writev(this->m_fd, remaining.data(), remaining.size());
+                if (result < 0 && errno == EINTR)
+                    continue;
+                if (result < 0)
+                    return false;
+
+                // Skip everything that has been written completely and adjust a partially written buffer
+                size_t bytesWritten = result;
+                while (!remaining.empty() && bytesWritten >= remaining.front().iov_len) {
+                    bytesWritten -= remaining.front().iov_len;
+                    remaining = remaining.subspan(1);
+                }
+
+                if (!remaining.empty()) {
+                    if (result == 0)
+                        return false;
+
+                    remaining.front().iov_base = static_cast<u8 *>(remaining.front().iov_base) + bytesWritten;
+                    remaining.front().iov_len -= bytesWritten;
+                }
+            }
+
+            buffers = buffers.subspan(std::min(buffers.size(), MaxBatchSize));
+        }
+
+        return true;
     }
 
     size_t File::getSize() const {
         if (!isValid()) return 0;
 
-        auto startPos = ftello64(this->m_file);
-        fseeko64(this->m_file, 0, SEEK_END);
-        auto size = ftello64(this->m_file);
-        fseeko64(this->m_file, startPos, SEEK_SET);
-
-        if (size < 0)
+        struct stat64 status = { };
+        if (::fstat64(this->m_fd, &status) != 0)
             return 0;
 
-        return size;
+        return status.st_size;
     }
 
     void File::setSize(u64 size) {
         if (!isValid()) return;
 
-        ftruncate64(fileno(this->m_file), size);
+        ::ftruncate64(this->m_fd, size);
     }
 
     void File::flush() {
-        std::fflush(this->m_file);
+        // Nothing is buffered in user space
     }
 
-    bool File::remove() {
-        this->close();
-        return std::remove(this->m_path.string().c_str()) == 0;
-    }
+    bool File::sync() {
+        if (!isValid()) return false;
 
-    void File::disableBuffering() {
-        if (!isValid()) return;
+        return ::fsync(this->m_fd) == 0;
+    }
 
-        std::setvbuf(this->m_file, nullptr, _IONBF, 0);
+    bool File::remove() {
+        this->close();
+        return ::unlink(this->m_path.c_str()) == 0;
     }
 
-}
\ No newline at end of file
+}
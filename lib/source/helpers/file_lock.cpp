@@ -0,0 +1,65 @@
+#include <steam/helpers/file_lock.hpp>
+
+#include <cerrno>
+
+#include <fcntl.h>
+#include <sys/file.h>
+#include <unistd.h>
+
+namespace steam::fs {
+
+    FileLock::FileLock(const std::fs::path &path, Mode mode, bool wait) noexcept {
+        auto lockPath = path;
+        lockPath += ".lock";
+
+        this->m_fd = ::open(lockPath.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+        if (this->m_fd < 0)
+            return;
+
+        int operation = mode == Mode::Shared ? LOCK_SH : LOCK_EX;
+        if (!wait)
+            operation |= LOCK_NB;
+
+        int result;
+        do {
+            result = ::flock(this->m_fd, operation);
+        } while (result != 0 && errno == EINTR);
+
+        if (result != 0)
+            this->unlock();
+    }
+
+    FileLock::FileLock() noexcept {
+        this->m_fd = -1;
+    }
+
+    FileLock::FileLock(FileLock &&other) noexcept {
+        this->m_fd = other.m_fd;
+        other.m_fd = -1;
+    }
+
+    FileLock::~FileLock() {
+        this->unlock();
+    }
+
+    FileLock &FileLock::operator=(FileLock &&other) noexcept {
+        if (this == &other)
+            return *this;
+
+        this->unlock();
+
+        this->m_fd = other.m_fd;
+        other.m_fd = -1;
+
+        return *this;
+    }
+
+    void FileLock::unlock() {
+        // Closing the last descriptor referring to the lock releases it
+        if (this->isLocked())
+            ::close(this->m_fd);
+
+        this->m_fd = -1;
+    }
+
+}
@@ -0,0 +1,147 @@
+#include <steam/helpers/fs.hpp>
+#include <steam/helpers/file.hpp>
+
+#include <cerrno>
+#include <cstdlib>
+#include <optional>
+
+#include <fcntl.h>
+#include <linux/fs.h>
+#include <sys/ioctl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace steam::fs {
+
+    // Creates a new, uniquely named file next to path and returns its name
+    static std::optional<std::fs::path> createTemporaryFile(const std::fs::path &path) {
+        auto name = path.string() + ".XXXXXX";
+
+        int fd = ::mkostemp(name.data(), O_CLOEXEC);
+        if (fd < 0)
+            return std::nullopt;
+
+        ::close(fd);
+
+        return name;
+    }
+
+    static bool syncDirectory(const std::fs::path &path) {
+        auto directory = path.parent_path();
+        if (directory.empty())
+            directory = ".";
+
+        int fd = ::open(directory.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+        if (fd < 0)
+            return false;
+
+        bool result = ::fsync(fd) == 0;
+        ::close(fd);
+
+        return result;
+    }
+
+    // Hands the file to the owner of the file it's replacing. Otherwise running as root would leave e.g shortcuts.vdf owned by root
+    // and Steam couldn't write it anymore. Unprivileged processes can't give files away, which is fine since they only create their own
+    static bool copyOwnership(int fd, const struct stat64 &status) {
+        if (status.st_uid == ::geteuid() && status.st_gid == ::getegid())
+            return true;
+
+        return ::fchown(fd, status.st_uid, status.st_gid) == 0 || errno == EPERM;
+    }
+
+    bool writeFileAtomic(const std::fs::path &path, const std::function<bool(File &file)> &writer) {
+        auto temporaryPath = createTemporaryFile(path);
+        if (!temporaryPath.has_value())
+            return false;
+
+        {
+            auto file = File(*temporaryPath, File::Mode::Write);
+
+            // Keep the owner and permissions of the file that's being replaced, mkostemp creates files only accessible by us.
+            // Changing the owner clears the setuid and setgid bits, so it has to happen first
+            struct stat64 status = { };
+            bool exists = ::stat64(path.c_str(), &status) == 0;
+            if (exists && !copyOwnership(file.getHandle(), status)) {
+                file.remove();
+                return false;
+            }
+
+            ::fchmod(file.getHandle(), exists ? status.st_mode & 07777 : 0644);
+
+            if (!writer(file) || !file.sync()) {
+                file.remove();
+                return false;
+            }
+        }
+
+        if (::rename(temporaryPath->c_str(), path.c_str()) != 0) {
+            ::unlink(temporaryPath->c_str());
+            return false;
+        }
+
+        return syncDirectory(path);
+    }
+
+    bool writeFileAtomic(const std::fs::path &path, std::span<const u8> data) {
+        return writeFileAtomic(path, [data](File &file) { return file.write(data.data(), data.size()); });
+    }
+
+    bool writeFileAtomic(const std::fs::path &path, std::string_view data) {
+        return writeFileAtomic(path, std::span(reinterpret_cast<const u8 *>(data.data()), data.size()));
+    }
+
+    // Copies the contents of one file into another inside of the kernel. Reflinks are used where the
+    // filesystem supports them, otherwise copy_file_range still avoids moving the data through user space
+    static bool cloneFile(const std::fs::path &from, const std::fs::path &to) {
+        auto source      = File(from, File::Mode::Read);
+        auto destination = File(to, File::Mode::Write);
+        if (!source.isValid() || !destination.isValid())
+            return false;
+
+        // Backups belong to the same user as the file they're made of
+        struct stat64 status = { };
+        if (::fstat64(source.getHandle(), &status) != 0 || !copyOwnership(destination.getHandle(), status))
+            return false;
+
+        ::fchmod(destination.getHandle(), status.st_mode & 07777);
+
+        if (::ioctl(destination.getHandle(), FICLONE, source.getHandle()) == 0)
+            return true;
+
+        auto remaining = source.getSize();
+        while (remaining > 0) {
+            auto result = ::copy_file_range(source.getHandle(), nullptr, destination.getHandle(), nullptr, remaining, 0);
+            if (result < 0 && errno == EINTR)
+                continue;
+            if (result <= 0)
+                return false;
+
+            remaining -= result;
+        }
+
+        return true;
+    }
+
+    bool backupFile(const std::fs::path &from, const std::fs::path &to) {
+        auto temporaryPath = createTemporaryFile(to);
+        if (!temporaryPath.has_value())
+            return false;
+
+        // Files are only ever replaced through writeFileAtomic, never modified in place, so a hardlink
+        // keeps referring to the old contents once the original has been replaced
+        bool created = cloneFile(from, *temporaryPath);
+        if (!created) {
+            ::unlink(temporaryPath->c_str());
+            created = ::link(from.c_str(), temporaryPath->c_str()) == 0;
+        }
+
+        if (!created || ::rename(temporaryPath->c_str(), to.c_str()) != 0) {
+            ::unlink(temporaryPath->c_str());
+            return false;
+        }
+
+        return true;
+    }
+
+}
@@ -0,0 +1,203 @@
+#include <steam/helpers/hash.hpp>
+
+#include <bit>
+#include <cstring>
+
+#if defined(__x86_64__)
+    #include <immintrin.h>
+#elif defined(__aarch64__)
+    #include <arm_acle.h>
+    #include <sys/auxv.h>
+    #include <asm/hwcap.h>
+#endif
+
+namespace steam::impl {
+
+    namespace {
+
+        // Folding only pays off once there's a few blocks of data to work on
+        constexpr static size_t FoldingThreshold = 64;
+
+        u32 load32(const u8 *data) {
+            u32 value;
+            std::memcpy(&value, data, sizeof(value));
+
+            if constexpr (std::endian::native == std::endian::big)
+                value = __builtin_bswap32(value);
+
+            return value;
+        }
+
+        u32 crc32Slicing(const Crc32Tables &tables, u32 crc, const u8 *data, size_t size) {
+            const auto &s = tables.slices;
+
+            while (size >= 16) {
+                const u32 a = load32(data + 0) ^ crc;
+                const u32 b = load32(data + 4);
+                const u32 c = load32(data + 8);
+                const u32 d = load32(data + 12);
+
+                crc = s[15][a & 0xFF] ^ s[14][(a >> 8) & 0xFF] ^ s[13][(a >> 16) & 0xFF] ^ s[12][a >> 24] ^
+                      s[11][b & 0xFF] ^ s[10][(b >> 8) & 0xFF] ^ s[ 9][(b >> 16) & 0xFF] ^ s[ 8][b >> 24] ^
+                      s[ 7][c & 0xFF] ^ s[ 6][(c >> 8) & 0xFF] ^ s[ 5][(c >> 16) & 0xFF] ^ s[ 4][c >> 24] ^
+                      s[ 3][d & 0xFF] ^ s[ 2][(d >> 8) & 0xFF] ^ s[ 1][(d >> 16) & 0xFF] ^ s[ 0][d >> 24];
+
+                data += 16;
+                size -= 16;
+            }
+
+            if (size >= 8) {
+                const u32 a = load32(data + 0) ^ crc;
+                const u32 b = load32(data + 4);
+
+                crc = s[7][a & 0xFF] ^ s[6][(a >> 8) & 0xFF] ^ s[5][(a >> 16) & 0xFF] ^ s[4][a >> 24] ^
+                      s[3][b & 0xFF] ^ s[2][(b >> 8) & 0xFF] ^ s[1][(b >> 16) & 0xFF] ^ s[0][b >> 24];
+
+                data += 8;
+                size -= 8;
+            }
+
+            while (size > 0) {
+                crc = s[0][(crc ^ *data) & 0xFF] ^ (crc >> 8);
+
+                data++;
+                size--;
+            }
+
+            return crc;
+        }
+
+    #if defined(__x86_64__)
+
+        [[gnu::target("pclmul,sse4.1")]]
+        __m128i fold(__m128i value, __m128i next, __m128i k) {
+            const __m128i low = _mm_clmulepi64_si128(value, k, 0x00);
+
+            return _mm_xor_si128(_mm_xor_si128(_mm_clmulepi64_si128(value, k, 0x11), next), low);
+        }
+
+        // Folds 64 byte blocks with carry-less multiplications and reduces the remainder with a Barrett reduction.
+        // Works for any polynomial, the constants are derived from it in createCrc32Tables(). Size needs to be a multiple of 16
+        [[gnu::target("pclmul,sse4.1")]]
+        u32 crc32Folding(const Crc32Tables &tables, u32 crc, const u8 *data, size_t size) {
+            auto load = [](const u8 *address) {
+                return _mm_loadu_si128(reinterpret_cast<const __m128i*>(address));
+            };
+
+            __m128i x1 = _mm_xor_si128(load(data + 0x00), _mm_cvtsi32_si128(i32(crc)));
+            __m128i x2 = load(data + 0x10);
+            __m128i x3 = load(data + 0x20);
+            __m128i x4 = load(data + 0x30);
+
+            data += 64;
+            size -= 64;
+
+            __m128i k = _mm_set_epi64x(i64(tables.foldBy4[1]), i64(tables.foldBy4[0]));
+            while (size >= 64) {
+                const __m128i x5 = _mm_clmulepi64_si128(x1, k, 0x00);
+                const __m128i x6 = _mm_clmulepi64_si128(x2, k, 0x00);
+                const __m128i x7 = _mm_clmulepi64_si128(x3, k, 0x00);
+                const __m128i x8 = _mm_clmulepi64_si128(x4, k, 0x00);
+
+                x1 = _mm_xor_si128(_mm_xor_si128(_mm_clmulepi64_si128(x1, k, 0x11), x5), load(data + 0x00));
+                x2 = _mm_xor_si128(_mm_xor_si128(_mm_clmulepi64_si128(x2, k, 0x11), x6), load(data + 0x10));
+                x3 = _mm_xor_si128(_mm_xor_si128(_mm_clmulepi64_si128(x3, k, 0x11), x7), load(data + 0x20));
+                x4 = _mm_xor_si128(_mm_xor_si128(_mm_clmulepi64_si128(x4, k, 0x11), x8), load(data + 0x30));
+
+                data += 64;
+                size -= 64;
+            }
+
+            // Fold the four lanes and any remaining 16 byte blocks into a single one
+            k = _mm_set_epi64x(i64(tables.foldBy1[1]), i64(tables.foldBy1[0]));
+
+            x1 = fold(x1, x2, k);
+            x1 = fold(x1, x3, k);
+            x1 = fold(x1, x4, k);
+
+            while (size >= 16) {
+                x1 = fold(x1, load(data), k);
+
+                data += 16;
+                size -= 16;
+            }
+
+            // Reduce 128 bits to 64 bits
+            const __m128i mask = _mm_setr_epi32(~0, 0, ~0, 0);
+
+            x2 = _mm_clmulepi64_si128(x1, k, 0x10);
+            x1 = _mm_xor_si128(_mm_srli_si128(x1, 8), x2);
+
+            k  = _mm_set_epi64x(0, i64(tables.fold64));
+            x2 = _mm_srli_si128(x1, 4);
+            x1 = _mm_xor_si128(_mm_clmulepi64_si128(_mm_and_si128(x1, mask), k, 0x00), x2);
+
+            // Barrett reduction down to 32 bits
+            k  = _mm_set_epi64x(i64(tables.barrett[1]), i64(tables.barrett[0]));
+            x2 = _mm_clmulepi64_si128(_mm_and_si128(x1, mask), k, 0x10);
+            x2 = _mm_clmulepi64_si128(_mm_and_si128(x2, mask), k, 0x00);
+            x1 = _mm_xor_si128(x1, x2);
+
+            return u32(_mm_extract_epi32(x1, 1));
+        }
+
+        bool isFoldingSupported() {
+            static const bool supported = __builtin_cpu_supports("pclmul") && __builtin_cpu_supports("sse4.1");
+
+            return supported;
+        }
+
+    #elif defined(__aarch64__)
+
+        // The CRC32 instructions are hardwired to the standard polynomial and can't be used for any other one
+        constexpr static u32 HardwarePolynomial = 0xEDB88320;
+
+        [[gnu::target("arch=armv8-a+crc")]]
+        u32 crc32Hardware(u32 crc, const u8 *data, size_t size) {
+            while (size >= sizeof(u64)) {
+                u64 value;
+                std::memcpy(&value, data, sizeof(value));
+                crc = __crc32d(crc, value);
+
+                data += sizeof(u64);
+                size -= sizeof(u64);
+            }
+
+            while (size > 0) {
+                crc = __crc32b(crc, *data);
+
+                data++;
+                size--;
+            }
+
+            return crc;
+        }
+
+        bool isHardwareSupported() {
+            static const bool supported = (::getauxval(AT_HWCAP) & HWCAP_CRC32) != 0;
+
+            return supported;
+        }
+
+    #endif
+
+    }
+
+    u32 crc32Update(const Crc32Tables &tables, u32 crc, const u8 *data, size_t size) {
+        #if defined(__x86_64__)
+            if (size >= FoldingThreshold && isFoldingSupported()) {
+                const auto foldedSize = size & ~size_t(15);
+
+                crc   = crc32Folding(tables, crc, data, foldedSize);
+                data += foldedSize;
+                size -= foldedSize;
+            }
+        #elif defined(__aarch64__)
+            if (tables.polynomial == HardwarePolynomial && isHardwareSupported())
+                return crc32Hardware(crc, data, size);
+        #endif
+
+        return crc32Slicing(tables, crc, data, size);
+    }
+
+}
@@ -0,0 +1,100 @@
+#include <steam/helpers/mapped_file.hpp>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace steam::fs {
+
+    MappedFile::MappedFile(const std::fs::path &path, Access access) noexcept : m_path(path) {
+        int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0)
+            return;
+
+        struct stat64 status = { };
+        if (::fstat64(fd, &status) != 0 || !S_ISREG(status.st_mode)) {
+            ::close(fd);
+            return;
+        }
+
+        // Empty files can't be mapped but are still perfectly valid files
+        if (status.st_size == 0) {
+            ::close(fd);
+            this->m_valid = true;
+            return;
+        }
+
+        void *data = ::mmap(nullptr, status.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+
+        if (data == MAP_FAILED)
+            return;
+
+        switch (access) {
+            case Access::Sequential:
+                ::madvise(data, status.st_size, MADV_SEQUENTIAL);
+                ::madvise(data, status.st_size, MADV_WILLNEED);
+                break;
+            case Access::Random:
+                ::madvise(data, status.st_size, MADV_RANDOM);
+                break;
+            default:
+                break;
+        }
+
+        this->m_data  = static_cast<const u8 *>(data);
+        this->m_size  = status.st_size;
+        this->m_valid = true;
+    }
+
+    MappedFile::MappedFile(MappedFile &&other) noexcept {
+        *this = std::move(other);
+    }
+
+    MappedFile::~MappedFile() {
+        this->close();
+    }
+
+    MappedFile &MappedFile::operator=(MappedFile &&other) noexcept {
+        if (this == &other)
+            return *this;
+
+        this->close();
+
+        this->m_data  = other.m_data;
+        this->m_size  = other.m_size;
+        this->m_valid = other.m_valid;
+        this->m_path  = std::move(other.m_path);
+
+        other.m_data  = nullptr;
+        other.m_size  = 0;
+        other.m_valid = false;
+
+        return *this;
+    }
+
+    void MappedFile::close() {
+        if (this->m_data != nullptr)
+            ::munmap(const_cast<u8 *>(this->m_data), this->m_size);
+
+        this->m_data  = nullptr;
+        this->m_size  = 0;
+        this->m_valid = false;
+    }
+
+    void MappedFile::prefetch(size_t offset, size_t size) const {
+        if (this->m_data == nullptr || offset >= this->m_size)
+            return;
+
+        if (size == 0 || size > this->m_size - offset)
+            size = this->m_size - offset;
+
+        // madvise needs a page aligned start address
+        const auto pageSize = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+        const auto start    = offset & ~(pageSize - 1);
+
+        ::madvise(const_cast<u8 *>(this->m_data) + start, size + (offset - start), MADV_WILLNEED);
+    }
+
+}
@@ -43,9 +43,12 @@ namespace steam {
     }
 
     static size_t writeToFile(void *contents, size_t size, size_t nmemb, void *userdata) {
-        FILE *file = static_cast<FILE *>(userdata);
+        auto &file = *static_cast<fs::File *>(userdata);
+
+        if (!file.write(static_cast<const u8 *>(contents), size * nmemb))
+            return 0;
 
-        return fwrite(contents, size, nmemb, file);
+        return size * nmemb;
     }
 
     int progressCallback(void *contents, curl_off_t dlTotal, curl_off_t dlNow, curl_off_t ulTotal, curl_off_t ulNow) {
@@ -115,9 +118,10 @@ namespace steam {
     }
 
     std::future<Response<std::string>> Net::getString(const std::string &url, u32 timeout, const std::map<std::string, std::string> &extraHeaders, const std::string &body) {
-        this->m_transmissionActive.lock();
-
         return std::async(std::launch::async, [=, this] {
+            // Owned by the task itself, a mutex must be unlocked by the thread that locked it
+            std::scoped_lock lock(this->m_transmissionActive);
+
             std::string response;
 
             curl_easy_setopt(this->m_ctx, CURLOPT_CUSTOMREQUEST, "GET");
@@ -125,16 +129,14 @@ namespace steam {
 
             auto responseCode = execute();
 
-            this->m_transmissionActive.unlock();
-
             return Response<std::string> { responseCode.value_or(0), response };
         });
     }
 
     std::future<Response<nlohmann::json>> Net::getJson(const std::string &url, u32 timeout, const std::map<std::string, std::string> &extraHeaders, const std::string &body) {
-        this->m_transmissionActive.lock();
-
         return std::async(std::launch::async, [=, this] {
+            std::scoped_lock lock(this->m_transmissionActive);
+
             std::string response;
 
             curl_easy_setopt(this->m_ctx, CURLOPT_CUSTOMREQUEST, "GET");
@@ -142,16 +144,14 @@ namespace steam {
 
             auto responseCode = execute();
 
-            this->m_transmissionActive.unlock();
-
             return Response<nlohmann::json> { responseCode.value_or(0), nlohmann::json::parse(response, nullptr, false) };
         });
     }
 
     std::future<Response<std::string>> Net::uploadFile(const std::string &url, const std::fs::path &filePath, u32 timeout, const std::map<std::string, std::string> &extraHeaders, const std::string &body) {
-        this->m_transmissionActive.lock();
-
         return std::async(std::launch::async, [=, this] {
+            std::scoped_lock lock(this->m_transmissionActive);
+
             std::string response;
 
             fs::File file(filePath.string(), fs::File::Mode::Read);
@@ -164,13 +164,13 @@ namespace steam {
             auto fileName = filePath.filename().string();
             curl_mime_data_cb(
                     part, file.getSize(), [](char *buffer, size_t size, size_t nitems, void *arg) -> size_t {
-                        auto file = static_cast<FILE*>(arg);
-                        return fread(buffer, size, nitems, file); }, [](void *arg, curl_off_t offset, int origin) -> int {
-                        auto file = static_cast<FILE*>(arg);
-                        fseek(file, offset, origin);
-                        return CURL_SEEKFUNC_OK; }, [](void *arg) {
-                        auto file = static_cast<FILE*>(arg);
-                        fclose(file); }, file.getHandle());
+                        auto file = static_cast<fs::File*>(arg);
+                        return file->readBuffer(reinterpret_cast<u8*>(buffer), size * nitems); }, [](void *arg, curl_off_t offset, int origin) -> int {
+                        auto file = static_cast<fs::File*>(arg);
+                        if (origin != SEEK_SET)
+                            return CURL_SEEKFUNC_CANTSEEK;
+                        file->seek(offset);
+                        return CURL_SEEKFUNC_OK; }, nullptr, &file);
             curl_mime_filename(part, fileName.c_str());
             curl_mime_name(part, "file");
 
@@ -180,16 +180,14 @@ namespace steam {
 
             auto responseCode = execute();
 
-            this->m_transmissionActive.unlock();
-
             return Response<std::string> { responseCode.value_or(0), response };
         });
     }
 
     std::future<Response<void>> Net::downloadFile(const std::string &url, const std::fs::path &filePath, u32 timeout, const std::map<std::string, std::string> &extraHeaders, const std::string &body) {
-        this->m_transmissionActive.lock();
-
         return std::async(std::launch::async, [=, this] {
+            std::scoped_lock lock(this->m_transmissionActive);
+
             std::string response;
 
             fs::File file(filePath.string(), fs::File::Mode::Create);
@@ -199,11 +197,9 @@ namespace steam {
             setCommonSettings(response, url, timeout, extraHeaders, body);
             curl_easy_setopt(this->m_ctx, CURLOPT_CUSTOMREQUEST, "GET");
             curl_easy_setopt(this->m_ctx, CURLOPT_WRITEFUNCTION, writeToFile);
-            curl_easy_setopt(this->m_ctx, CURLOPT_WRITEDATA, file.getHandle());
+            curl_easy_setopt(this->m_ctx, CURLOPT_WRITEDATA, &file);
             auto responseCode = execute();
 
-            this->m_transmissionActive.unlock();
-
             return Response<void> { responseCode.value_or(0) };
         });
     }
@@ -4,9 +4,9 @@
 
 namespace steam {
 
-    bool isIntegerString(std::string string) {
+    bool isIntegerString(std::string_view string) {
         if (string.starts_with('-'))
-            string = string.substr(1);
+            string.remove_prefix(1);
 
         return std::all_of(string.begin(), string.end(), ::isdigit);
     }
@@ -0,0 +1,202 @@
+#include <steam/helpers/watcher.hpp>
+
+#include <algorithm>
+#include <cerrno>
+
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+
+namespace steam::fs {
+
+    constexpr static u32 WatchMask = IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE | IN_DELETE | IN_MOVED_FROM;
+
+    Watcher::Watcher() noexcept {
+        this->m_fd = ::inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    }
+
+    Watcher::Watcher(Watcher &&other) noexcept {
+        this->m_fd = other.m_fd;
+        other.m_fd = -1;
+
+        this->m_directories        = std::move(other.m_directories);
+        this->m_files              = std::move(other.m_files);
+        this->m_watchedDirectories = std::move(other.m_watchedDirectories);
+        this->m_overflowed         = other.m_overflowed;
+    }
+
+    Watcher::~Watcher() {
+        this->close();
+    }
+
+    Watcher &Watcher::operator=(Watcher &&other) noexcept {
+        if (this == &other)
+            return *this;
+
+        this->close();
+
+        this->m_fd = other.m_fd;
+        other.m_fd = -1;
+
+        this->m_directories        = std::move(other.m_directories);
+        this->m_files              = std::move(other.m_files);
+        this->m_watchedDirectories = std::move(other.m_watchedDirectories);
+        this->m_overflowed         = other.m_overflowed;
+
+        return *this;
+    }
+
+    void Watcher::close() {
+        if (this->isValid())
+            ::close(this->m_fd);
+
+        this->m_fd = -1;
+        this->m_directories.clear();
+        this->m_files.clear();
+        this->m_watchedDirectories.clear();
+        this->m_overflowed = false;
+    }
+
+    bool Watcher::watchFile(const std::fs::path &path) {
+        if (!this->isValid())
+            return false;
+
+        auto file      = path.lexically_normal();
+        auto directory = file.parent_path();
+        if (directory.empty())
+            directory = ".";
+
+        // inotify hands out the same watch descriptor again for a directory that's already being watched
+        int wd = ::inotify_add_watch(this->m_fd, directory.c_str(), WatchMask);
+        if (wd < 0)
+            return false;
+
+        this->m_directories[wd] = file.parent_path();
+        this->m_files.insert(file);
+
+        return true;
+    }
+
+    bool Watcher::watchDirectory(const std::fs::path &path) {
+        if (!this->isValid())
+            return false;
+
+        auto directory = path.lexically_normal();
+        if (!directory.has_filename())
+            directory = directory.parent_path();
+
+        int wd = ::inotify_add_watch(this->m_fd, directory.c_str(), WatchMask);
+        if (wd < 0)
+            return false;
+
+        this->m_directories[wd] = directory;
+        this->m_watchedDirectories.insert(std::move(directory));
+
+        return true;
+    }
+
+    bool Watcher::unwatchFile(const std::fs::path &path) {
+        auto file = path.lexically_normal();
+        if (this->m_files.erase(file) == 0)
+            return false;
+
+        // Stop watching the directory once no other file inside of it is of interest anymore
+        const auto directory = file.parent_path();
+        const bool directoryInUse = this->m_watchedDirectories.contains(directory) || std::any_of(this->m_files.begin(), this->m_files.end(), [&](const auto &other) {
+            return other.parent_path() == directory;
+        });
+
+        if (!directoryInUse) {
+            for (auto it = this->m_directories.begin(); it != this->m_directories.end(); ++it) {
+                if (it->second == directory) {
+                    ::inotify_rm_watch(this->m_fd, it->first);
+                    this->m_directories.erase(it);
+                    break;
+                }
+            }
+        }
+
+        return true;
+    }
+
+    bool Watcher::readEvents(std::set<std::fs::path> &changedFiles) {
+        alignas(inotify_event) char buffer[16 * 1024];
+        bool receivedEvents = false;
+
+        while (true) {
+            auto bytesRead = ::read(this->m_fd, buffer, sizeof(buffer));
+            if (bytesRead < 0 && errno == EINTR)
+                continue;
+            if (bytesRead <= 0)
+                break;
+
+            for (char *pointer = buffer; pointer < buffer + bytesRead; ) {
+                const auto event = reinterpret_cast<const inotify_event *>(pointer);
+                pointer += sizeof(inotify_event) + event->len;
+
+                // Overflow notifications don't belong to any watch, everything could have changed
+                if ((event->mask & IN_Q_OVERFLOW) != 0) {
+                    this->m_overflowed = true;
+                    changedFiles.insert(this->m_files.begin(), this->m_files.end());
+                    receivedEvents = true;
+                    continue;
+                }
+
+                auto directory = this->m_directories.find(event->wd);
+                if (directory == this->m_directories.end() || event->len == 0)
+                    continue;
+
+                auto file = directory->second / event->name;
+                if (this->m_files.contains(file) || this->m_watchedDirectories.contains(directory->second)) {
+                    changedFiles.insert(std::move(file));
+                    receivedEvents = true;
+                }
+            }
+        }
+
+        return receivedEvents;
+    }
+
+    std::vector<std::fs::path> Watcher::wait(std::chrono::milliseconds timeout, std::chrono::milliseconds debounce) {
+        if (!this->isValid())
+            return { };
+
+        std::set<std::fs::path> changedFiles;
+        this->m_overflowed = false;
+
+        pollfd pollDescriptor = { .fd = this->m_fd, .events = POLLIN, .revents = 0 };
+
+        using Clock = std::chrono::steady_clock;
+
+        auto deadline = Clock::now() + timeout;
+        while (true) {
+            const auto remaining = std::chrono::ceil<std::chrono::milliseconds>(deadline - Clock::now());
+            if (remaining.count() <= 0)
+                break;
+
+            int result = ::poll(&pollDescriptor, 1, int(remaining.count()));
+            if (result < 0 && errno == EINTR)
+                continue;
+            if (result <= 0)
+                break;
+
+            // Events for files we don't care about don't restart the debounce timer
+            if (this->readEvents(changedFiles))
+                deadline = Clock::now() + debounce;
+        }
+
+        return { changedFiles.begin(), changedFiles.end() };
+    }
+
+    std::vector<std::fs::path> Watcher::getChanges() {
+        if (!this->isValid())
+            return { };
+
+        std::set<std::fs::path> changedFiles;
+        this->m_overflowed = false;
+        this->readEvents(changedFiles);
+
+        return { changedFiles.begin(), changedFiles.end() };
+    }
+
+}
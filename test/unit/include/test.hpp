@@ -0,0 +1,71 @@
+#pragma once
+
+#include <steam.hpp>
+#include <steam/helpers/fs.hpp>
+
+#include <fmt/format.h>
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace steam::test {
+
+    struct TestCase {
+        std::string_view name;
+        void (*function)();
+    };
+
+    std::vector<TestCase>& getTestCases();
+
+    // Marks the currently running test as failed
+    void fail(std::string_view file, u32 line, std::string_view condition);
+
+    struct Registrar {
+        Registrar(std::string_view name, void (*function)()) {
+            getTestCases().push_back({ name, function });
+        }
+    };
+
+    // Fresh directory below the system's temporary directory that gets removed again once the test is done
+    class TemporaryDirectory {
+    public:
+        TemporaryDirectory();
+        ~TemporaryDirectory();
+
+        TemporaryDirectory(const TemporaryDirectory &) = delete;
+        TemporaryDirectory& operator=(const TemporaryDirectory &) = delete;
+
+        [[nodiscard]] const std::fs::path& getPath() const { return this->m_path; }
+
+        std::fs::path operator/(const std::fs::path &path) const {
+            return this->m_path / path;
+        }
+
+    private:
+        std::fs::path m_path;
+    };
+
+    bool writeFile(const std::fs::path &path, std::string_view content);
+    std::string readFile(const std::fs::path &path);
+
+}
+
+#define TEST_CASE(name)                                                            \
+    static void name();                                                            \
+    static const steam::test::Registrar name##Registrar(#name, name);              \
+    static void name()
+
+#define CHECK(condition)                                                           \
+    do {                                                                           \
+        if (!(condition))                                                          \
+            steam::test::fail(__FILE__, __LINE__, #condition);                     \
+    } while (false)
+
+#define REQUIRE(condition)                                                         \
+    do {                                                                           \
+        if (!(condition)) {                                                        \
+            steam::test::fail(__FILE__, __LINE__, #condition);                     \
+            return;                                                                \
+        }                                                                          \
+    } while (false)
@@ -0,0 +1,98 @@
+#include <test.hpp>
+
+#include <steam/api/artwork.hpp>
+
+#include <cstdlib>
+#include <string>
+
+#include <sys/stat.h>
+
+using namespace steam;
+using namespace steam::api;
+
+namespace {
+
+    const std::string PngImage  = std::string("\x89PNG\r\n\x1A\n", 8) + "image";
+    const std::string JpegImage = std::string("\xFF\xD8\xFF", 3) + "image";
+
+    std::string getUrl(const std::fs::path &path) {
+        return "file://" + path.string();
+    }
+
+    ino_t getInode(const std::fs::path &path) {
+        struct stat status = { };
+        if (::stat(path.c_str(), &status) != 0)
+            return 0;
+
+        return status.st_ino;
+    }
+
+}
+
+TEST_CASE(artworkManagerDeduplicatesImages) {
+    test::TemporaryDirectory directory;
+    REQUIRE(test::writeFile(directory / "first.png", PngImage));
+    REQUIRE(test::writeFile(directory / "second.png", PngImage));
+    REQUIRE(test::writeFile(directory / "page.html", "<html></html>"));
+
+    const std::vector<ArtworkRequest> requests = {
+        { AppId(440), ArtworkType::Grid, getUrl(directory / "first.png") },
+        { AppId(620), ArtworkType::Hero, getUrl(directory / "second.png") },
+        { AppId(730), ArtworkType::Logo, getUrl(directory / "page.html") },
+        { AppId(730), ArtworkType::Icon, getUrl(directory / "missing.png") },
+    };
+
+    ArtworkManager manager(directory / "cache");
+    const auto files = manager.fetch(requests);
+    REQUIRE(files.size() == 4);
+
+    // Identical images end up as the same file in the cache, anything that isn't an image is rejected
+    REQUIRE(files[0].has_value() && files[1].has_value());
+    CHECK(*files[0] == *files[1]);
+    CHECK(files[0]->parent_path() == directory / "cache");
+    CHECK(files[0]->extension() == ".png");
+    CHECK(test::readFile(*files[0]) == PngImage);
+    CHECK(!files[2].has_value());
+    CHECK(!files[3].has_value());
+}
+
+TEST_CASE(artworkManagerLinksArtworkIntoGridFolders) {
+    test::TemporaryDirectory directory;
+    REQUIRE(std::fs::create_directories(directory / ".steam" / "steam"));
+    REQUIRE(test::writeFile(directory / "grid.png", PngImage));
+    REQUIRE(test::writeFile(directory / "grid.jpg", JpegImage));
+
+    const std::string previousHome = std::getenv("HOME") != nullptr ? std::getenv("HOME") : "";
+    ::setenv("HOME", directory.getPath().c_str(), 1);
+
+    const std::vector<User> users = { User(1, "first"), User(2, "second") };
+    const auto shortcut = AppId("/games/Game", "Game");
+
+    ArtworkManager manager(directory / "cache");
+    const std::vector<ArtworkRequest> pngRequests = { { shortcut, ArtworkType::Grid, getUrl(directory / "grid.png") } };
+    CHECK(manager.apply(pngRequests, users));
+
+    const auto firstPath  = ArtworkManager::getGridPath(users[0], shortcut, ArtworkType::Grid, ".png");
+    const auto secondPath = ArtworkManager::getGridPath(users[1], shortcut, ArtworkType::Grid, ".png");
+    CHECK(firstPath.filename() == std::to_string(shortcut.getShortAppId()) + "p.png");
+    CHECK(test::readFile(firstPath) == PngImage);
+
+    // Both users share the cached file
+    const auto inode = getInode(firstPath);
+    CHECK(inode != 0 && getInode(secondPath) == inode);
+
+    // Applying the same artwork again leaves the files alone
+    CHECK(manager.apply(pngRequests, users));
+    CHECK(getInode(firstPath) == inode);
+
+    // Switching to a JPEG replaces the PNG instead of leaving both around
+    const std::vector<ArtworkRequest> jpegRequests = { { shortcut, ArtworkType::Grid, getUrl(directory / "grid.jpg") } };
+    CHECK(manager.apply(jpegRequests, users));
+    CHECK(!std::fs::exists(firstPath));
+    CHECK(test::readFile(ArtworkManager::getGridPath(users[0], shortcut, ArtworkType::Grid, ".jpg")) == JpegImage);
+
+    const std::vector<ArtworkRequest> brokenRequests = { { shortcut, ArtworkType::Hero, getUrl(directory / "missing.png") } };
+    CHECK(!manager.apply(brokenRequests, users));
+
+    ::setenv("HOME", previousHome.c_str(), 1);
+}
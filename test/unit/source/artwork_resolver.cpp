@@ -0,0 +1,99 @@
+#include <test.hpp>
+
+#include <steam/api/artwork_resolver.hpp>
+
+#include <fmt/format.h>
+
+#include <future>
+#include <string>
+#include <unordered_map>
+
+using namespace steam;
+
+TEST_CASE(artworkResolverPicksUpNewArtwork) {
+    test::TemporaryDirectory directory;
+    const auto libraryCache = directory / "appcache" / "librarycache";
+    REQUIRE(std::fs::create_directories(libraryCache));
+
+    api::ArtworkResolver resolver(directory.getPath());
+    REQUIRE(resolver.refresh());
+    CHECK(!resolver.find(api::AppId(440), api::ArtworkType::Hero).has_value());
+
+    REQUIRE(test::writeFile(libraryCache / "440_library_hero.jpg", ""));
+    CHECK(resolver.find(api::AppId(440), api::ArtworkType::Hero) == libraryCache / "440_library_hero.jpg");
+}
+
+TEST_CASE(artworkResolverRescansAfterQueueOverflow) {
+    test::TemporaryDirectory directory;
+    const auto libraryCache = directory / "appcache" / "librarycache";
+    REQUIRE(std::fs::create_directories(libraryCache / "440"));
+
+    api::ArtworkResolver resolver(directory.getPath());
+    REQUIRE(resolver.refresh());
+
+    // Flood the kernel's event queue from another directory so the events of the artwork itself get dropped
+    for (u32 i = 0; i < 10'000; i++)
+        REQUIRE(test::writeFile(libraryCache / ("unrelated_" + std::to_string(i)), ""));
+
+    REQUIRE(test::writeFile(libraryCache / "440" / "library_hero.jpg", ""));
+    CHECK(resolver.find(api::AppId(440), api::ArtworkType::Hero) == libraryCache / "440" / "library_hero.jpg");
+}
+
+namespace {
+
+    // Answers every query with a single image whose URL names the endpoint that got queried
+    class StubSteamGridDB : public api::SteamGridDBAPI {
+    public:
+        StubSteamGridDB() : SteamGridDBAPI("") { }
+
+        std::future<std::vector<ImageResult>> getGrids(const api::AppId &appId, IdType idType) override   { return this->query("grids", appId, idType); }
+        std::future<std::vector<ImageResult>> getHeroes(const api::AppId &appId, IdType idType) override  { return this->query("heroes", appId, idType); }
+        std::future<std::vector<ImageResult>> getLogos(const api::AppId &appId, IdType idType) override   { return this->query("logos", appId, idType); }
+        std::future<std::vector<ImageResult>> getIcons(const api::AppId &appId, IdType idType) override   { return this->query("icons", appId, idType); }
+
+        std::vector<std::string> queries;
+
+    private:
+        std::future<std::vector<ImageResult>> query(std::string_view kind, const api::AppId &appId, IdType idType) {
+            auto url = fmt::format("{}/{}/{}", kind, idType == IdType::Steam ? "steam" : "game", appId.getAppId());
+            this->queries.push_back(url);
+
+            std::promise<std::vector<ImageResult>> result;
+            result.set_value({ ImageResult { .id = appId, .score = 1, .url = url } });
+
+            return result.get_future();
+        }
+    };
+
+}
+
+TEST_CASE(artworkResolverQueriesSteamGridDBIds) {
+    test::TemporaryDirectory directory;
+    const auto libraryCache = directory / "appcache" / "librarycache";
+    REQUIRE(std::fs::create_directories(libraryCache));
+    REQUIRE(test::writeFile(libraryCache / "440_library_hero.jpg", ""));
+
+    api::ArtworkResolver resolver(directory.getPath());
+    REQUIRE(resolver.refresh());
+
+    const auto mapped   = api::AppId("/games/Mapped", "Mapped");
+    const auto unmapped = api::AppId("/games/Unmapped", "Unmapped");
+
+    const std::vector<api::AppId> appIds = { api::AppId(440), mapped, unmapped };
+    const std::vector<api::ArtworkType> types = { api::ArtworkType::Grid, api::ArtworkType::Hero };
+    const std::unordered_map<u64, api::AppId> gameIds = { { mapped.getAppId(), api::AppId(1234) } };
+
+    StubSteamGridDB steamGridDB;
+    const auto requests = resolver.resolve(appIds, types, steamGridDB, gameIds);
+
+    // Steam games are looked up by their appid, shortcuts only through their SteamGridDB id. Local artwork doesn't need a lookup at all
+    const std::vector<std::string> expectedQueries = { "grids/steam/440", "grids/game/1234", "heroes/game/1234" };
+    CHECK(steamGridDB.queries == expectedQueries);
+
+    REQUIRE(requests.size() == 4);
+    CHECK(requests[0].appId.getAppId() == 440 && requests[0].type == api::ArtworkType::Hero);
+    CHECK(requests[0].url == "file://" + (libraryCache / "440_library_hero.jpg").string());
+    CHECK(requests[1].appId.getAppId() == 440 && requests[1].url == "grids/steam/440");
+    CHECK(requests[2].appId.getAppId() == mapped.getAppId() && requests[2].url == "grids/game/1234");
+    CHECK(requests[3].appId.getAppId() == mapped.getAppId() && requests[3].url == "heroes/game/1234");
+}
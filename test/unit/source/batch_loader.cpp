@@ -0,0 +1,50 @@
+#include <test.hpp>
+
+#include <steam/helpers/batch_loader.hpp>
+
+#include <string>
+#include <vector>
+
+using namespace steam;
+
+namespace {
+
+    void checkLoadFiles(fs::LoadBackend backend) {
+        test::TemporaryDirectory directory;
+
+        std::vector<std::fs::path> paths;
+        for (u32 i = 0; i < 300; i++) {
+            paths.push_back(directory / fmt::format("file_{}.txt", i));
+            REQUIRE(test::writeFile(paths.back(), std::string(i * 37, char('a' + i % 26))));
+        }
+
+        paths.push_back(directory / "missing.txt");
+        paths.push_back(directory.getPath());
+        paths.push_back("/proc/self/status");
+
+        const auto files = fs::loadFiles(paths, backend);
+        REQUIRE(files.size() == paths.size());
+
+        for (u32 i = 0; i < 300; i++) {
+            CHECK(files[i].path == paths[i]);
+            CHECK(files[i].isValid());
+            CHECK(files[i].getString() == std::string(i * 37, char('a' + i % 26)));
+        }
+
+        CHECK(!files[300].isValid());
+        CHECK(!files[301].isValid());
+
+        // Files in /proc report a size of zero but still have content
+        CHECK(files[302].isValid());
+        CHECK(files[302].getString().starts_with("Name:"));
+    }
+
+}
+
+TEST_CASE(loadFilesAutomatic) {
+    checkLoadFiles(fs::LoadBackend::Automatic);
+}
+
+TEST_CASE(loadFilesThreadPool) {
+    checkLoadFiles(fs::LoadBackend::ThreadPool);
+}
@@ -0,0 +1,96 @@
+#include <test.hpp>
+
+#include <steam/api/storage.hpp>
+#include <steam/api/shortcuts_store.hpp>
+#include <steam/file_formats/vdf.hpp>
+#include <steam/helpers/disk_usage.hpp>
+
+#include <algorithm>
+#include <cstdlib>
+#include <string>
+
+using namespace steam;
+
+namespace {
+
+    bool createFile(const std::fs::path &path, std::string_view content) {
+        std::fs::create_directories(path.parent_path());
+        return test::writeFile(path, content);
+    }
+
+    bool createFile(const std::fs::path &path, size_t size) {
+        return createFile(path, std::string(size, 'x'));
+    }
+
+}
+
+TEST_CASE(diskUsageMeasuresDirectoryTrees) {
+    test::TemporaryDirectory directory;
+
+    // Deep enough for the work to get spread across workers
+    for (u32 i = 0; i < 16; i++) {
+        auto path = directory / "first";
+        for (u32 depth = 0; depth <= i % 4; depth++)
+            path /= "directory" + std::to_string(i);
+
+        REQUIRE(createFile(path / "file", 100));
+    }
+
+    REQUIRE(createFile(directory / "second" / "file", 1000));
+    std::fs::create_symlink(directory / "second" / "file", directory / "second" / "link");
+
+    const std::vector<std::fs::path> roots = { directory / "first", directory / "second", directory / "missing" };
+    const auto usages = fs::measureDirectories(roots);
+    REQUIRE(usages.size() == 3);
+
+    // The roots themselves are counted as well
+    CHECK(usages[0].fileCount == 16);
+    CHECK(usages[0].directoryCount == 1 + 4 * (1 + 2 + 3 + 4));
+    CHECK(usages[0].size >= 1600);
+
+    // Symlinks are counted but not followed
+    CHECK(usages[1].fileCount == 2);
+    CHECK(usages[1].directoryCount == 1);
+    CHECK(usages[1].size >= 1000 + (directory / "second" / "file").native().size());
+
+    CHECK(usages[2].fileCount == 0 && usages[2].directoryCount == 0);
+}
+
+TEST_CASE(storageScanFindsOrphanedPrefixes) {
+    test::TemporaryDirectory directory;
+    const auto steam = directory / ".steam" / "steam";
+    const auto steamApps = steam / "steamapps";
+
+    REQUIRE(createFile(steamApps / "appmanifest_440.acf", "\"AppState\"\n{\n\t\"appid\"\t\t\"440\"\n\t\"name\"\t\t\"Game\"\n\t\"installdir\"\t\t\"game\"\n}\n"));
+    REQUIRE(createFile(steamApps / "common" / "game" / "game.bin", 1000));
+    REQUIRE(createFile(steamApps / "compatdata" / "440" / "pfx" / "file", 200));
+    REQUIRE(createFile(steamApps / "shadercache" / "440" / "cache", 300));
+
+    // One prefix belongs to a shortcut that still exists, the other one to a shortcut that got removed
+    const auto shortcut = api::AppId("/games/Game", "Game");
+    const auto removed  = api::AppId("/games/Removed", "Removed");
+    REQUIRE(createFile(steamApps / "compatdata" / std::to_string(shortcut.getShortAppId()) / "file", 10));
+    REQUIRE(createFile(steamApps / "compatdata" / std::to_string(removed.getShortAppId()) / "file", 10));
+
+    VDF shortcuts;
+    shortcuts["shortcuts"]["0"] = api::ShortcutsStore::createShortcut(shortcut, "Game", "/games/Game", "", { }, false);
+    const auto data = shortcuts.dump();
+    REQUIRE(createFile(steam / "userdata" / "1234" / "config" / "shortcuts.vdf", std::string_view(reinterpret_cast<const char*>(data.data()), data.size())));
+
+    const std::string previousHome = std::getenv("HOME") != nullptr ? std::getenv("HOME") : "";
+    ::setenv("HOME", directory.getPath().c_str(), 1);
+
+    const auto report = api::scanStorage();
+
+    ::setenv("HOME", previousHome.c_str(), 1);
+
+    REQUIRE(report.apps.contains(440));
+    const auto &game = report.apps.at(440);
+    CHECK(game.install.fileCount == 1 && game.install.size >= 1000);
+    CHECK(game.compatData.fileCount == 1 && game.compatData.directoryCount == 2);
+    CHECK(game.shaderCache.fileCount == 1);
+
+    CHECK(report.apps.contains(shortcut.getShortAppId()));
+    REQUIRE(report.orphanedPrefixes.size() == 1);
+    CHECK(report.orphanedPrefixes[0].filename() == std::to_string(removed.getShortAppId()));
+}
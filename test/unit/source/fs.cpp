@@ -0,0 +1,52 @@
+#include <test.hpp>
+
+#include <steam/helpers/fs.hpp>
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace steam;
+
+TEST_CASE(writeFileAtomicReplacesContent) {
+    test::TemporaryDirectory directory;
+    const auto path = directory / "config.vdf";
+
+    REQUIRE(fs::writeFileAtomic(path, std::string_view("first")));
+    CHECK(test::readFile(path) == "first");
+
+    REQUIRE(::chmod(path.c_str(), 0640) == 0);
+    REQUIRE(fs::writeFileAtomic(path, std::string_view("second")));
+    CHECK(test::readFile(path) == "second");
+
+    struct stat64 status = { };
+    REQUIRE(::stat64(path.c_str(), &status) == 0);
+    CHECK((status.st_mode & 07777) == 0640);
+
+    // No temporary files are left behind
+    CHECK(std::distance(std::fs::directory_iterator(directory.getPath()), std::fs::directory_iterator()) == 1);
+}
+
+TEST_CASE(writeFileAtomicKeepsOwner) {
+    // Only root can hand files to other users
+    if (::geteuid() != 0)
+        return;
+
+    test::TemporaryDirectory directory;
+    const auto path = directory / "shortcuts.vdf";
+    const auto backupPath = directory / "shortcuts.vdf.orig";
+
+    REQUIRE(test::writeFile(path, "first"));
+    REQUIRE(::chown(path.c_str(), 1234, 2345) == 0);
+
+    REQUIRE(fs::writeFileAtomic(path, std::string_view("second")));
+    REQUIRE(fs::backupFile(path, backupPath));
+
+    for (const auto &file : { path, backupPath }) {
+        struct stat64 status = { };
+        REQUIRE(::stat64(file.c_str(), &status) == 0);
+        CHECK(status.st_uid == 1234);
+        CHECK(status.st_gid == 2345);
+    }
+
+    CHECK(test::readFile(backupPath) == "second");
+}
@@ -0,0 +1,88 @@
+#include <test.hpp>
+
+#include <steam/api/appid.hpp>
+#include <steam/helpers/hash.hpp>
+
+#include <array>
+#include <list>
+#include <string>
+#include <vector>
+
+using namespace steam;
+
+namespace {
+
+    // The original table driven implementation, everything has to keep producing exactly the same checksums
+    template<u32 Polynomial = 0x04C11DB7>
+    u32 referenceCrc32(const auto &data, u32 initialValue = 0x00) {
+        std::array<u32, 256> table = { };
+        for (u32 i = 0; i < 256; i++) {
+            u32 c = i;
+            for (size_t j = 0; j < 8; j++)
+                c = (c & 1) ? Polynomial ^ (c >> 1) : c >> 1;
+
+            table[i] = c;
+        }
+
+        u32 crc = initialValue;
+        for (u8 byte : data)
+            crc = table[(crc ^ byte) & 0xFF] ^ (crc >> 8);
+
+        return ~crc;
+    }
+
+    std::vector<u8> createData(size_t size) {
+        std::vector<u8> data(size);
+        for (size_t i = 0; i < size; i++)
+            data[i] = u8(i * 31 + 7);
+
+        return data;
+    }
+
+}
+
+TEST_CASE(crc32MatchesKnownValues) {
+    CHECK(crc32(std::string_view("")) == 0xFFFF'FFFF);
+    CHECK(crc32(std::string_view("a")) == 0xFC2D'93B2);
+    CHECK(crc32(std::string_view("123456789")) == 0xFCD7'4687);
+    CHECK(crc32(std::string(1000, 'x')) == 0xFF8F'B084);
+    CHECK(crc32(createData(4099)) == 0xFF21'7DC0);
+    CHECK(crc32(std::string_view("123456789"), 0x1234'5678) == 0xFDDA'B811);
+    CHECK(crc32<0xEDB8'8320>(std::string_view("123456789")) == 0xD202'D277);
+}
+
+TEST_CASE(crc32MatchesReferenceForAllSizes) {
+    // Covers every tail length around the sizes where the vectorized paths kick in, as well as unaligned starts
+    const auto data = createData(1100);
+    for (size_t offset = 0; offset < 16; offset++) {
+        for (size_t size = 0; size + offset <= data.size(); size += (size < 300 ? 1 : 37)) {
+            const std::span<const u8> part(data.data() + offset, size);
+            if (crc32(part) != referenceCrc32(part) || crc32<0xEDB8'8320>(part, 0xFFFF'FFFF) != referenceCrc32<0xEDB8'8320>(part, 0xFFFF'FFFF)) {
+                CHECK(!"checksum differs from the reference");
+                return;
+            }
+        }
+    }
+}
+
+TEST_CASE(crc32UpdatesIncrementally) {
+    const auto data = createData(777);
+    const std::span<const u8> bytes(data);
+
+    for (size_t split : { 0, 1, 15, 64, 300, 777 }) {
+        Crc32 crc;
+        crc.update(bytes.first(split)).update(bytes.subspan(split));
+        CHECK(crc.finalize() == referenceCrc32(data));
+    }
+
+    // Non-contiguous ranges take the byte by byte path
+    const std::list<u8> list(data.begin(), data.end());
+    CHECK(crc32(list) == referenceCrc32(data));
+}
+
+TEST_CASE(appIdMatchesKnownValues) {
+    const api::AppId appId("\"/usr/bin/game\"", "My Game");
+    CHECK(appId.getAppId() == 0xFF36'1D01'0200'0000);
+    CHECK(appId.getShortAppId() == 0xFF36'1D01);
+    CHECK(appId.getAppId() == ((u64(referenceCrc32(std::string("\"/usr/bin/game\"My Game")) | 0x8000'0000) << 32) | 0x0200'0000));
+}
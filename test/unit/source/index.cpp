@@ -0,0 +1,167 @@
+#include <test.hpp>
+
+#include <steam/file_formats/keyvalues.hpp>
+#include <steam/file_formats/vdf.hpp>
+
+#include <string>
+
+using namespace steam;
+
+namespace {
+
+    VDF createShortcuts(u32 count) {
+        VDF vdf;
+        for (u32 i = 0; i < count; i++) {
+            auto &shortcut = vdf["shortcuts"][std::to_string(i)];
+            shortcut["appid"]   = 100 + i;
+            shortcut["AppName"] = std::string_view(fmt::format("Game {}", i));
+        }
+
+        return vdf;
+    }
+
+    // Same shift ShortcutsStore and Transaction do to keep the shortcut keys contiguous
+    void eraseAndShift(VDF::Value &list, u32 index) {
+        list.erase(std::to_string(index));
+
+        for (u32 i = index; list.set().contains(std::to_string(i + 1)); i++) {
+            list[std::to_string(i)] = std::move(list[std::to_string(i + 1)]);
+            list.erase(std::to_string(i + 1));
+        }
+    }
+
+}
+
+TEST_CASE(indexFindsElements) {
+    auto vdf = createShortcuts(3);
+    auto index = vdf.addIndex("shortcuts/*/appid");
+    REQUIRE(index != nullptr);
+
+    CHECK(index->size() == 3);
+    REQUIRE(index->find(u32(101)) != nullptr);
+    CHECK(index->find(u32(101))->key == "1");
+    CHECK(index->find(u32(999)) == nullptr);
+}
+
+TEST_CASE(indexFollowsAssignments) {
+    auto vdf = createShortcuts(2);
+    auto index = vdf.addIndex("shortcuts/*/appid");
+
+    vdf["shortcuts"]["0"]["appid"] = 500;
+    CHECK(index->find(u32(100)) == nullptr);
+    REQUIRE(index->find(u32(500)) != nullptr);
+    CHECK(index->find(u32(500))->key == "0");
+
+    vdf["shortcuts"]["2"]["appid"] = 102;
+    CHECK(index->size() == 3);
+    CHECK(index->find(u32(102)) != nullptr);
+
+    vdf["shortcuts"]["1"] = VDF::Set { };
+    CHECK(index->find(u32(101)) == nullptr);
+    CHECK(index->size() == 2);
+}
+
+TEST_CASE(indexFollowsErase) {
+    auto vdf = createShortcuts(3);
+    auto index = vdf.addIndex("shortcuts/*/appid");
+
+    vdf["shortcuts"].erase("1");
+    CHECK(index->find(u32(101)) == nullptr);
+    CHECK(index->size() == 2);
+
+    vdf["shortcuts"]["2"].erase("appid");
+    CHECK(index->find(u32(102)) == nullptr);
+
+    vdf.erase("shortcuts");
+    CHECK(index->size() == 0);
+}
+
+TEST_CASE(indexFollowsEraseThenShift) {
+    auto vdf = createShortcuts(4);
+    auto index = vdf.addIndex("shortcuts/*/appid");
+
+    eraseAndShift(vdf["shortcuts"], 0);
+
+    CHECK(index->size() == 3);
+    CHECK(index->find(u32(100)) == nullptr);
+    for (u32 i = 0; i < 3; i++) {
+        auto entry = index->find(u32(101 + i));
+        REQUIRE(entry != nullptr);
+        CHECK(entry->key == std::to_string(i));
+        CHECK(entry->element == &vdf["shortcuts"][std::to_string(i)]);
+    }
+
+    // The moved leaves have to be bound to their new elements, not the ones they got moved out of
+    vdf["shortcuts"]["0"]["appid"] = 999;
+    CHECK(index->find(u32(101)) == nullptr);
+    REQUIRE(index->find(u32(999)) != nullptr);
+    CHECK(index->find(u32(999))->key == "0");
+
+    vdf.reindex();
+    vdf["shortcuts"]["0"]["appid"] = 777;
+    CHECK(index->find(u32(999)) == nullptr);
+    REQUIRE(index->find(u32(777)) != nullptr);
+    CHECK(index->find(u32(777))->key == "0");
+    CHECK(index->size() == 3);
+}
+
+TEST_CASE(indexIgnoresMovedOutSubtrees) {
+    auto vdf = createShortcuts(2);
+    auto index = vdf.addIndex("shortcuts/*/appid");
+
+    VDF::Value removed = std::move(vdf["shortcuts"]["1"]);
+    vdf["shortcuts"].erase("1");
+
+    removed["appid"] = 300;
+    CHECK(index->find(u32(300)) == nullptr);
+    CHECK(index->size() == 1);
+
+    vdf["shortcuts"]["1"] = std::move(removed);
+    REQUIRE(index->find(u32(300)) != nullptr);
+    CHECK(index->find(u32(300))->key == "1");
+
+    vdf["shortcuts"]["1"]["appid"] = 301;
+    CHECK(index->find(u32(300)) == nullptr);
+    CHECK(index->find(u32(301)) != nullptr);
+}
+
+TEST_CASE(indexSurvivesDocumentMove) {
+    auto vdf = createShortcuts(2);
+    vdf.addIndex("shortcuts/*/appid");
+
+    auto moved = std::move(vdf);
+    moved["shortcuts"]["1"]["appid"] = 201;
+
+    auto index = moved.getIndex("shortcuts/*/appid");
+    REQUIRE(index != nullptr);
+    CHECK(index->find(u32(201)) != nullptr);
+
+    auto copy = moved;
+    copy["shortcuts"]["0"]["appid"] = 200;
+    CHECK(copy.getIndex("shortcuts/*/appid")->find(u32(200)) != nullptr);
+    CHECK(index->find(u32(200)) == nullptr);
+}
+
+TEST_CASE(keyValuesIndexFollowsEraseThenShift) {
+    KeyValues document;
+    for (u32 i = 0; i < 3; i++)
+        document["libraryfolders"][std::to_string(i)]["path"] = std::string_view(fmt::format("/library/{}", i));
+
+    auto index = document.addIndex("libraryfolders/*/path");
+    REQUIRE(index != nullptr);
+
+    auto &folders = document["libraryfolders"];
+    folders.erase("0");
+    folders["0"] = std::move(folders["1"]);
+    folders.erase("1");
+    folders["1"] = std::move(folders["2"]);
+    folders.erase("2");
+
+    folders["0"]["path"] = "/moved";
+    CHECK(index->find("/library/1") == nullptr);
+    REQUIRE(index->find("/moved") != nullptr);
+    CHECK(index->find("/moved")->key == "0");
+    REQUIRE(index->find("/library/2") != nullptr);
+    CHECK(index->find("/library/2")->key == "1");
+    CHECK(index->size() == 2);
+}
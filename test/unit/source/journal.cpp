@@ -0,0 +1,197 @@
+#include <test.hpp>
+
+#include <steam/file_formats/journal.hpp>
+#include <steam/file_formats/keyvalues.hpp>
+#include <steam/helpers/file.hpp>
+#include <steam/helpers/hash.hpp>
+
+#include <functional>
+#include <string>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+
+using namespace steam;
+
+namespace {
+
+    // Writes a new version of the file and records it the way ShortcutsStore and Transaction do
+    bool edit(const std::fs::path &path, KeyValues &document, const std::function<void(KeyValues &document)> &callback) {
+        const auto previous = document;
+        const auto previousChecksum = crc32(previous.dump());
+
+        callback(document);
+
+        const auto data = document.dump();
+        if (!Journal<KeyValues>(path).record(previous, previousChecksum, document, crc32(data)))
+            return false;
+
+        return fs::writeFileAtomic(path, std::string_view(data));
+    }
+
+    KeyValues createConfig(const std::fs::path &path) {
+        KeyValues document;
+        document["config"]["version"] = "0";
+
+        const auto data = document.dump();
+        test::writeFile(path, data);
+
+        return document;
+    }
+
+}
+
+TEST_CASE(journalRecordsAndReconstructs) {
+    test::TemporaryDirectory directory;
+    const auto path = directory / "config.vdf";
+    auto document = createConfig(path);
+    const auto original = test::readFile(path);
+
+    for (u32 i = 1; i <= 5; i++)
+        REQUIRE(edit(path, document, [i](KeyValues &document) { document["config"]["version"] = std::string_view(std::to_string(i)); }));
+
+    Journal<KeyValues> journal(path);
+    CHECK(journal.getEntryCount() == 5);
+    CHECK(test::readFile(journal.getBaselinePath()) == original);
+
+    for (u32 i = 0; i <= 5; i++) {
+        auto version = journal.reconstruct(i);
+        REQUIRE(version.has_value());
+        CHECK((*version)["config"]["version"].string() == std::to_string(i));
+    }
+
+    CHECK(!journal.reconstruct(6).has_value());
+}
+
+TEST_CASE(journalUndoAndRestore) {
+    test::TemporaryDirectory directory;
+    const auto path = directory / "config.vdf";
+    auto document = createConfig(path);
+
+    for (u32 i = 1; i <= 4; i++)
+        REQUIRE(edit(path, document, [i](KeyValues &document) { document["config"][std::to_string(i)] = "set"; }));
+
+    Journal<KeyValues> journal(path);
+    CHECK(journal.undo());
+    CHECK(journal.getEntryCount() == 3);
+    CHECK(!KeyValues(path)["config"].contains("4"));
+    CHECK(KeyValues(path)["config"].contains("3"));
+
+    CHECK(journal.restore(1));
+    CHECK(journal.getEntryCount() == 1);
+    CHECK(KeyValues(path)["config"].set().size() == 2);
+
+    // Editing after a restore continues from the restored version
+    document = KeyValues(path);
+    REQUIRE(edit(path, document, [](KeyValues &document) { document["config"]["after"] = "restore"; }));
+    CHECK(journal.getEntryCount() == 2);
+
+    auto latest = journal.reconstruct(2);
+    REQUIRE(latest.has_value());
+    CHECK(*latest == KeyValues(path));
+
+    CHECK(journal.restore(0));
+    CHECK(journal.getEntryCount() == 0);
+    CHECK(!journal.undo());
+}
+
+TEST_CASE(journalRecordsExternalChanges) {
+    test::TemporaryDirectory directory;
+    const auto path = directory / "config.vdf";
+    auto document = createConfig(path);
+
+    REQUIRE(edit(path, document, [](KeyValues &document) { document["config"]["ours"] = "1"; }));
+
+    // Someone else modifies the file in between two of our edits
+    document["config"]["theirs"] = "1";
+    REQUIRE(fs::writeFileAtomic(path, std::string_view(document.dump())));
+
+    REQUIRE(edit(path, document, [](KeyValues &document) { document["config"]["ours"] = "2"; }));
+
+    Journal<KeyValues> journal(path);
+    CHECK(journal.getEntryCount() == 3);
+
+    auto external = journal.reconstruct(2);
+    REQUIRE(external.has_value());
+    CHECK((*external)["config"]["theirs"].string() == "1");
+    CHECK((*external)["config"]["ours"].string() == "1");
+    CHECK(*journal.reconstruct(3) == KeyValues(path));
+}
+
+TEST_CASE(journalIgnoresTornTail) {
+    test::TemporaryDirectory directory;
+    const auto path = directory / "config.vdf";
+    auto document = createConfig(path);
+
+    REQUIRE(edit(path, document, [](KeyValues &document) { document["config"]["first"] = "1"; }));
+    REQUIRE(edit(path, document, [](KeyValues &document) { document["config"]["second"] = "1"; }));
+
+    Journal<KeyValues> journal(path);
+
+    // An entry that only got written halfway
+    {
+        auto file = fs::File(journal.getJournalPath(), fs::File::Mode::Write);
+        const std::vector<u8> junk(7, 0xAB);
+        REQUIRE(file.writeAt(std::fs::file_size(journal.getJournalPath()), junk.data(), junk.size()));
+    }
+
+    CHECK(journal.getEntryCount() == 2);
+
+    REQUIRE(edit(path, document, [](KeyValues &document) { document["config"]["third"] = "1"; }));
+    CHECK(journal.getEntryCount() == 3);
+    CHECK(*journal.reconstruct(3) == KeyValues(path));
+}
+
+TEST_CASE(journalCompacts) {
+    test::TemporaryDirectory directory;
+    const auto path = directory / "config.vdf";
+    auto document = createConfig(path);
+
+    for (u32 i = 1; i <= 10; i++)
+        REQUIRE(edit(path, document, [i](KeyValues &document) { document["config"]["version"] = std::string_view(std::to_string(i)); }));
+
+    Journal<KeyValues> journal(path);
+    CHECK(journal.compact(3));
+    CHECK(journal.getEntryCount() == 3);
+
+    auto baseline = journal.reconstruct(0);
+    REQUIRE(baseline.has_value());
+    CHECK((*baseline)["config"]["version"].string() == "7");
+    CHECK(*journal.reconstruct(3) == KeyValues(path));
+
+    // Going over the limit folds the oldest entries in on its own
+    for (u32 i = 0; i < Journal<KeyValues>::MaxEntryCount; i++)
+        REQUIRE(edit(path, document, [i](KeyValues &document) { document["config"]["counter"] = std::string_view(std::to_string(i)); }));
+
+    CHECK(journal.getEntryCount() <= Journal<KeyValues>::MaxEntryCount);
+    CHECK(*journal.reconstruct(journal.getEntryCount()) == KeyValues(path));
+}
+
+TEST_CASE(journalAppendsWithoutRereadingBaseline) {
+    test::TemporaryDirectory directory;
+    const auto path = directory / "config.vdf";
+    auto document = createConfig(path);
+
+    REQUIRE(edit(path, document, [](KeyValues &document) { document["config"]["first"] = "1"; }));
+
+    Journal<KeyValues> journal(path);
+    const auto baselinePath = journal.getBaselinePath();
+
+    // Scribble over the baseline in place without changing its size or modification time. As long as the baseline's
+    // identity didn't change, its checksum is taken from the cache instead of the file, so the journal stays in use
+    struct stat64 status = { };
+    REQUIRE(::stat64(baselinePath.c_str(), &status) == 0);
+
+    auto content = test::readFile(baselinePath);
+    content.back() = content.back() == ' ' ? '\t' : ' ';
+    {
+        auto file = fs::File(baselinePath, fs::File::Mode::Write);
+        REQUIRE(file.writeAt(0, reinterpret_cast<const u8*>(content.data()), content.size()));
+    }
+
+    const timespec times[2] = { status.st_atim, status.st_mtim };
+    REQUIRE(::utimensat(AT_FDCWD, baselinePath.c_str(), times, 0) == 0);
+
+    REQUIRE(edit(path, document, [](KeyValues &document) { document["config"]["second"] = "1"; }));
+    CHECK(journal.getEntryCount() == 2);
+}
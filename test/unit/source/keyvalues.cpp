@@ -0,0 +1,67 @@
+#include <test.hpp>
+
+#include <steam/file_formats/keyvalues.hpp>
+
+#include <string>
+
+using namespace steam;
+
+TEST_CASE(keyValuesParallelDumpMatchesSerialDump) {
+    // Enough entries to go over the size from which documents get dumped in parallel, one of them large enough to be split up itself
+    KeyValues document;
+    auto &list = document["list"];
+    for (u32 i = 0; i < 20'000; i++) {
+        auto &entry = list[std::to_string(i)];
+        entry["id"]   = std::string_view(std::to_string(i));
+        entry["name"] = std::string_view("Entry \"" + std::to_string(i) + "\"\t" + std::string(i % 50, 'x'));
+    }
+
+    for (u32 i = 0; i < 4'000; i++)
+        list["large"][std::to_string(i)] = std::string_view(std::string(32, char('a' + i % 26)));
+
+    const auto data = document.dump();
+    REQUIRE(data.size() > 1024 * 1024);
+
+    // Every entry on its own is small enough to take the serial path. Their dumps only differ by the framing around them
+    KeyValues empty;
+    empty["list"] = KeyValues::Set { };
+    const auto framing = empty.dump();
+    const auto prefix = std::string_view(framing).substr(0, framing.size() - 2);
+
+    std::string expected(prefix);
+    for (const auto &[key, value] : list.set()) {
+        KeyValues single;
+        single["list"][std::string(key.view())] = value;
+
+        const auto singleData = single.dump();
+        REQUIRE(singleData.size() < 1024 * 1024);
+        expected += std::string_view(singleData).substr(prefix.size(), singleData.size() - prefix.size() - 2);
+    }
+    expected += std::string_view(framing).substr(framing.size() - 2);
+
+    CHECK(data == expected);
+    CHECK(KeyValues(data) == document);
+}
+
+TEST_CASE(keyValuesParsesUtf8AndEscapes) {
+    auto document = KeyValues(std::string_view("\"root\"\n{\n\t\"name\"\t\t\"Caf\xC3\xA9 \xF0\x9F\x8E\xAE \\\"quoted\\\"\\t\\\\\"\n\t\"set\"\n\t{\n\t}\n}\n"));
+
+    CHECK(document["root"]["name"].string() == "Caf\xC3\xA9 \xF0\x9F\x8E\xAE \"quoted\"\t\\");
+    CHECK(document["root"]["set"].isSet());
+    CHECK(KeyValues(document.dump()) == document);
+}
+
+TEST_CASE(keyValuesParsesViewsIntoLargerBuffers) {
+    // The view isn't null terminated, parsing must stop at its end
+    const std::string buffer = "\"root\"\n{\n\t\"key\"\t\t\"value\"\n}\n\"trailing\"\t\t\"ignored\"\n";
+    auto document = KeyValues(std::string_view(buffer).substr(0, buffer.find("\"trailing\"")));
+
+    CHECK(document["root"]["key"].string() == "value");
+    CHECK(!document.contains("trailing"));
+}
+
+TEST_CASE(keyValuesKeepsInvalidUtf8Bytes) {
+    auto document = KeyValues(std::string_view("\"key\"\t\t\"\xFF\xFE\"\n"));
+
+    CHECK(document["key"].string() == "\xFF\xFE");
+}
@@ -0,0 +1,58 @@
+#include <test.hpp>
+
+#include <steam/api/library_index.hpp>
+
+#include <string>
+
+using namespace steam;
+
+namespace {
+
+    std::string createManifest(u32 appId, std::string_view name) {
+        return "\"AppState\"\n{\n\t\"appid\"\t\t\"" + std::to_string(appId) + "\"\n\t\"name\"\t\t\"" + std::string(name) + "\"\n\t\"installdir\"\t\t\"game\"\n}\n";
+    }
+
+}
+
+TEST_CASE(libraryIndexPicksUpChangedManifests) {
+    test::TemporaryDirectory directory;
+    const auto manifest = directory / "steamapps" / "appmanifest_440.acf";
+    REQUIRE(std::fs::create_directories(directory / "steamapps"));
+    REQUIRE(test::writeFile(manifest, createManifest(440, "First")));
+
+    api::LibraryIndex libraryIndex(directory.getPath());
+    REQUIRE(libraryIndex.refresh());
+    REQUIRE(libraryIndex.find(440) != nullptr);
+    CHECK(libraryIndex.find(440)->name == "First");
+
+    REQUIRE(test::writeFile(manifest, createManifest(440, "Second") + "\n"));
+    REQUIRE(libraryIndex.refresh());
+    REQUIRE(libraryIndex.find(440) != nullptr);
+    CHECK(libraryIndex.find(440)->name == "Second");
+
+    std::fs::remove(manifest);
+    REQUIRE(libraryIndex.refresh());
+    CHECK(libraryIndex.find(440) == nullptr);
+}
+
+TEST_CASE(libraryIndexKeepsGamesOfBrokenManifests) {
+    test::TemporaryDirectory directory;
+    const auto manifest = directory / "steamapps" / "appmanifest_440.acf";
+    REQUIRE(std::fs::create_directories(directory / "steamapps"));
+    REQUIRE(test::writeFile(manifest, createManifest(440, "First")));
+
+    api::LibraryIndex libraryIndex(directory.getPath());
+    REQUIRE(libraryIndex.refresh());
+
+    // Steam being in the middle of writing the manifest
+    REQUIRE(test::writeFile(manifest, "\"AppState\"\n{\n\t\"appid\""));
+    REQUIRE(libraryIndex.refresh());
+    REQUIRE(libraryIndex.find(440) != nullptr);
+    CHECK(libraryIndex.find(440)->name == "First");
+
+    // Once it's complete again the new version replaces the previous one
+    REQUIRE(test::writeFile(manifest, createManifest(440, "Second")));
+    REQUIRE(libraryIndex.refresh());
+    REQUIRE(libraryIndex.find(440) != nullptr);
+    CHECK(libraryIndex.find(440)->name == "Second");
+}
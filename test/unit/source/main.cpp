@@ -0,0 +1,79 @@
+#include <test.hpp>
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+
+namespace steam::test {
+
+    namespace {
+
+        u32 s_failures = 0;
+
+    }
+
+    std::vector<TestCase>& getTestCases() {
+        static std::vector<TestCase> testCases;
+
+        return testCases;
+    }
+
+    void fail(std::string_view file, u32 line, std::string_view condition) {
+        fmt::print(stderr, "{}:{}: check failed: {}\n", file, line, condition);
+        s_failures++;
+    }
+
+    TemporaryDirectory::TemporaryDirectory() {
+        auto path = (std::fs::temp_directory_path() / "libsteam-test-XXXXXX").string();
+        if (::mkdtemp(path.data()) != nullptr)
+            this->m_path = path;
+    }
+
+    TemporaryDirectory::~TemporaryDirectory() {
+        std::error_code error;
+        if (!this->m_path.empty())
+            std::fs::remove_all(this->m_path, error);
+    }
+
+    bool writeFile(const std::fs::path &path, std::string_view content) {
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        file.write(content.data(), std::streamsize(content.size()));
+
+        return file.good();
+    }
+
+    std::string readFile(const std::fs::path &path) {
+        std::ifstream file(path, std::ios::binary);
+
+        return { std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>() };
+    }
+
+}
+
+// Runs all tests, or only the ones whose name contains the first argument
+int main(int argc, char **argv) {
+    const std::string_view filter = argc > 1 ? argv[1] : "";
+
+    steam::u32 failedTests = 0;
+    for (const auto &[name, function] : steam::test::getTestCases()) {
+        if (name.find(filter) == std::string_view::npos)
+            continue;
+
+        const auto previousFailures = steam::test::s_failures;
+        function();
+
+        const bool passed = steam::test::s_failures == previousFailures;
+        fmt::print("[{}] {}\n", passed ? " OK " : "FAIL", name);
+
+        if (!passed)
+            failedTests++;
+    }
+
+    if (failedTests > 0) {
+        fmt::print("{} test{} failed\n", failedTests, failedTests == 1 ? "" : "s");
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
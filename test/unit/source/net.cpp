@@ -0,0 +1,23 @@
+#include <test.hpp>
+
+#include <steam/helpers/net.hpp>
+
+#include <string>
+
+using namespace steam;
+
+TEST_CASE(netReleasesFailedTransfers) {
+    test::TemporaryDirectory directory;
+    REQUIRE(test::writeFile(directory / "source", "content"));
+
+    Net::init();
+
+    // The destination can't be created. A transfer failing like that must not keep the next one from starting
+    Net net;
+    const auto url = "file://" + (directory / "source").string();
+    CHECK(net.downloadFile(url, directory / "missing" / "destination").get().code == 400);
+    CHECK(net.downloadFile(url, directory / "missing" / "destination").get().code == 400);
+
+    CHECK(net.downloadFile(url, directory / "destination").get().code == 0);
+    CHECK(test::readFile(directory / "destination") == "content");
+}
@@ -0,0 +1,56 @@
+#include <test.hpp>
+
+#include <steam/api/library_index.hpp>
+#include <steam/api/search_index.hpp>
+#include <steam/api/shortcuts_store.hpp>
+
+#include <algorithm>
+
+using namespace steam;
+
+namespace {
+
+    bool contains(const std::vector<api::SearchResult> &results, u64 appId) {
+        return std::ranges::any_of(results, [appId](const auto &result) { return result.entry.appId.getAppId() == appId; });
+    }
+
+}
+
+TEST_CASE(searchIndexMatchesInstallFolderOnly) {
+    test::TemporaryDirectory directory;
+    const auto steamDirectory = directory / "portalsteam";
+    REQUIRE(std::fs::create_directories(steamDirectory / "steamapps"));
+    REQUIRE(test::writeFile(steamDirectory / "steamapps" / "appmanifest_440.acf",
+        "\"AppState\"\n{\n\t\"appid\"\t\t\"440\"\n\t\"name\"\t\t\"Team Fortress 2\"\n\t\"installdir\"\t\t\"hydroponics\"\n}\n"));
+
+    api::LibraryIndex libraryIndex(steamDirectory);
+    REQUIRE(libraryIndex.refresh());
+
+    api::SearchIndex searchIndex;
+    searchIndex.addInstalledGames(libraryIndex);
+    REQUIRE(searchIndex.size() == 1);
+
+    CHECK(contains(searchIndex.search("fortress"), 440));
+    CHECK(contains(searchIndex.search("hydroponics"), 440));
+
+    // The library lives in a folder whose name shares nothing with the game
+    CHECK(!contains(searchIndex.search("portalsteam"), 440));
+}
+
+TEST_CASE(searchIndexMatchesExecutableNameOnly) {
+    VDF shortcuts;
+    const auto appId = api::AppId("/home/deck/Games/Emulators/dolphin.AppImage", "Dolphin");
+    shortcuts["shortcuts"]["0"] = api::ShortcutsStore::createShortcut(appId, "Dolphin", "/home/deck/Games/Emulators/dolphin.AppImage", "", { }, false);
+
+    api::SearchIndex searchIndex;
+    searchIndex.addShortcuts(1234, shortcuts);
+    REQUIRE(searchIndex.size() == 1);
+
+    const auto results = searchIndex.search("appimage");
+    REQUIRE(contains(results, appId.getAppId()));
+    CHECK(results[0].entry.exe == "/home/deck/Games/Emulators/dolphin.AppImage");
+
+    // Every shortcut in the same folder would match these
+    CHECK(!contains(searchIndex.search("emulators"), appId.getAppId()));
+    CHECK(!contains(searchIndex.search("deck"), appId.getAppId()));
+}
@@ -0,0 +1,88 @@
+#include <test.hpp>
+
+#include <steam/api/shortcuts_store.hpp>
+#include <steam/file_formats/shortcut_scanner.hpp>
+#include <steam/file_formats/vdf.hpp>
+
+#include <cstdlib>
+#include <string>
+
+using namespace steam;
+
+namespace {
+
+    std::vector<u8> createShortcutsFile(u32 count) {
+        VDF document;
+        for (u32 i = 0; i < count; i++) {
+            const auto name = "Game " + std::to_string(i);
+            const auto exe  = "/usr/bin/game" + std::to_string(i);
+
+            document["shortcuts"][std::to_string(i)] = api::ShortcutsStore::createShortcut(api::AppId(exe, name), name, exe, "", { "tag" }, false);
+        }
+
+        return document.dump();
+    }
+
+}
+
+TEST_CASE(shortcutScannerReadsShortcuts) {
+    const auto data = createShortcutsFile(3);
+
+    ShortcutScanner scanner(data);
+    for (u32 i = 0; i < 3; i++) {
+        auto entry = scanner.next();
+        REQUIRE(entry.has_value());
+
+        const auto name = "Game " + std::to_string(i);
+        const auto exe  = "/usr/bin/game" + std::to_string(i);
+        CHECK(entry->key == std::to_string(i));
+        CHECK(entry->appName == name);
+        CHECK(entry->appId == api::AppId(exe, name).getShortAppId());
+    }
+
+    CHECK(!scanner.next().has_value());
+    CHECK(scanner.isValid());
+}
+
+TEST_CASE(shortcutScannerRejectsTruncatedFiles) {
+    const auto data = createShortcutsFile(3);
+
+    // Empty files are what users without any shortcuts have
+    ShortcutScanner empty({ });
+    CHECK(!empty.next().has_value());
+    CHECK(empty.isValid());
+
+    for (size_t size = 1; size < data.size(); size++) {
+        ShortcutScanner scanner(std::span<const u8>(data).first(size));
+
+        size_t count = 0;
+        while (scanner.next().has_value())
+            count++;
+
+        if (scanner.isValid() || count > 3) {
+            CHECK(!"truncated file was scanned successfully");
+            return;
+        }
+    }
+}
+
+TEST_CASE(appIdsOfTruncatedFilesAreEmpty) {
+    test::TemporaryDirectory directory;
+    const auto path = directory / ".steam" / "steam" / "userdata" / "1234" / "config" / "shortcuts.vdf";
+    REQUIRE(std::fs::create_directories(path.parent_path()));
+
+    const std::string previousHome = std::getenv("HOME") != nullptr ? std::getenv("HOME") : "";
+    ::setenv("HOME", directory.getPath().c_str(), 1);
+
+    const auto data = createShortcutsFile(3);
+    const auto user = api::User(1234, "user");
+
+    REQUIRE(test::writeFile(path, std::string_view(reinterpret_cast<const char*>(data.data()), data.size())));
+    CHECK(api::AppId::getAppIds(user).size() == 3);
+
+    // Cut off in the middle of the last shortcut, the first two could still be scanned
+    REQUIRE(test::writeFile(path, std::string_view(reinterpret_cast<const char*>(data.data()), data.size() - 20)));
+    CHECK(api::AppId::getAppIds(user).empty());
+
+    ::setenv("HOME", previousHome.c_str(), 1);
+}
@@ -0,0 +1,227 @@
+#include <test.hpp>
+
+#include <steam/api/shortcuts_store.hpp>
+
+#include <steam/file_formats/vdf.hpp>
+
+#include <string>
+
+using namespace steam;
+using namespace steam::api;
+
+namespace {
+
+    bool writeShortcuts(const std::fs::path &path, std::initializer_list<std::string_view> names) {
+        VDF vdf;
+        vdf["shortcuts"] = VDF::Set { };
+
+        u32 index = 0;
+        for (auto name : names) {
+            const auto appId = AppId(std::fs::path("/games") / name, std::string(name));
+            vdf["shortcuts"][std::to_string(index)] = ShortcutsStore::createShortcut(appId, std::string(name), std::fs::path("/games") / name, "", { }, false);
+            index++;
+        }
+
+        const auto data = vdf.dump();
+        return test::writeFile(path, std::string_view(reinterpret_cast<const char*>(data.data()), data.size()));
+    }
+
+    AppId getAppId(std::string_view name) {
+        return AppId(std::fs::path("/games") / name, std::string(name));
+    }
+
+}
+
+TEST_CASE(shortcutsStoreTracksDirtyState) {
+    test::TemporaryDirectory directory;
+    const auto path = directory / "shortcuts.vdf";
+    REQUIRE(writeShortcuts(path, { "First", "Second" }));
+
+    ShortcutsStore store(path);
+    CHECK(store.getAppIds().size() == 2);
+    CHECK(store.contains(getAppId("First")));
+    CHECK(!store.isDirty());
+
+    // Flushing without edits must not touch the file
+    const auto before = test::readFile(path);
+    CHECK(store.flush());
+    CHECK(test::readFile(path) == before);
+
+    const auto appId = store.addGameShortcut("Third", "/games/Third");
+    REQUIRE(appId.has_value());
+    CHECK(store.isDirty());
+    CHECK(test::readFile(path) == before);
+
+    CHECK(store.flush());
+    CHECK(!store.isDirty());
+    CHECK(ShortcutsStore(path).contains(*appId));
+}
+
+TEST_CASE(shortcutsStoreRemovesAndRenumbers) {
+    test::TemporaryDirectory directory;
+    const auto path = directory / "shortcuts.vdf";
+    REQUIRE(writeShortcuts(path, { "First", "Second", "Third" }));
+
+    ShortcutsStore store(path);
+    CHECK(store.removeGameShortcut(getAppId("First")));
+    CHECK(!store.contains(getAppId("First")));
+
+    // The lookups have to follow the shortcuts that got shifted down to keep the keys contiguous
+    auto third = store.getShortcut(getAppId("Third"));
+    REQUIRE(third.has_value());
+    CHECK((*third)["AppName"].string() == "Third");
+    CHECK(store.removeGameShortcut(getAppId("Third")));
+    CHECK(store.getAppIds().size() == 1);
+    CHECK(store.flush());
+
+    VDF vdf(path);
+    CHECK(vdf["shortcuts"].set().size() == 1);
+    CHECK(vdf["shortcuts"]["0"]["AppName"].string() == "Second");
+}
+
+TEST_CASE(shortcutsStoreRevalidatesAfterExternalChanges) {
+    test::TemporaryDirectory directory;
+    const auto path = directory / "shortcuts.vdf";
+    REQUIRE(writeShortcuts(path, { "First" }));
+
+    ShortcutsStore store(path);
+    CHECK(store.contains(getAppId("First")));
+
+    REQUIRE(writeShortcuts(path, { "First", "Other" }));
+    CHECK(store.contains(getAppId("Other")));
+}
+
+TEST_CASE(shortcutsStoreRejectsConflictingFlush) {
+    test::TemporaryDirectory directory;
+    const auto path = directory / "shortcuts.vdf";
+    REQUIRE(writeShortcuts(path, { "First" }));
+
+    ShortcutsStore store(path);
+    REQUIRE(store.addGameShortcut("Mine", "/games/Mine").has_value());
+
+    // Someone else writes the file while the edit is pending
+    REQUIRE(writeShortcuts(path, { "First", "Theirs" }));
+    const auto theirs = test::readFile(path);
+
+    CHECK(!store.flush());
+    CHECK(test::readFile(path) == theirs);
+
+    CHECK(store.reload());
+    CHECK(!store.isDirty());
+    CHECK(store.contains(getAppId("Theirs")));
+    CHECK(!store.contains(getAppId("Mine")));
+}
+
+TEST_CASE(shortcutsStoreDropsFailedUpdates) {
+    test::TemporaryDirectory directory;
+    const auto path = directory / "shortcuts.vdf";
+    REQUIRE(writeShortcuts(path, { "First" }));
+
+    ShortcutsStore store(path);
+
+    CHECK(!store.update([](ShortcutsStore &store) {
+        return store.addGameShortcut("Rejected", "/games/Rejected").has_value() && false;
+    }));
+    CHECK(!store.isDirty());
+    CHECK(!store.contains(getAppId("Rejected")));
+
+    // The file changes underneath the callback after its edit, so the edit can't be written
+    CHECK(!store.update([&](ShortcutsStore &store) {
+        return store.addGameShortcut("Conflicting", "/games/Conflicting").has_value() && writeShortcuts(path, { "First", "Theirs" });
+    }));
+    CHECK(!store.isDirty());
+    CHECK(!store.contains(getAppId("Conflicting")));
+    CHECK(store.contains(getAppId("Theirs")));
+
+    // A later unrelated edit must not carry the rejected one along
+    CHECK(store.update([](ShortcutsStore &store) {
+        return store.addGameShortcut("Later", "/games/Later").has_value();
+    }));
+
+    ShortcutsStore onDisk(path);
+    CHECK(onDisk.contains(getAppId("Later")));
+    CHECK(onDisk.contains(getAppId("Theirs")));
+    CHECK(!onDisk.contains(getAppId("Conflicting")));
+}
+
+TEST_CASE(shortcutsStoreRefusesCorruptFiles) {
+    test::TemporaryDirectory directory;
+    const auto path = directory / "shortcuts.vdf";
+    REQUIRE(writeShortcuts(path, { "First" }));
+
+    auto content = test::readFile(path);
+    content.resize(content.size() / 2);
+    REQUIRE(test::writeFile(path, content));
+
+    ShortcutsStore store(path);
+    CHECK(!store.addGameShortcut("New", "/games/New").has_value());
+    CHECK(test::readFile(path) == content);
+}
+
+TEST_CASE(shortcutsStoreSkipsExistingShortcuts) {
+    test::TemporaryDirectory directory;
+    const auto path = directory / "shortcuts.vdf";
+    REQUIRE(writeShortcuts(path, { "First" }));
+
+    ShortcutsStore store(path);
+    CHECK(!store.addGameShortcut("First", "/games/First").has_value());
+    CHECK(!store.isDirty());
+    CHECK(store.getAppIds().size() == 1);
+}
+
+TEST_CASE(shortcutsStoreAddsBatches) {
+    test::TemporaryDirectory directory;
+    const auto path = directory / "shortcuts.vdf";
+    REQUIRE(writeShortcuts(path, { "First" }));
+
+    const std::vector<ShortcutSpec> games = {
+        { .appName = "Second", .exePath = "/games/Second" },
+        { .appName = "First",  .exePath = "/games/First" },
+        { .appName = "Third",  .exePath = "/games/Third", .tags = { "Tag" } },
+        { .appName = "Second", .exePath = "/games/Second" },
+    };
+
+    ShortcutsStore store(path);
+    const auto result = store.addGameShortcuts(games);
+
+    // Games that already had a shortcut before or earlier in the batch are reported as skipped
+    REQUIRE(result.size() == games.size());
+    CHECK(result[0].has_value() && result[0]->getAppId() == getAppId("Second").getAppId());
+    CHECK(!result[1].has_value());
+    CHECK(result[2].has_value() && result[2]->getAppId() == getAppId("Third").getAppId());
+    CHECK(!result[3].has_value());
+    CHECK(store.flush());
+
+    VDF vdf(path);
+    CHECK(vdf["shortcuts"].set().size() == 3);
+    CHECK(vdf["shortcuts"]["1"]["AppName"].string() == "Second");
+    CHECK(vdf["shortcuts"]["2"]["AppName"].string() == "Third");
+    CHECK(vdf["shortcuts"]["2"]["tags"]["0"].string() == "Tag");
+}
+
+TEST_CASE(shortcutsStoreRemovesBatchesAndRenumbers) {
+    test::TemporaryDirectory directory;
+    const auto path = directory / "shortcuts.vdf";
+    REQUIRE(writeShortcuts(path, { "First", "Second", "Third", "Fourth" }));
+
+    ShortcutsStore store(path);
+    const auto removed = store.removeGameShortcutsIf([](const VDF::Value &shortcut) {
+        const auto name = shortcut.set().at("AppName").string();
+        return name == "First" || name == "Third";
+    });
+
+    REQUIRE(removed.size() == 2);
+    CHECK(removed[0].getAppId() == getAppId("First").getAppId());
+    CHECK(removed[1].getAppId() == getAppId("Third").getAppId());
+
+    // The index follows the renumbered shortcuts
+    CHECK(!store.contains(getAppId("First")));
+    CHECK(store.contains(getAppId("Fourth")));
+    CHECK(store.removeGameShortcutsIf([](const VDF::Value &) { return false; }).empty());
+    CHECK(store.flush());
+
+    VDF vdf(path);
+    CHECK(vdf["shortcuts"].set().size() == 2);
+    CHECK(vdf["shortcuts"]["0"]["AppName"].string() == "Second");
+    CHECK(vdf["shortcuts"]["1"]["AppName"].string() == "Fourth");
+}
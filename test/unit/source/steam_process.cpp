@@ -0,0 +1,45 @@
+#include <test.hpp>
+
+#include <steam/api/steam_process.hpp>
+
+#include <chrono>
+#include <csignal>
+#include <cstdlib>
+#include <string>
+
+#include <sys/prctl.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+using namespace steam;
+using namespace std::chrono_literals;
+
+TEST_CASE(steamProcessWaitsForClientName) {
+    test::TemporaryDirectory directory;
+    REQUIRE(std::fs::create_directories(directory / ".steam"));
+
+    const std::string previousHome = std::getenv("HOME") != nullptr ? std::getenv("HOME") : "";
+    ::setenv("HOME", directory.getPath().c_str(), 1);
+
+    // Writes the pid file first and only takes on Steam's name afterwards, like the launcher script does
+    const pid_t child = ::fork();
+    if (child == 0) {
+        ::usleep(100'000);
+        test::writeFile(directory / ".steam" / "steam.pid", std::to_string(::getpid()));
+        ::usleep(200'000);
+        ::prctl(PR_SET_NAME, "steam");
+        ::sleep(10);
+        ::_exit(0);
+    }
+
+    const auto start   = std::chrono::steady_clock::now();
+    const auto process = api::SteamProcess::waitForStart(5s);
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+
+    CHECK(process.has_value() && process->getPid() == child);
+    CHECK(elapsed < 2s);
+
+    ::kill(child, SIGKILL);
+    ::waitpid(child, nullptr, 0);
+    ::setenv("HOME", previousHome.c_str(), 1);
+}
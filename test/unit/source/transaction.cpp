@@ -0,0 +1,171 @@
+#include <test.hpp>
+
+#include <steam/api/steam_api.hpp>
+#include <steam/api/transaction.hpp>
+#include <steam/helpers/file_lock.hpp>
+#include <steam/helpers/mapped_file.hpp>
+
+#include <cstdlib>
+#include <string>
+
+#include <sys/stat.h>
+
+using namespace steam;
+using namespace steam::api;
+
+namespace {
+
+    constexpr u32 UserId = 1234;
+
+    // Points the Steam directory into the test's temporary directory for as long as it's alive
+    class SteamDirectory {
+    public:
+        explicit SteamDirectory(const test::TemporaryDirectory &directory) {
+            this->m_previousHome = std::getenv("HOME") != nullptr ? std::getenv("HOME") : "";
+            ::setenv("HOME", directory.getPath().c_str(), 1);
+
+            std::fs::create_directories(this->getConfigPath().parent_path());
+            std::fs::create_directories(this->getShortcutsPath().parent_path());
+
+            test::writeFile(this->getConfigPath(), "\"InstallConfigStore\"\n{\n\t\"Software\"\n\t{\n\t}\n}\n");
+        }
+
+        ~SteamDirectory() {
+            ::setenv("HOME", this->m_previousHome.c_str(), 1);
+        }
+
+        [[nodiscard]] std::fs::path getConfigPath() const {
+            return fs::getSteamDirectory() / "config" / "config.vdf";
+        }
+
+        [[nodiscard]] std::fs::path getShortcutsPath() const {
+            return fs::getSteamDirectory() / "userdata" / std::to_string(UserId) / "config" / "shortcuts.vdf";
+        }
+
+    private:
+        std::string m_previousHome;
+    };
+
+    // Files are replaced through a rename on every write, so a new inode means the file got written
+    ino_t getInode(const std::fs::path &path) {
+        struct stat status = { };
+        if (::stat(path.c_str(), &status) != 0)
+            return 0;
+
+        return status.st_ino;
+    }
+
+    bool isLockedByOthers(const std::fs::path &path) {
+        return !fs::FileLock(path, fs::FileLock::Mode::Exclusive, false).isLocked();
+    }
+
+    std::vector<u64> getShortcutAppIds() {
+        std::vector<u64> result;
+        for (const auto &appId : AppId::getAppIds(User(UserId, "user")))
+            result.push_back(appId.getAppId());
+
+        return result;
+    }
+
+}
+
+TEST_CASE(transactionCommitWritesAllFiles) {
+    test::TemporaryDirectory directory;
+    SteamDirectory steam(directory);
+
+    const auto appId = AppId("/games/First", "First");
+    {
+        Transaction transaction(User(UserId, "user"));
+
+        CHECK(transaction.addGameShortcut("First", "/games/First").has_value());
+        CHECK(transaction.enableProtonForApp(appId, true));
+
+        // Nothing reaches the files before the commit
+        CHECK(!std::fs::exists(steam.getShortcutsPath()));
+        CHECK(transaction.commit());
+    }
+
+    CHECK(getShortcutAppIds() == std::vector { appId.getAppId() });
+
+    const auto config = fs::MappedFile(steam.getConfigPath());
+    REQUIRE(config.isValid());
+    CHECK(config.getString().find("proton_experimental") != std::string_view::npos);
+}
+
+TEST_CASE(transactionRollbackDiscardsEdits) {
+    test::TemporaryDirectory directory;
+    SteamDirectory steam(directory);
+
+    const auto second = AppId("/games/Second", "Second");
+
+    Transaction transaction(User(UserId, "user"));
+    CHECK(transaction.addGameShortcut("First", "/games/First").has_value());
+    transaction.rollback();
+
+    CHECK(transaction.addGameShortcut("Second", "/games/Second").has_value());
+    CHECK(transaction.commit());
+
+    CHECK(getShortcutAppIds() == std::vector { second.getAppId() });
+}
+
+TEST_CASE(transactionSkipsUnchangedFiles) {
+    test::TemporaryDirectory directory;
+    SteamDirectory steam(directory);
+
+    const auto inode = getInode(steam.getConfigPath());
+    REQUIRE(inode != 0);
+
+    Transaction transaction;
+    auto config = transaction.getConfig();
+    REQUIRE(config != nullptr);
+
+    // Looking at existing sections doesn't change anything
+    CHECK((*config)["InstallConfigStore"]["Software"].isSet());
+    CHECK(transaction.commit());
+
+    CHECK(getInode(steam.getConfigPath()) == inode);
+}
+
+TEST_CASE(transactionLocksFilesUntilDestroyed) {
+    test::TemporaryDirectory directory;
+    SteamDirectory steam(directory);
+
+    {
+        Transaction transaction(User(UserId, "user"));
+
+        CHECK(isLockedByOthers(steam.getShortcutsPath()));
+        CHECK(isLockedByOthers(steam.getConfigPath()));
+
+        // Committing keeps the files locked for further edits
+        CHECK(transaction.commit());
+        CHECK(isLockedByOthers(steam.getConfigPath()));
+    }
+
+    CHECK(!isLockedByOthers(steam.getShortcutsPath()));
+    CHECK(!isLockedByOthers(steam.getConfigPath()));
+}
+
+TEST_CASE(compatToolsAreMappedByAppId) {
+    test::TemporaryDirectory directory;
+    SteamDirectory steam(directory);
+
+    const auto shortcut = AppId("/games/First", "First");
+    const std::vector<CompatToolUpdate> updates = {
+        { .appId = AppId(440) },
+        { .appId = shortcut, .tool = { .name = "proton_9", .priority = 100 } },
+    };
+
+    REQUIRE(setCompatTools(updates));
+
+    auto tools = getCompatTools();
+    CHECK(tools.size() == 2);
+    CHECK(tools.contains(440) && tools[440].name == "proton_experimental" && tools[440].priority == 250);
+    CHECK(tools.contains(shortcut.getShortAppId()) && tools[shortcut.getShortAppId()].name == "proton_9");
+    CHECK(tools[shortcut.getShortAppId()].priority == 100);
+
+    // Disabled entries remove the mapping again
+    REQUIRE(enableProtonForApp(AppId(440), false));
+
+    tools = getCompatTools();
+    CHECK(tools.size() == 1 && !tools.contains(440));
+}
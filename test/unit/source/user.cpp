@@ -0,0 +1,106 @@
+#include <test.hpp>
+
+#include <steam/api/user.hpp>
+
+#include <chrono>
+#include <cstdlib>
+#include <string>
+
+using namespace steam;
+using namespace std::chrono_literals;
+
+namespace {
+
+    // SteamID64 of an individual account, loginusers.vdf lists accounts by it
+    std::string getSteamId(u32 accountId) {
+        return std::to_string(76561197960265728ULL + accountId);
+    }
+
+    std::string createLoginUsers(std::initializer_list<std::pair<u32, std::string_view>> users) {
+        std::string result = "\"users\"\n{\n";
+        for (const auto &[accountId, name] : users)
+            result += "\t\"" + getSteamId(accountId) + "\"\n\t{\n\t\t\"AccountName\"\t\t\"account\"\n\t\t\"PersonaName\"\t\t\"" + std::string(name) + "\"\n\t}\n";
+        result += "}\n";
+
+        return result;
+    }
+
+    std::string createLocalConfig(u32 accountId, std::string_view name) {
+        return "\"UserLocalConfigStore\"\n{\n\t\"friends\"\n\t{\n\t\t\"" + std::to_string(accountId) + "\"\n\t\t{\n\t\t\t\"name\"\t\t\"" + std::string(name) + "\"\n\t\t}\n\t}\n}\n";
+    }
+
+    std::string getNames(const std::vector<api::User> &users) {
+        std::string result;
+        for (const auto &user : users)
+            result += std::to_string(user.getId()) + "=" + user.getName() + ";";
+
+        return result;
+    }
+
+    // Modification times may not change between two writes in quick succession, the cache relies on them
+    void touch(const std::fs::path &path) {
+        std::fs::last_write_time(path, std::fs::last_write_time(path) + 1s);
+    }
+
+}
+
+TEST_CASE(usersAreNamedFromLoginUsersAndLocalConfig) {
+    test::TemporaryDirectory directory;
+    const auto steam = directory / ".steam" / "steam";
+    REQUIRE(std::fs::create_directories(steam / "config"));
+
+    // Logged in through this installation, only known through its localconfig.vdf, not known at all, not a user
+    for (const auto folder : { "1", "20", "300", "0", "anonymous" })
+        REQUIRE(std::fs::create_directories(steam / "userdata" / folder / "config"));
+
+    REQUIRE(test::writeFile(steam / "config" / "loginusers.vdf", createLoginUsers({ { 1, "First" }, { 4000, "Elsewhere" } })));
+    REQUIRE(test::writeFile(steam / "userdata" / "20" / "config" / "localconfig.vdf", createLocalConfig(20, "Second")));
+
+    const std::string previousHome = std::getenv("HOME") != nullptr ? std::getenv("HOME") : "";
+    ::setenv("HOME", directory.getPath().c_str(), 1);
+
+    api::User::refreshUsers();
+    CHECK(getNames(api::User::getUsers()) == "1=First;20=Second;");
+
+    CHECK(api::User::queryUserName(1) == "First");
+    CHECK(api::User::queryUserName(20) == "Second");
+    CHECK(api::User::queryUserName(300).empty());
+    CHECK(api::User::queryLoginUsers().size() == 2);
+
+    ::setenv("HOME", previousHome.c_str(), 1);
+    api::User::refreshUsers();
+}
+
+TEST_CASE(usersAreCachedUntilTheirFilesChange) {
+    test::TemporaryDirectory directory;
+    const auto steam = directory / ".steam" / "steam";
+    const auto loginUsers = steam / "config" / "loginusers.vdf";
+    REQUIRE(std::fs::create_directories(steam / "config"));
+    REQUIRE(std::fs::create_directories(steam / "userdata" / "1"));
+    REQUIRE(test::writeFile(loginUsers, createLoginUsers({ { 1, "First" }, { 2, "Second" } })));
+
+    const std::string previousHome = std::getenv("HOME") != nullptr ? std::getenv("HOME") : "";
+    ::setenv("HOME", directory.getPath().c_str(), 1);
+
+    api::User::refreshUsers();
+    CHECK(getNames(api::User::getUsers()) == "1=First;");
+
+    // Nothing gets read again as long as the modification times stay the same
+    const auto loginUsersTime = std::fs::last_write_time(loginUsers);
+    REQUIRE(test::writeFile(loginUsers, createLoginUsers({ { 1, "Cached" }, { 2, "Second" } })));
+    std::fs::last_write_time(loginUsers, loginUsersTime);
+    CHECK(getNames(api::User::getUsers()) == "1=First;");
+
+    // New userdata folders show up right away, along with everything else that changed in the meantime
+    REQUIRE(std::fs::create_directories(steam / "userdata" / "2"));
+    touch(steam / "userdata");
+    CHECK(getNames(api::User::getUsers()) == "1=Cached;2=Second;");
+
+    // So do renames in loginusers.vdf
+    REQUIRE(test::writeFile(loginUsers, createLoginUsers({ { 1, "Renamed" }, { 2, "Second" } })));
+    touch(loginUsers);
+    CHECK(getNames(api::User::getUsers()) == "1=Renamed;2=Second;");
+
+    ::setenv("HOME", previousHome.c_str(), 1);
+    api::User::refreshUsers();
+}
@@ -0,0 +1,72 @@
+#include <test.hpp>
+
+#include <steam/file_formats/vdf.hpp>
+
+#include <string>
+
+using namespace steam;
+
+namespace {
+
+    std::vector<u8> createDocument() {
+        VDF document;
+        for (u32 i = 0; i < 3; i++) {
+            auto &entry = document["shortcuts"][std::to_string(i)];
+            entry["appid"]   = 0x8000'0000 | i;
+            entry["AppName"] = std::string_view("Game " + std::to_string(i));
+            entry["tags"]["0"] = "tag";
+        }
+
+        return document.dump();
+    }
+
+}
+
+TEST_CASE(vdfValidatorRejectsTruncatedFiles) {
+    const auto data = createDocument();
+    REQUIRE(VDF::validate(data));
+
+    for (size_t size = 0; size < data.size(); size++) {
+        if (VDF::validate(std::span<const u8>(data).first(size))) {
+            CHECK(!"truncated file passed validation");
+            return;
+        }
+    }
+}
+
+TEST_CASE(vdfParallelDumpMatchesSerialDump) {
+    // Enough entries to go over the size from which documents get dumped in parallel, one of them large enough to be split up itself
+    VDF document;
+    auto &list = document["list"];
+    for (u32 i = 0; i < 20'000; i++) {
+        auto &entry = list[std::to_string(i)];
+        entry["id"]   = i;
+        entry["name"] = std::string_view("Entry " + std::to_string(i) + std::string(i % 50, 'x'));
+    }
+
+    for (u32 i = 0; i < 4'000; i++)
+        list["large"][std::to_string(i)] = std::string_view(std::string(32, char('a' + i % 26)));
+
+    const auto data = document.dump();
+    REQUIRE(data.size() > 1024 * 1024);
+
+    // Every entry on its own is small enough to take the serial path. Their dumps only differ by the framing around them
+    VDF empty;
+    empty["list"] = VDF::Set { };
+    const auto framing = empty.dump();
+    const auto prefix = std::span<const u8>(framing).first(framing.size() - 2);
+
+    std::vector<u8> expected(prefix.begin(), prefix.end());
+    for (const auto &[key, value] : list.set()) {
+        VDF single;
+        single["list"][std::string(key.view())] = value;
+
+        const auto singleData = single.dump();
+        REQUIRE(singleData.size() < 1024 * 1024);
+        expected.insert(expected.end(), singleData.begin() + prefix.size(), singleData.end() - 2);
+    }
+    expected.insert(expected.end(), framing.end() - 2, framing.end());
+
+    CHECK(data == expected);
+    CHECK(VDF(data) == document);
+}
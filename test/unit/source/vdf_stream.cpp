@@ -0,0 +1,98 @@
+#include <test.hpp>
+
+#include <steam/file_formats/vdf_stream.hpp>
+#include <steam/helpers/file.hpp>
+
+#include <string>
+
+using namespace steam;
+
+namespace {
+
+    VDF createShortcuts(u32 count) {
+        VDF document;
+        for (u32 i = 0; i < count; i++) {
+            auto &entry = document["shortcuts"][std::to_string(i)];
+            entry["appid"]   = 0x8000'0000 | i;
+            entry["AppName"] = std::string_view("Game " + std::to_string(i));
+            entry["tags"]["0"] = "tag";
+        }
+
+        return document;
+    }
+
+    bool writeDocument(const std::fs::path &path, const VDF &document) {
+        const auto data = document.dump();
+
+        return test::writeFile(path, std::string_view(reinterpret_cast<const char*>(data.data()), data.size()));
+    }
+
+}
+
+TEST_CASE(vdfTransformCopiesUnchangedFiles) {
+    test::TemporaryDirectory directory;
+    const auto document = createShortcuts(100);
+    REQUIRE(writeDocument(directory / "input.vdf", document));
+
+    REQUIRE(VDFTransform().apply(directory / "input.vdf", directory / "output.vdf"));
+    CHECK(test::readFile(directory / "output.vdf") == test::readFile(directory / "input.vdf"));
+}
+
+TEST_CASE(vdfTransformFiltersAndRenumbers) {
+    test::TemporaryDirectory directory;
+    REQUIRE(writeDocument(directory / "input.vdf", createShortcuts(10)));
+
+    const auto transform = VDFTransform()
+        .filter([](std::string_view, const VDF::Value &record) { return record.set().at("appid").integer() % 2 == 1; })
+        .map([](std::string_view, VDF::Value &record) { record.set()["AppName"] = "Renamed"; })
+        .renumber();
+
+    REQUIRE(transform.apply(directory / "input.vdf", directory / "output.vdf"));
+
+    const auto output = VDF(fs::File(directory / "output.vdf", fs::File::Mode::Read).readBytes());
+    const auto &shortcuts = output.get().at("shortcuts").set();
+    REQUIRE(shortcuts.size() == 5);
+
+    for (u32 i = 0; i < 5; i++) {
+        const auto &record = shortcuts.at(std::to_string(i)).set();
+        CHECK(record.at("appid").integer() == (0x8000'0000 | (i * 2 + 1)));
+        CHECK(record.at("AppName").string() == "Renamed");
+    }
+}
+
+TEST_CASE(vdfTransformWorksInPlace) {
+    test::TemporaryDirectory directory;
+    const auto path = directory / "shortcuts.vdf";
+    REQUIRE(writeDocument(path, createShortcuts(10)));
+
+    const auto transform = VDFTransform().filter([](std::string_view key, const VDF::Value &) { return key != "3"; }).renumber();
+    REQUIRE(transform.apply(path, path));
+
+    const auto output = VDF(fs::File(path, fs::File::Mode::Read).readBytes());
+    CHECK(output.get().at("shortcuts").set().size() == 9);
+}
+
+TEST_CASE(vdfTransformRejectsTruncatedInput) {
+    test::TemporaryDirectory directory;
+    const auto data = createShortcuts(10).dump();
+    REQUIRE(test::writeFile(directory / "output.vdf", "previous"));
+
+    // A failed run leaves the previous output alone instead of a partially written file. Like the regular parser, the
+    // reader accepts files missing only the document's final terminator, so the cut has to go deeper than that
+    for (size_t size : { size_t(1), data.size() / 2, data.size() - 2 }) {
+        REQUIRE(test::writeFile(directory / "input.vdf", std::string_view(reinterpret_cast<const char*>(data.data()), size)));
+        CHECK(!VDFTransform().apply(directory / "input.vdf", directory / "output.vdf"));
+        CHECK(test::readFile(directory / "output.vdf") == "previous");
+    }
+}
+
+TEST_CASE(vdfTransformReportsFailedWrites) {
+    test::TemporaryDirectory directory;
+    REQUIRE(writeDocument(directory / "input.vdf", createShortcuts(10)));
+    REQUIRE(test::writeFile(directory / "output.vdf", ""));
+
+    // A file that was only opened for reading can't be written to
+    auto input  = fs::File(directory / "input.vdf", fs::File::Mode::Read);
+    auto output = fs::File(directory / "output.vdf", fs::File::Mode::Read);
+    CHECK(!VDFTransform().apply(input, output));
+}
@@ -0,0 +1,57 @@
+#include <test.hpp>
+
+#include <steam/file_formats/document_watcher.hpp>
+#include <steam/helpers/watcher.hpp>
+
+#include <algorithm>
+#include <chrono>
+
+using namespace steam;
+using namespace std::chrono_literals;
+
+TEST_CASE(documentWatcherWithoutWatchIsInvalid) {
+    test::TemporaryDirectory directory;
+
+    DocumentWatcher<KeyValues> watcher(directory / "missing" / "config.vdf");
+    CHECK(!watcher.isValid());
+    CHECK(!watcher.process(10ms));
+}
+
+TEST_CASE(documentWatcherReloadsChangedFiles) {
+    test::TemporaryDirectory directory;
+    const auto path = directory / "config.vdf";
+    REQUIRE(test::writeFile(path, "\"root\"\n{\n\t\"key\"\t\t\"first\"\n}\n"));
+
+    DocumentWatcher<KeyValues> watcher(path, 10ms);
+    REQUIRE(watcher.isValid());
+    CHECK(watcher.getDocument()["root"]["key"].string() == "first");
+
+    size_t notifications = 0;
+    watcher.subscribe([&](const KeyValues &, const auto &changes) { notifications += changes.size(); });
+
+    REQUIRE(fs::writeFileAtomic(path, std::string_view("\"root\"\n{\n\t\"key\"\t\t\"second\"\n}\n")));
+    CHECK(watcher.process(1s));
+    CHECK(watcher.getDocument()["root"]["key"].string() == "second");
+    CHECK(notifications == 1);
+}
+
+TEST_CASE(watcherReportsQueueOverflow) {
+    test::TemporaryDirectory directory;
+    const auto path = directory / "config.vdf";
+    REQUIRE(test::writeFile(path, ""));
+
+    fs::Watcher watcher;
+    REQUIRE(watcher.watchFile(path));
+    REQUIRE(watcher.watchDirectory(directory.getPath()));
+
+    // Every new file queues a create and a close event, enough of them overflow the kernel's default queue size
+    for (u32 i = 0; i < 10'000; i++)
+        REQUIRE(test::writeFile(directory / std::to_string(i), ""));
+
+    const auto changes = watcher.getChanges();
+    CHECK(watcher.hasOverflowed());
+    CHECK(std::find(changes.begin(), changes.end(), path) != changes.end());
+
+    CHECK(watcher.getChanges().empty());
+    CHECK(!watcher.hasOverflowed());
+}
@@ -0,0 +1,621 @@
+#include <steam/file_formats/journal.hpp>
+#include <steam/file_formats/keyvalues.hpp>
+#include <steam/file_formats/vdf.hpp>
+#include <steam/file_formats/vdf_stream.hpp>
+
+#include <steam/helpers/file.hpp>
+#include <steam/helpers/file_lock.hpp>
+#include <steam/helpers/fs.hpp>
+#include <steam/helpers/hash.hpp>
+#include <steam/helpers/mapped_file.hpp>
+#include <steam/helpers/parallel.hpp>
+#include <steam/helpers/utils.hpp>
+
+#include <fmt/format.h>
+#include <nlohmann/json.hpp>
+
+#include <charconv>
+#include <cstdio>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace steam;
+
+namespace {
+
+    constexpr static auto Usage =
+        "Usage: steamkv <command> [arguments]\n"
+        "\n"
+        "Commands:\n"
+        "  query <pattern> <file>...        Print all values matching the pattern, e.g. 'shortcuts/*/AppName'\n"
+        "  set <pattern> <value> <file>...  Set all values matching the pattern. Existing integers stay integers\n"
+        "  delete <pattern> <file>...       Remove all keys matching the pattern\n"
+        "  convert <format> <file> [output] Convert a file to vdf, keyvalues or json. Writes to stdout if no output is given\n"
+        "  validate <file>...               Check that files are well-formed\n"
+        "\n"
+        "Pattern segments are separated by '/', a '*' matches any single key.\n"
+        "Files are processed in parallel, their output is printed in the order they were passed in.\n"
+        "Edits are recorded in '<file>.journal' next to the file, with the original kept as '<file>.orig'.\n";
+
+    enum class Format {
+        VDF,
+        KeyValues,
+        JSON
+    };
+
+    struct Result {
+        std::string output, error;
+    };
+
+    std::optional<Format> parseFormat(std::string_view name) {
+        if (name == "vdf")
+            return Format::VDF;
+        if (name == "keyvalues" || name == "kv")
+            return Format::KeyValues;
+        if (name == "json")
+            return Format::JSON;
+
+        return std::nullopt;
+    }
+
+    // Text KeyValues files start with a quote or whitespace, binary VDF ones with a type byte, so the two can't be mixed up
+    std::optional<Format> detectFormat(const fs::MappedFile &file) {
+        if (file.getBytes().empty())
+            return std::nullopt;
+        if (VDF::validate(file.getBytes()))
+            return Format::VDF;
+        if (KeyValues::validate(file.getString()))
+            return Format::KeyValues;
+        if (nlohmann::json::accept(file.getString()))
+            return Format::JSON;
+
+        return std::nullopt;
+    }
+
+    // Returns std::nullopt for empty patterns and ones with empty segments like 'shortcuts//AppName'
+    std::optional<std::vector<std::string_view>> splitPattern(std::string_view pattern) {
+        std::vector<std::string_view> segments;
+
+        while (true) {
+            const auto separator = pattern.find('/');
+            const auto segment   = pattern.substr(0, separator);
+            if (segment.empty())
+                return std::nullopt;
+
+            segments.push_back(segment);
+
+            if (separator == std::string_view::npos)
+                break;
+
+            pattern.remove_prefix(separator + 1);
+        }
+
+        return segments;
+    }
+
+    int printInvalidPattern(std::string_view pattern) {
+        fmt::print(stderr, "steamkv: invalid pattern '{}'\n{}", pattern, Usage);
+        return EXIT_FAILURE;
+    }
+
+    bool matchesPattern(std::span<const std::string_view> pattern, std::span<const std::string> path) {
+        if (pattern.size() != path.size())
+            return false;
+
+        for (size_t i = 0; i < pattern.size(); i++) {
+            if (pattern[i] != "*" && pattern[i] != path[i])
+                return false;
+        }
+
+        return true;
+    }
+
+    std::string joinPath(std::span<const std::string> path) {
+        std::string result;
+        for (const auto &segment : path) {
+            if (!result.empty())
+                result += '/';
+            result += segment;
+        }
+
+        return result;
+    }
+
+    template<typename Set>
+    nlohmann::json setToJson(const Set &set);
+
+    template<typename Value>
+    nlohmann::json toJson(const Value &value) {
+        return value.visit(overloaded {
+            [](std::string_view string) -> nlohmann::json { return std::string(string); },
+            [](u32 integer) -> nlohmann::json { return integer; },
+            [](const auto &set) -> nlohmann::json { return setToJson(set); }
+        });
+    }
+
+    template<typename Set>
+    nlohmann::json setToJson(const Set &set) {
+        auto object = nlohmann::json::object();
+        for (const auto &[key, child] : set)
+            object[std::string(key.view())] = toJson(child);
+
+        return object;
+    }
+
+    // Arrays turn into sets keyed by their indices, which is how Steam stores lists. KeyValues only knows strings
+    template<typename Document>
+    std::optional<typename Document::Set> setFromJson(const nlohmann::json &json) {
+        typename Document::Set set;
+
+        for (size_t index = 0; const auto &[key, value] : json.items()) {
+            auto &child = set[json.is_array() ? std::to_string(index) : key];
+            index++;
+
+            if (value.is_object() || value.is_array()) {
+                auto childSet = setFromJson<Document>(value);
+                if (!childSet.has_value())
+                    return std::nullopt;
+
+                child = std::move(*childSet);
+            } else if (value.is_string()) {
+                child = value.template get<std::string>();
+            } else if constexpr (std::same_as<Document, VDF>) {
+                if (value.is_boolean())
+                    child = u32(value.template get<bool>());
+                else if (value.is_number_unsigned() && value.template get<u64>() <= 0xFFFF'FFFF)
+                    child = value.template get<u32>();
+                else
+                    return std::nullopt;
+            } else {
+                if (value.is_null())
+                    return std::nullopt;
+
+                child = value.is_boolean() ? std::string(value.template get<bool>() ? "1" : "0") : value.dump();
+            }
+        }
+
+        return set;
+    }
+
+    template<typename Value>
+    std::string formatValue(const Value &value) {
+        return value.visit(overloaded {
+            [](std::string_view string) { return std::string(string); },
+            [](u32 integer) { return std::to_string(integer); },
+            [&](const auto &) { return toJson(value).dump(); }
+        });
+    }
+
+    std::string formatLine(const std::fs::path &file, bool printFileName, std::string_view path, std::string_view value) {
+        if (printFileName)
+            return fmt::format("{}\t{}\t{}\n", file.string(), path, value);
+        else
+            return fmt::format("{}\t{}\n", path, value);
+    }
+
+    // Binary VDF files get queried straight from the event stream, only the sets that match get built up in memory
+    Result queryVDF(const std::fs::path &path, std::span<const std::string_view> pattern, bool printFileName) {
+        Result result;
+
+        fs::File file(path, fs::File::Mode::Read);
+        if (!file.isValid())
+            return { .output = { }, .error = "failed to open file" };
+
+        VDFStreamReader reader(file);
+
+        std::vector<std::string> keys;
+        VDF::Set captured;
+        std::vector<VDF::Set*> captureStack;
+        std::string capturedPath;
+
+        while (auto event = reader.next()) {
+            if (!captureStack.empty()) {
+                auto &set = *captureStack.back();
+                switch (event->type) {
+                    case VDF::Type::Set: {
+                        auto &child = set[std::string(event->key)];
+                        child = VDF::Set { };
+                        captureStack.push_back(&child.set());
+                        break;
+                    }
+                    case VDF::Type::String:
+                        set[std::string(event->key)] = event->string;
+                        break;
+                    case VDF::Type::Integer:
+                        set[std::string(event->key)] = event->integer;
+                        break;
+                    case VDF::Type::EndSet:
+                        captureStack.pop_back();
+                        if (captureStack.empty()) {
+                            result.output += formatLine(path, printFileName, capturedPath, setToJson(captured).dump());
+                            keys.pop_back();
+                        }
+                        break;
+                }
+
+                continue;
+            }
+
+            switch (event->type) {
+                case VDF::Type::Set:
+                    keys.emplace_back(event->key);
+                    if (matchesPattern(pattern, keys)) {
+                        captured.clear();
+                        captureStack.push_back(&captured);
+                        capturedPath = joinPath(keys);
+                    }
+                    break;
+                case VDF::Type::EndSet:
+                    keys.pop_back();
+                    break;
+                case VDF::Type::String:
+                case VDF::Type::Integer:
+                    keys.emplace_back(event->key);
+                    if (matchesPattern(pattern, keys))
+                        result.output += formatLine(path, printFileName, joinPath(keys), event->type == VDF::Type::String ? std::string(event->string) : std::to_string(event->integer));
+                    keys.pop_back();
+                    break;
+            }
+        }
+
+        if (reader.hasError())
+            result.error = "malformed VDF file";
+
+        return result;
+    }
+
+    template<typename Set, typename Callback>
+    void forEachMatch(const Set &set, std::span<const std::string_view> pattern, std::vector<std::string> &path, Callback &&callback) {
+        for (const auto &[key, value] : set) {
+            if (pattern.front() != "*" && pattern.front() != key.view())
+                continue;
+
+            path.emplace_back(key.view());
+
+            if (pattern.size() == 1)
+                callback(path, value);
+            else if (value.isSet())
+                forEachMatch(value.set(), pattern.subspan(1), path, callback);
+
+            path.pop_back();
+        }
+    }
+
+    Result query(const std::fs::path &path, std::span<const std::string_view> pattern, bool printFileName) {
+        auto file = fs::MappedFile(path);
+        if (!file.isValid())
+            return { .output = { }, .error = "failed to open file" };
+
+        const auto format = detectFormat(file);
+        if (!format.has_value())
+            return { .output = { }, .error = "unknown file format" };
+
+        if (*format == Format::VDF)
+            return queryVDF(path, pattern, printFileName);
+
+        Result result;
+        std::vector<std::string> keys;
+        auto print = [&](const std::vector<std::string> &matchPath, const auto &value) {
+            result.output += formatLine(path, printFileName, joinPath(matchPath), formatValue(value));
+        };
+
+        if (*format == Format::KeyValues) {
+            const auto document = KeyValues(file.getString());
+            forEachMatch(document.get(), pattern, keys, print);
+        } else {
+            auto json = nlohmann::json::parse(file.getString(), nullptr, false);
+            auto set = setFromJson<VDF>(json);
+            if (!set.has_value())
+                return { .output = { }, .error = "JSON file can't be represented as VDF" };
+
+            forEachMatch(*set, pattern, keys, print);
+        }
+
+        return result;
+    }
+
+    // Walks down the pattern, creating missing keys along the way if create is set. Calls back with the set
+    // containing the last key and the key itself
+    template<typename Set, typename Callback>
+    void forEachParent(Set &set, std::span<const std::string_view> pattern, bool create, Callback &&callback) {
+        if (pattern.size() == 1) {
+            if (pattern.front() == "*") {
+                std::vector<std::string> keys;
+                for (const auto &[key, value] : set)
+                    keys.emplace_back(key.view());
+
+                for (const auto &key : keys)
+                    callback(set, key);
+            } else if (create || set.contains(pattern.front())) {
+                callback(set, std::string(pattern.front()));
+            }
+
+            return;
+        }
+
+        if (pattern.front() == "*") {
+            for (auto &[key, value] : set) {
+                if (value.isSet())
+                    forEachParent(value.set(), pattern.subspan(1), create, callback);
+            }
+        } else {
+            auto it = set.find(pattern.front());
+            if (it == set.end()) {
+                if (!create)
+                    return;
+
+                it = set.emplace(std::string(pattern.front()), typename Set::mapped_type()).first;
+                it->second = Set { };
+            }
+
+            if (it->second.isSet())
+                forEachParent(it->second.set(), pattern.subspan(1), create, callback);
+        }
+    }
+
+    std::optional<u32> parseInteger(std::string_view string) {
+        u32 result = 0;
+        auto [end, error] = std::from_chars(string.data(), string.data() + string.size(), result);
+        if (error != std::errc() || end != string.data() + string.size())
+            return std::nullopt;
+
+        return result;
+    }
+
+    // Records the edit in the file's journal and replaces the file, the same way api::Transaction writes its documents
+    template<typename Document>
+    bool write(const std::fs::path &path, const Document &previous, u32 previousChecksum, const Document &current, auto data) {
+        if (!Document::validate(data))
+            return false;
+
+        if (!Journal<Document>(path).record(previous, previousChecksum, current, crc32(data)))
+            return false;
+
+        return fs::writeFileAtomic(path, data);
+    }
+
+    // Edits a file in place. Nothing gets written if nothing matched or the edit couldn't be applied everywhere
+    Result edit(const std::fs::path &path, std::span<const std::string_view> pattern, const std::optional<std::string> &newValue) {
+        // Keep the file locked from reading it until it got replaced so no other libsteam user's edit gets lost in between
+        fs::FileLock lock(path);
+        if (!lock.isLocked())
+            return { .output = { }, .error = "failed to lock file" };
+
+        auto file = fs::MappedFile(path);
+        if (!file.isValid())
+            return { .output = { }, .error = "failed to open file" };
+
+        const auto format = detectFormat(file);
+        if (!format.has_value() || *format == Format::JSON)
+            return { .output = { }, .error = "only VDF and KeyValues files can be edited" };
+
+        size_t changes = 0;
+        std::string error;
+
+        auto apply = [&](auto &document) {
+            forEachParent(document.get(), pattern, newValue.has_value(), [&](auto &set, const std::string &key) {
+                if (!newValue.has_value()) {
+                    if (set.erase(key) > 0)
+                        changes++;
+
+                    return;
+                }
+
+                auto &value = set[key];
+                if constexpr (std::same_as<std::remove_cvref_t<decltype(document)>, VDF>) {
+                    if (value.isInteger()) {
+                        auto integer = parseInteger(*newValue);
+                        if (!integer.has_value()) {
+                            error = fmt::format("'{}' expects an integer", key);
+                            return;
+                        }
+
+                        value = *integer;
+                        changes++;
+                        return;
+                    }
+                }
+
+                value = std::string_view(*newValue);
+                changes++;
+            });
+        };
+
+        auto checkChanges = [&]() -> std::optional<Result> {
+            if (!error.empty())
+                return Result { .output = { }, .error = error };
+            if (changes == 0)
+                return Result { .output = { }, .error = "no matching keys" };
+
+            return std::nullopt;
+        };
+
+        bool written;
+        if (*format == Format::VDF) {
+            const auto previous = VDF(file.getBytes());
+            auto document = previous;
+            apply(document);
+            if (auto result = checkChanges(); result.has_value())
+                return *result;
+
+            const auto data = document.dump();
+            written = write(path, previous, crc32(file.getBytes()), document, std::span<const u8>(data));
+        } else {
+            const auto previous = KeyValues(file.getString());
+            auto document = previous;
+            apply(document);
+            if (auto result = checkChanges(); result.has_value())
+                return *result;
+
+            const auto data = document.dump();
+            written = write(path, previous, crc32(file.getString()), document, std::string_view(data));
+        }
+
+        if (!written)
+            return { .output = { }, .error = "failed to write file" };
+
+        return { .output = fmt::format("{}: {} change{}\n", path.string(), changes, changes == 1 ? "" : "s"), .error = { } };
+    }
+
+    Result validate(const std::fs::path &path) {
+        auto file = fs::MappedFile(path);
+        if (!file.isValid())
+            return { .output = { }, .error = "failed to open file" };
+
+        // Report the text error for anything that doesn't look like a binary file
+        const auto isBinary = !file.getBytes().empty() && file.getBytes().front() <= u8(VDF::Type::EndSet);
+        const auto result   = isBinary ? VDF::validate(file.getBytes()) : KeyValues::validate(file.getString());
+
+        if (result)
+            return { .output = fmt::format("{}: ok ({}, {} nodes)\n", path.string(), isBinary ? "vdf" : "keyvalues", result.nodeCount), .error = { } };
+        else
+            return { .output = { }, .error = fmt::format("invalid at offset {}", result.offset) };
+    }
+
+    std::optional<std::string> convert(const std::fs::path &path, Format target, std::string &error) {
+        auto file = fs::MappedFile(path);
+        if (!file.isValid()) {
+            error = "failed to open file";
+            return std::nullopt;
+        }
+
+        const auto format = detectFormat(file);
+        if (!format.has_value()) {
+            error = "unknown file format";
+            return std::nullopt;
+        }
+
+        nlohmann::json json;
+        switch (*format) {
+            case Format::VDF:       json = setToJson(VDF(file.getBytes()).get());         break;
+            case Format::KeyValues: json = setToJson(KeyValues(file.getString()).get());  break;
+            case Format::JSON:      json = nlohmann::json::parse(file.getString());       break;
+        }
+
+        if (target == Format::JSON)
+            return json.dump(4) + "\n";
+
+        if (!json.is_object()) {
+            error = "only JSON objects can be converted";
+            return std::nullopt;
+        }
+
+        if (target == Format::VDF) {
+            auto set = setFromJson<VDF>(json);
+            if (!set.has_value()) {
+                error = "VDF files can only hold strings and unsigned 32 bit integers";
+                return std::nullopt;
+            }
+
+            VDF document;
+            document.get() = std::move(*set);
+
+            const auto data = document.dump();
+            return std::string(data.begin(), data.end());
+        } else {
+            auto set = setFromJson<KeyValues>(json);
+            if (!set.has_value()) {
+                error = "KeyValues files can't hold null values";
+                return std::nullopt;
+            }
+
+            KeyValues document;
+            document.get() = std::move(*set);
+
+            return document.dump();
+        }
+    }
+
+    int runParallel(std::span<char*> files, auto &&function) {
+        std::vector<Result> results(files.size());
+        parallelFor(files.size(), [&](size_t i) {
+            results[i] = function(std::fs::path(files[i]));
+        });
+
+        int exitCode = EXIT_SUCCESS;
+        for (size_t i = 0; i < files.size(); i++) {
+            std::fwrite(results[i].output.data(), 1, results[i].output.size(), stdout);
+
+            if (!results[i].error.empty()) {
+                std::fflush(stdout);
+                fmt::print(stderr, "steamkv: {}: {}\n", files[i], results[i].error);
+                exitCode = EXIT_FAILURE;
+            }
+        }
+
+        return exitCode;
+    }
+
+}
+
+int main(int argc, char **argv) {
+    const std::span<char*> arguments(argv + 1, argc - 1);
+    if (arguments.empty()) {
+        fmt::print(stderr, "{}", Usage);
+        return EXIT_FAILURE;
+    }
+
+    const std::string_view command = arguments[0];
+
+    if (command == "query" && arguments.size() >= 3) {
+        const auto pattern = splitPattern(arguments[1]);
+        const auto files   = arguments.subspan(2);
+        if (!pattern.has_value())
+            return printInvalidPattern(arguments[1]);
+
+        return runParallel(files, [&](const std::fs::path &path) {
+            return query(path, *pattern, files.size() > 1);
+        });
+    } else if (command == "set" && arguments.size() >= 4) {
+        const auto pattern = splitPattern(arguments[1]);
+        const std::string value = arguments[2];
+        if (!pattern.has_value())
+            return printInvalidPattern(arguments[1]);
+
+        return runParallel(arguments.subspan(3), [&](const std::fs::path &path) {
+            return edit(path, *pattern, value);
+        });
+    } else if (command == "delete" && arguments.size() >= 3) {
+        const auto pattern = splitPattern(arguments[1]);
+        if (!pattern.has_value())
+            return printInvalidPattern(arguments[1]);
+
+        return runParallel(arguments.subspan(2), [&](const std::fs::path &path) {
+            return edit(path, *pattern, std::nullopt);
+        });
+    } else if (command == "validate" && arguments.size() >= 2) {
+        return runParallel(arguments.subspan(1), [](const std::fs::path &path) {
+            return validate(path);
+        });
+    } else if (command == "convert" && (arguments.size() == 3 || arguments.size() == 4)) {
+        const auto format = parseFormat(arguments[1]);
+        if (!format.has_value()) {
+            fmt::print(stderr, "steamkv: unknown format '{}'\n", arguments[1]);
+            return EXIT_FAILURE;
+        }
+
+        std::string error;
+        const auto data = convert(arguments[2], *format, error);
+        if (!data.has_value()) {
+            fmt::print(stderr, "steamkv: {}: {}\n", arguments[2], error);
+            return EXIT_FAILURE;
+        }
+
+        if (arguments.size() == 4) {
+            if (!fs::writeFileAtomic(arguments[3], std::string_view(*data))) {
+                fmt::print(stderr, "steamkv: {}: failed to write file\n", arguments[3]);
+                return EXIT_FAILURE;
+            }
+        } else {
+            std::fwrite(data->data(), 1, data->size(), stdout);
+        }
+
+        return EXIT_SUCCESS;
+    }
+
+    fmt::print(stderr, "{}", Usage);
+    return EXIT_FAILURE;
+}